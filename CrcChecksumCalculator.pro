@@ -1,52 +1,14 @@
-QT       += core gui
+# Builds the ChecksumCore library, then the application, the tests and the benchmark that link
+# it. "qmake && make" builds everything into bin/, "make check" also runs the tests.
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-#For Terminal Debugging
-#CONFIG += c++11 console
-#CONFIG -= app_bundle
+TEMPLATE = subdirs
 
-CONFIG(debug,debug|release)
-{
-    CONFIG += console
-}
+SUBDIRS += \
+    library \
+    app \
+    tests \
+    benchmark
 
-CONFIG(release,debug|release) {
-    CONFIG -= console
-}
-
-CONFIG += c++11
-
-# The following define makes your compiler emit warnings if you use
-# any Qt feature that has been marked deprecated (the exact warnings
-# depend on your compiler). Please consult the documentation of the
-# deprecated API in order to know how to port your code away from it.
-DEFINES += QT_DEPRECATED_WARNINGS
-
-# You can also make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-# You can also select to disable deprecated APIs only up to a certain version of Qt.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-UI_DIR = $$PWD/UI/
-DESTDIR = $$PWD/bin/
-
-SOURCES += \
-    src/main.cpp \
-    src/crcCalculate.cpp
-
-HEADERS += \
-    headers/crcCalculate.h
-
-FORMS += \
-    forms/crccalculate.ui
-
-RESOURCES += \
-    resources/Resources.qrc
-
-INCLUDEPATH += headers
-DEPENDPATH += headers
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
+app.depends = library
+tests.depends = library
+benchmark.depends = library
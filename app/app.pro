@@ -0,0 +1,84 @@
+# The application: GUI and headless batch mode on top of the ChecksumCore library. Built from
+# the root project, which builds the library first.
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+#For Terminal Debugging
+#CONFIG += c++11 console
+#CONFIG -= app_bundle
+
+CONFIG(debug,debug|release)
+{
+    CONFIG += console
+}
+
+CONFIG(release,debug|release) {
+    CONFIG -= console
+}
+
+CONFIG += c++14
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# You can also make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+# You can also select to disable deprecated APIs only up to a certain version of Qt.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+TARGET = CrcChecksumCalculator
+UI_DIR = $$PWD/../UI/
+DESTDIR = $$PWD/../bin/
+
+SOURCES += \
+    ../src/main.cpp \
+    ../src/checksumDatabase.cpp \
+    ../src/checksumManifest.cpp \
+    ../src/checksumTableModel.cpp \
+    ../src/commandLine.cpp \
+    ../src/crcCalculate.cpp \
+    ../src/directoryWalker.cpp \
+    ../src/fileIdentity.cpp \
+    ../src/folderWatcher.cpp \
+    ../src/hashScheduler.cpp \
+    ../src/duplicateFinder.cpp \
+    ../src/manifestVerifier.cpp \
+    ../src/openFolderDelegate.cpp \
+    ../src/progressDelegate.cpp
+
+HEADERS += \
+    ../headers/checksumDatabase.h \
+    ../headers/checksumManifest.h \
+    ../headers/checksumTableModel.h \
+    ../headers/commandLine.h \
+    ../headers/crcCalculate.h \
+    ../headers/directoryWalker.h \
+    ../headers/fileIdentity.h \
+    ../headers/folderWatcher.h \
+    ../headers/hashResult.h \
+    ../headers/hashScheduler.h \
+    ../headers/duplicateFinder.h \
+    ../headers/manifestVerifier.h \
+    ../headers/openFolderDelegate.h \
+    ../headers/progressDelegate.h
+
+FORMS += \
+    ../forms/crccalculate.ui
+
+RESOURCES += \
+    ../resources/Resources.qrc
+
+INCLUDEPATH += ../headers
+DEPENDPATH += ../headers
+
+# Checksum kernels and file hashing
+include(../library/linkChecksumCore.pri)
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
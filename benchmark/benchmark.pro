@@ -0,0 +1,18 @@
+# Throughput benchmark for the checksum kernels and file I/O paths.
+# Built by the root project against the ChecksumCore library, run bin/ChecksumBenchmark --help.
+
+QT       += core
+QT       -= gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+TARGET = ChecksumBenchmark
+DESTDIR = $$PWD/../bin/
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    checksumBenchmark.cpp
+
+include(../library/linkChecksumCore.pri)
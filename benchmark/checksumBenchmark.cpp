@@ -0,0 +1,451 @@
+#include "blake3Engine.h"
+#include "checksumEngine.h"
+#include "crc16Engine.h"
+#include "crc32Engine.h"
+#include "crc32cEngine.h"
+#include "crc64Engine.h"
+#include "readAheadReader.h"
+#include "systemTopology.h"
+#include "xxh3Engine.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryFile>
+#include <QTextStream>
+
+#include <functional>
+#include <limits>
+
+#if defined(Q_PROCESSOR_X86)
+#  if defined(Q_CC_MSVC)
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#  define BENCHMARK_HAVE_TSC
+#endif
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// A kernel consumes one buffer and folds its result into the returned value
+typedef std::function<quint64(const unsigned char *data, qint64 len)> kernelFunction;
+
+struct kernel
+{
+    QString name;
+    kernelFunction run;
+};
+
+// One row of the report
+struct measurement
+{
+    QString group;
+    QString name;
+    qint64 size;
+    int alignment;
+    QString cache;
+    qint64 iterations;
+    double seconds;
+    double megabytesPerSecond;
+    double cyclesPerByte;
+};
+
+// Defeats dead code elimination of the measured calls
+volatile quint64 sink = 0;
+
+quint64 readTimestamp()
+{
+#ifdef BENCHMARK_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+QString formatSize(qint64 size)
+{
+    if (size >= (1 << 30) && size % (1 << 30) == 0) return QString("%1G").arg(size >> 30);
+    if (size >= (1 << 20) && size % (1 << 20) == 0) return QString("%1M").arg(size >> 20);
+    if (size >= (1 << 10) && size % (1 << 10) == 0) return QString("%1K").arg(size >> 10);
+    return QString::number(size);
+}
+
+// Parses sizes like 64, 4K, 16M or 1G
+qint64 parseSize(const QString &text)
+{
+    QString value = text.trimmed().toUpper();
+    qint64 factor = 1;
+    if (value.endsWith('K')) factor = qint64(1) << 10;
+    else if (value.endsWith('M')) factor = qint64(1) << 20;
+    else if (value.endsWith('G')) factor = qint64(1) << 30;
+    if (factor != 1) value.chop(1);
+
+    bool ok = false;
+    qint64 number = value.toLongLong(&ok);
+    return ok ? number * factor : -1;
+}
+
+QList<kernel> kernels()
+{
+    QList<kernel> list;
+
+    list << kernel{ "crc16/bytewise", [](const unsigned char *d, qint64 n) { return quint64(crc16Engine::updateBytewise(0, d, n)); } };
+    list << kernel{ "crc16/slicing-by-8", [](const unsigned char *d, qint64 n) { return quint64(crc16Engine::updateSlicing8(0, d, n)); } };
+    list << kernel{ "crc16/computeCrc", [](const unsigned char *d, qint64 n) { return quint64(checksumEngine::computeCrc(0, d, n)); } };
+
+    static const crc32Engine::Kernel crc32Kernels[] = {
+        crc32Engine::Bytewise, crc32Engine::Slicing8, crc32Engine::Slicing16, crc32Engine::Pclmul
+    };
+    for (crc32Engine::Kernel k : crc32Kernels) {
+        if (!crc32Engine::isKernelSupported(k)) continue;
+        list << kernel{ QString("crc32/%1").arg(crc32Engine::kernelName(k)),
+                        [k](const unsigned char *d, qint64 n) { return quint64(crc32Engine::updateWith(k, 0, d, n)); } };
+    }
+    list << kernel{ "crc32/computeCrc32", [](const unsigned char *d, qint64 n) { return quint64(checksumEngine::computeCrc32(0, d, n)); } };
+
+    static const crc32cEngine::Kernel crc32cKernels[] = {
+        crc32cEngine::Bytewise, crc32cEngine::Slicing8, crc32cEngine::Sse42
+    };
+    for (crc32cEngine::Kernel k : crc32cKernels) {
+        if (!crc32cEngine::isKernelSupported(k)) continue;
+        list << kernel{ QString("crc32c/%1").arg(crc32cEngine::kernelName(k)),
+                        [k](const unsigned char *d, qint64 n) { return quint64(crc32cEngine::updateWith(k, 0, d, n)); } };
+    }
+
+    list << kernel{ "crc64/bytewise", [](const unsigned char *d, qint64 n) { return crc64Engine::updateBytewise(0, d, n); } };
+    list << kernel{ "crc64/slicing-by-8", [](const unsigned char *d, qint64 n) { return crc64Engine::updateSlicing8(0, d, n); } };
+
+    list << kernel{ "xxh3/64", [](const unsigned char *d, qint64 n) { return xxh3Engine::hash64(d, n); } };
+    list << kernel{ "xxh3/128", [](const unsigned char *d, qint64 n) { return xxh3Engine::hash128(d, n).low; } };
+    list << kernel{ "blake3/256", [](const unsigned char *d, qint64 n) {
+        unsigned char digest[blake3Engine::OutLength];
+        blake3Engine::hash(d, n, digest);
+        return quint64(digest[0]);
+    } };
+
+    static const QPair<const char *, QCryptographicHash::Algorithm> hashes[] = {
+        qMakePair("md5", QCryptographicHash::Md5),
+        qMakePair("sha1", QCryptographicHash::Sha1),
+        qMakePair("sha256", QCryptographicHash::Sha256)
+    };
+    for (const auto &hash : hashes) {
+        QCryptographicHash::Algorithm algorithm = hash.second;
+        list << kernel{ QString("qcryptographichash/%1").arg(hash.first), [algorithm](const unsigned char *d, qint64 n) {
+            QCryptographicHash context(algorithm);
+            const char *p = reinterpret_cast<const char *>(d);
+            // addData takes an int length
+            while (n > 0) {
+                int chunk = static_cast<int>(qMin<qint64>(n, 1 << 30));
+                context.addData(p, chunk);
+                p += chunk;
+                n -= chunk;
+            }
+            return quint64(static_cast<unsigned char>(context.result().at(0)));
+        } };
+    }
+    return list;
+}
+
+/***************************************************************************************************
+* @description : This function repeats a call until minSeconds have passed, doubling the batch so
+*                the timer is read rarely for tiny buffers.
+* @param : const std::function<quint64()> &call, qint64 bytesPerCall, double minSeconds
+* @return : measurement with iterations, seconds, MB/s and cycles/byte filled in
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+measurement measure(const std::function<quint64()> &call, qint64 bytesPerCall, double minSeconds)
+{
+    // Warm up caches, page tables and the CPU frequency
+    sink = sink + call();
+
+    qint64 batch = 1;
+    qint64 iterations = 0;
+    qint64 nanoseconds = 0;
+    quint64 cycles = 0;
+
+    QElapsedTimer timer;
+    while (nanoseconds < qint64(minSeconds * 1e9)) {
+        quint64 startCycles = readTimestamp();
+        timer.start();
+        for (qint64 i = 0; i < batch; ++i) {
+            sink = sink + call();
+        }
+        nanoseconds += timer.nsecsElapsed();
+        cycles += readTimestamp() - startCycles;
+        iterations += batch;
+        batch *= 2;
+    }
+
+    measurement m;
+    m.size = bytesPerCall;
+    m.iterations = iterations;
+    m.seconds = nanoseconds / 1e9;
+    double bytes = double(bytesPerCall) * iterations;
+    m.megabytesPerSecond = m.seconds > 0 ? bytes / m.seconds / (1024.0 * 1024.0) : 0;
+#ifdef BENCHMARK_HAVE_TSC
+    m.cyclesPerByte = bytes > 0 ? cycles / bytes : 0;
+#else
+    m.cyclesPerByte = -1;
+#endif
+    return m;
+}
+
+/***************************************************************************************************
+* @description : This function evicts a file from the page cache so the next read hits the disk.
+*                Only Linux offers this to unprivileged processes.
+* @param : const QString &filePath
+* @return : bool - false if the platform cannot drop the cache
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool dropPageCache(const QString &filePath)
+{
+#ifdef Q_OS_LINUX
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    fdatasync(file.handle());
+    return posix_fadvise(file.handle(), 0, 0, POSIX_FADV_DONTNEED) == 0;
+#else
+    Q_UNUSED(filePath);
+    return false;
+#endif
+}
+
+QJsonObject toJson(const measurement &m)
+{
+    QJsonObject object;
+    object["group"] = m.group;
+    object["name"] = m.name;
+    object["size"] = m.size;
+    object["alignment"] = m.alignment;
+    if (!m.cache.isEmpty()) object["cache"] = m.cache;
+    object["iterations"] = m.iterations;
+    object["seconds"] = m.seconds;
+    object["mb_per_s"] = m.megabytesPerSecond;
+    if (m.cyclesPerByte >= 0) object["cycles_per_byte"] = m.cyclesPerByte;
+    return object;
+}
+
+QString toCsv(const measurement &m)
+{
+    return QString("%1,%2,%3,%4,%5,%6,%7,%8,%9")
+        .arg(m.group, m.name)
+        .arg(m.size)
+        .arg(m.alignment)
+        .arg(m.cache)
+        .arg(m.iterations)
+        .arg(m.seconds, 0, 'f', 6)
+        .arg(m.megabytesPerSecond, 0, 'f', 2)
+        .arg(m.cyclesPerByte >= 0 ? QString::number(m.cyclesPerByte, 'f', 3) : QString());
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ChecksumBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures MB/s and cycles/byte of every checksum kernel and of "
+                                     "CalculateChecksum with cold and warm page cache.");
+    parser.addHelpOption();
+
+    QCommandLineOption minSizeOption("min-size", "Smallest buffer size (default 64).", "size", "64");
+    QCommandLineOption maxSizeOption("max-size", "Largest buffer size (default 1G).", "size", "1G");
+    QCommandLineOption alignOption("alignments", "Comma separated buffer offsets from a 64 byte boundary (default 0,1,8).",
+                                   "list", "0,1,8");
+    QCommandLineOption timeOption("min-time", "Seconds each measurement runs at least (default 0.2).", "seconds", "0.2");
+    QCommandLineOption filterOption("filter", "Only run kernels whose name contains this text.", "text");
+    QCommandLineOption fileOption("file", "Hash this file end to end instead of a generated one.", "path");
+    QCommandLineOption fileSizeOption("file-size", "Size of the generated end to end test file (default 256M, 0 skips).",
+                                      "size", "256M");
+    QCommandLineOption formatOption("format", "Output format: json (default) or csv.", "format", "json");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Write the report to a file instead of stdout.", "path");
+
+    parser.addOption(minSizeOption);
+    parser.addOption(maxSizeOption);
+    parser.addOption(alignOption);
+    parser.addOption(timeOption);
+    parser.addOption(filterOption);
+    parser.addOption(fileOption);
+    parser.addOption(fileSizeOption);
+    parser.addOption(formatOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    const qint64 minSize = parseSize(parser.value(minSizeOption));
+    const qint64 maxSize = parseSize(parser.value(maxSizeOption));
+    const double minSeconds = parser.value(timeOption).toDouble();
+    const bool csv = parser.value(formatOption) == "csv";
+    if (minSize < 1 || maxSize < minSize || minSeconds <= 0) {
+        QTextStream(stderr) << "invalid size or time arguments\n";
+        return 2;
+    }
+
+    QList<int> alignments;
+    for (const QString &value : parser.value(alignOption).split(',')) {
+        if (!value.trimmed().isEmpty()) alignments << value.toInt();
+    }
+    if (alignments.isEmpty()) alignments << 0;
+
+    QTextStream err(stderr);
+    QList<measurement> results;
+
+    // Kernels over in-memory buffers
+    const int maxAlignment = 64;
+    QByteArray storage(static_cast<int>(qMin<qint64>(maxSize + 2 * maxAlignment, std::numeric_limits<int>::max())),
+                       Qt::Uninitialized);
+    quint32 seed = 0x9E3779B9;
+    for (int i = 0; i < storage.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        storage[i] = static_cast<char>(seed >> 24);
+    }
+    quintptr base = (reinterpret_cast<quintptr>(storage.constData()) + maxAlignment - 1) & ~quintptr(maxAlignment - 1);
+
+    for (const kernel &k : kernels()) {
+        if (parser.isSet(filterOption) && !k.name.contains(parser.value(filterOption))) continue;
+
+        for (qint64 size = minSize; size <= maxSize; size *= 4) {
+            if (size + 2 * maxAlignment > storage.size()) break;
+
+            for (int alignment : qAsConst(alignments)) {
+                const unsigned char *data = reinterpret_cast<const unsigned char *>(base) + alignment % maxAlignment;
+                measurement m = measure([&k, data, size]() { return k.run(data, size); }, size, minSeconds);
+                m.group = "kernel";
+                m.name = k.name;
+                m.alignment = alignment % maxAlignment;
+                results << m;
+                err << k.name << " " << formatSize(size) << " +" << m.alignment << ": "
+                    << QString::number(m.megabytesPerSecond, 'f', 1) << " MB/s\n";
+                err.flush();
+            }
+        }
+    }
+
+    // End to end file hashing
+    QTemporaryFile generated;
+    QString filePath = parser.value(fileOption);
+    const qint64 fileSize = parseSize(parser.value(fileSizeOption));
+    if (filePath.isEmpty() && fileSize > 0 && generated.open()) {
+        QByteArray block = storage.left(static_cast<int>(qMin<qint64>(storage.size(), 1 << 20)));
+        for (qint64 written = 0; written < fileSize; written += block.size()) {
+            generated.write(block.constData(), qMin<qint64>(block.size(), fileSize - written));
+        }
+        generated.flush();
+        filePath = generated.fileName();
+    }
+
+    if (!filePath.isEmpty()) {
+        const qint64 size = QFileInfo(filePath).size();
+        static const QPair<const char *, checksumEngine::IoBackend> backends[] = {
+            qMakePair("mmap", checksumEngine::MappedIo),
+            qMakePair("read", checksumEngine::BufferedIo)
+        };
+
+        for (checksumEngine::ChecksumType type : checksumEngine::allChecksumTypes()) {
+            QString typeName = checksumEngine::typeName(type);
+            if (parser.isSet(filterOption) && !typeName.contains(parser.value(filterOption))) continue;
+
+            for (const auto &backend : backends) {
+                for (const char *cache : { "cold", "warm" }) {
+                    bool cold = qstrcmp(cache, "cold") == 0;
+                    if (cold && !dropPageCache(filePath)) continue;
+                    if (!cold) checksumEngine::CalculateChecksum(filePath, type, backend.second);
+
+                    // A cold run is only cold once, so it is measured as a single call
+                    QElapsedTimer timer;
+                    quint64 startCycles = readTimestamp();
+                    timer.start();
+                    QString checksum = checksumEngine::CalculateChecksum(filePath, type, backend.second);
+                    qint64 nanoseconds = timer.nsecsElapsed();
+                    quint64 cycles = readTimestamp() - startCycles;
+                    sink = sink + static_cast<quint64>(checksum.size());
+
+                    measurement m;
+                    m.group = "file";
+                    m.name = QString("%1/%2").arg(typeName, backend.first);
+                    m.size = size;
+                    m.alignment = 0;
+                    m.cache = cache;
+                    m.iterations = 1;
+                    m.seconds = nanoseconds / 1e9;
+                    m.megabytesPerSecond = m.seconds > 0 ? size / m.seconds / (1024.0 * 1024.0) : 0;
+#ifdef BENCHMARK_HAVE_TSC
+                    m.cyclesPerByte = size > 0 ? double(cycles) / size : 0;
+#else
+                    Q_UNUSED(cycles);
+                    m.cyclesPerByte = -1;
+#endif
+                    results << m;
+                    err << m.name << " " << cache << ": " << QString::number(m.megabytesPerSecond, 'f', 1) << " MB/s\n";
+                    err.flush();
+                }
+            }
+        }
+    }
+
+    // Report
+    QByteArray report;
+    if (csv) {
+        QStringList lines;
+        lines << "group,name,size,alignment,cache,iterations,seconds,mb_per_s,cycles_per_byte";
+        for (const measurement &m : qAsConst(results)) {
+            lines << toCsv(m);
+        }
+        report = lines.join('\n').toUtf8() + '\n';
+    } else {
+        QJsonObject meta;
+        meta["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        meta["cpu"] = QSysInfo::currentCpuArchitecture();
+        meta["os"] = QSysInfo::prettyProductName();
+        meta["qt"] = QString(qVersion());
+        meta["crc32_kernel"] = QString(crc32Engine::kernelName(crc32Engine::activeKernel()));
+        meta["crc32c_kernel"] = QString(crc32cEngine::kernelName(crc32cEngine::activeKernel()));
+        meta["xxh3_sse2"] = xxh3Engine::usesSse2();
+        meta["read_ahead"] = QString(readAheadReader::methodName(readAheadReader::preferredMethod()));
+        meta["numa_nodes"] = systemTopology::nodeCount();
+        meta["l2_cache_bytes"] = double(systemTopology::l2CacheSize());
+        meta["multi_digest_slice_bytes"] = double(checksumEngine::multiDigestSliceSize());
+#ifdef BENCHMARK_HAVE_TSC
+        meta["cycles_source"] = QString("rdtsc");
+#endif
+
+        QJsonArray rows;
+        for (const measurement &m : qAsConst(results)) {
+            rows.append(toJson(m));
+        }
+
+        QJsonObject root;
+        root["meta"] = meta;
+        root["results"] = rows;
+        report = QJsonDocument(root).toJson();
+    }
+
+    if (parser.isSet(outputOption)) {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "cannot write " << parser.value(outputOption) << "\n";
+            return 1;
+        }
+        output.write(report);
+    } else {
+        QFile output;
+        output.open(stdout, QIODevice::WriteOnly);
+        output.write(report);
+    }
+    return 0;
+}
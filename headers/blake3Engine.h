@@ -0,0 +1,67 @@
+#ifndef BLAKE3ENGINE_H
+#define BLAKE3ENGINE_H
+
+#include <QtGlobal>
+
+// BLAKE3 hash (default mode, 256 bit output), bit compatible with b3sum.
+// The input is split into 1 KiB chunks that form a binary tree, so aligned ranges of one input
+// can be hashed on separate threads and joined with hashState::append().
+namespace blake3Engine {
+
+// Bytes per leaf of the tree
+const int ChunkLength = 1024;
+// Bytes of the digest
+const int OutLength = 32;
+
+// Running state of one input, or of one range of it
+class hashState
+{
+public:
+    hashState();
+    // Starts over. A state for a range of a larger input starts at the range's offset, which
+    // must be a multiple of ChunkLength times a power of two that covers the whole range.
+    void reset(quint64 offset = 0);
+    // Feeds the next block of the input
+    void update(const unsigned char *data, qint64 len);
+    // Continues with the state of the range that directly follows this one. This state must
+    // end on a chunk boundary and next must have been reset to that offset.
+    void append(const hashState &next);
+    // Writes the OutLength byte digest of a state that started at offset 0
+    void finalize(unsigned char *out) const;
+
+private:
+    // Chaining values of 2^54 chunks cover any 64 bit length
+    static const int MaxDepth = 54;
+
+    // Compresses the current chunk's last block into its chaining value
+    void chunkChainingValue(quint32 *out) const;
+    // Feeds bytes that fit into the current chunk
+    void chunkUpdate(const unsigned char *data, qint64 len);
+    // Pushes the chaining value of a subtree of 2^level chunks and merges completed subtrees,
+    // totalChunks counts the chunks of this state including the new subtree
+    void pushChainingValue(const quint32 *cv, int level, quint64 totalChunks);
+
+    // Current chunk
+    quint32 cv[8];
+    unsigned char block[64];
+    int blockLength;
+    int blocksCompressed;
+    quint64 chunkCounter;
+
+    // First chunk of this state, 0 unless it hashes a range
+    quint64 startChunk;
+    // Chaining values of completed subtrees, largest first
+    quint32 stack[MaxDepth][8];
+    int stackSize;
+};
+
+// One shot helper
+void hash(const unsigned char *data, qint64 len, unsigned char *out);
+
+// Checks the digest against reference values, streamed in several block sizes and split into
+// ranges joined with append()
+bool selfTest();
+
+} // namespace blake3Engine
+
+#endif // BLAKE3ENGINE_H
@@ -0,0 +1,93 @@
+#ifndef CHECKSUMDATABASE_H
+#define CHECKSUMDATABASE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "checksumEngine.h"
+#include "fileIdentity.h"
+
+// Persistent checksum cache shared by every run of the application.
+//
+// Entries map (path, size, mtime, inode) to digests and live in an append-only journal in the
+// user's app-data directory. Every record carries its own CRC-32, so torn or corrupted lines are
+// skipped on load instead of poisoning the cache. Appends are serialised across processes with a
+// lock file, and the journal is compacted once superseded records dominate it. Journal I/O runs
+// outside the lock of the in-memory entries, so lookups never wait for another process.
+class checksumDatabase
+{
+public:
+    // Process wide instance backed by the default journal
+    static checksumDatabase &instance();
+
+    // Opens or creates the journal at the given path
+    explicit checksumDatabase(const QString &journalPath);
+    // Destructor, flushes pending records
+    ~checksumDatabase();
+
+    // Returns cached checksums for every requested type, false if any is missing or stale
+    bool lookup(const fileIdentity &identity, const QVector<checksumEngine::ChecksumType> &types,
+                QHash<int, QString> *checksums);
+    // Records checksums for a file, merging them with what is already known about it
+    void store(const fileIdentity &identity, const QHash<int, QString> &checksums);
+
+    // Hashes a file unless all requested checksums are cached for its current state
+    QHash<int, QString> checksums(const QString &filePath, const QVector<checksumEngine::ChecksumType> &types,
+                                  checksumEngine::IoBackend backend = checksumEngine::BufferedIo,
+                                  bool forceRehash = false);
+    // Same for a file the caller has already read the identity of, size -1 if it does not exist
+    QHash<int, QString> checksums(const fileIdentity &identity, const QVector<checksumEngine::ChecksumType> &types,
+                                  checksumEngine::IoBackend backend = checksumEngine::BufferedIo,
+                                  bool forceRehash = false);
+
+    // Picks up records appended by other processes since the journal was loaded
+    void refresh();
+    // Writes pending records to the journal
+    void flush();
+
+    // Path of the journal file
+    QString journalPath() const;
+
+private:
+    struct entry
+    {
+        fileIdentity identity;
+        QHash<int, QString> checksums;
+    };
+
+    // Reads new journal records and merges them into the entries
+    void load();
+    // Reads the journal from loadedOffset, returns true if it was replaced and read from the
+    // start. Called with journalMutex held.
+    bool readJournal(QVector<entry> *records, int *corrupt);
+    // Merges records read from the journal, keeping this process's unwritten ones. Called with
+    // the mutex held.
+    void merge(const QVector<entry> &records, int corrupt, bool replaced, const QVector<entry> &writing);
+    // Parses one record line, returns false if it is corrupt
+    bool parseRecord(const QByteArray &line, entry *record) const;
+    // Formats one record line including its CRC-32 and the trailing newline
+    QByteArray formatRecord(const entry &record) const;
+    // Rewrites the journal with one record per live entry, called with the lock file held
+    void compact(const QHash<QString, entry> &live);
+    // Appends records under the lock file, called without the mutex
+    void appendRecords(const QVector<entry> &records);
+
+    QString path;
+    // Guards entries, deadRecords and pending
+    QMutex mutex;
+    QHash<QString, entry> entries;
+    // Records in the journal that are superseded or corrupt
+    int deadRecords;
+    // Records not yet written
+    QVector<entry> pending;
+    // Serialises this process's journal reads and writes, taken before the mutex. Guards header
+    // and loadedOffset.
+    QMutex journalMutex;
+    QByteArray header;
+    qint64 loadedOffset;
+};
+
+#endif // CHECKSUMDATABASE_H
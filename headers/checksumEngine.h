@@ -0,0 +1,138 @@
+#ifndef CHECKSUMENGINE_H
+#define CHECKSUMENGINE_H
+
+#include <QString>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QCryptographicHash>
+
+#include "xxh3Engine.h"
+#include "blake3Engine.h"
+
+// File hashing shared by the GUI and the command line, depends on QtCore only.
+// All functions are static and safe to call from worker threads.
+class checksumEngine
+{
+public:
+    enum ChecksumType {
+        CRC16,
+        CRC32,
+        MD5,
+        SHA1,
+        SHA256,
+        CRC32C,         // Castagnoli, as used by iSCSI, ext4 and Btrfs
+        CRC64,          // CRC-64/XZ
+        XXH3_64,
+        XXH3_128,
+        BLAKE3
+    };
+
+    // How file contents reach the checksum kernels
+    enum IoBackend {
+        BufferedIo,     // reads kept in flight ahead of the hashing, see readAheadReader
+        MappedIo        // memory mapped view, falls back to BufferedIo when mapping is not possible.
+                        // Opt in only: a file truncated while mapped fails with "ERROR" on Unix.
+    };
+
+    // Calculates checksum for a file
+    static QString CalculateChecksum(const QString &filePath, ChecksumType type, IoBackend backend = BufferedIo);
+    // Calculates several checksums while reading the file only once, keyed by ChecksumType
+    static QHash<int, QString> CalculateChecksums(const QString &filePath, const QVector<ChecksumType> &types,
+                                                  IoBackend backend = BufferedIo);
+    // XXH3-64 of the first and last sampleSize bytes of a file (at most SmallFileSize / 2 each),
+    // "ERROR" if it cannot be read. Tells files of one size apart without reading them fully.
+    static QString CalculateSampleChecksum(const QString &filePath, qint64 sampleSize);
+    // Every supported checksum type
+    static QVector<ChecksumType> allChecksumTypes();
+    // Lower case name of a checksum type, e.g. "sha256"
+    static QString typeName(ChecksumType type);
+    // Parses a checksum type name, returns false if it is unknown
+    static bool typeFromName(const QString &name, ChecksumType *type);
+    // Number of hex digits of a checksum type's result
+    static int digestLength(ChecksumType type);
+
+    // Computes CRC value, continuing from a previous running crc
+    static unsigned short computeCrc(unsigned short crc, const unsigned char *message, qint64 blk_len);
+    // Computes CRC32, continuing from a previous running crc
+    static unsigned int computeCrc32(unsigned int crc, const unsigned char *data, qint64 len);
+
+    // Size of the blocks a file is hashed in, see readAheadReader::BlockSize for reads
+    static const int ChunkSize = 1024 * 1024;
+    // Size of one mapped window, keeps the address space use bounded on 32 bit builds
+    static const qint64 MapWindowSize = 64 * 1024 * 1024;
+    // Files smaller than this are read, mapping them costs more than the copy
+    static const qint64 MapMinimumSize = 256 * 1024;
+    // CRC only requests for files at least this large are split into ranges hashed in parallel
+    static const qint64 ParallelMinimumSize = 64 * 1024 * 1024;
+    // Smallest range handed to one thread, keeps the combine and thread handoff cost negligible
+    static const qint64 ParallelRangeSize = 32 * 1024 * 1024;
+    // Files up to this size are read with one call into a per thread buffer and hashed with
+    // per thread contexts, so hashing many small files allocates nothing
+    static const qint64 SmallFileSize = 64 * 1024;
+
+    // Slice fed to each algorithm in turn when several run at once: half the L2 cache, so the
+    // data is still there for the next algorithm, between 64 KiB and 1 MiB
+    static qint64 multiDigestSliceSize();
+
+private:
+    // Streams caller supplied buffers through checksumState
+    friend class checksumHasher;
+
+    // Running state of one or more checksums while a file is streamed through them
+    class checksumState
+    {
+    public:
+        explicit checksumState(const QVector<ChecksumType> &types);
+        // Starts over with another set of checksum types, keeps the allocated contexts
+        void reset(const QVector<ChecksumType> &types);
+        // Feeds one block of file data to every requested checksum
+        void addData(const unsigned char *data, qint64 len);
+        // Returns the finished checksums as upper case hex, keyed by ChecksumType
+        QHash<int, QString> results() const;
+        // Declares that the data fed next starts at offset into the file, see hashParallel()
+        void startAt(qint64 offset);
+        // Appends the state of the len bytes that directly follow this one, CRC and BLAKE3 only
+        void combine(const checksumState &next, qint64 len);
+
+    private:
+        // Feeds one block to a single checksum
+        void addData(ChecksumType type, const unsigned char *data, qint64 len);
+
+        QVector<ChecksumType> types;
+        unsigned short crc16;
+        unsigned int crc32;
+        quint32 crc32c;
+        quint64 crc64;
+        QCryptographicHash md5;
+        QCryptographicHash sha1;
+        QCryptographicHash sha256;
+        // Shared by XXH3_64 and XXH3_128, fed once when both are requested
+        xxh3Engine::hashState xxh3;
+        blake3Engine::hashState blake3;
+    };
+
+    // Read buffer of SmallFileSize bytes owned by the calling thread
+    static QByteArray &threadBuffer();
+    // Hashes a file of at most SmallFileSize bytes with per thread buffer and contexts
+    static QHash<int, QString> hashSmallFile(QFile &file, const QVector<ChecksumType> &types, bool *ok);
+    // Checks whether a file is a plain file on a local disk
+    static bool isLocalFile(QFile &file);
+    // Checks whether a file may be hashed through a memory mapping
+    static bool canMapFile(QFile &file);
+    // Checks whether every type can be split into ranges and combined
+    static bool canHashInParallel(const QVector<ChecksumType> &types);
+    // Hashes the bytes [offset, end) through memory mapped windows, returns the offset reached
+    // or -1 if the file shrank under a mapping
+    static qint64 hashMapped(QFile &file, qint64 offset, qint64 end, checksumState &state);
+    // Hashes the bytes [offset, end) with buffered reads, up to the end of the file if end is negative
+    static bool hashBuffered(QFile &file, qint64 offset, qint64 end, checksumState &state);
+    // Hashes length bytes from offset through its own file handle
+    static bool hashRange(const QString &filePath, qint64 offset, qint64 length, IoBackend backend,
+                          checksumState &state);
+    // Splits a file into ranges hashed on several threads and combines them into state
+    static bool hashParallel(const QString &filePath, qint64 size, const QVector<ChecksumType> &types,
+                             IoBackend backend, checksumState &state);
+};
+
+#endif // CHECKSUMENGINE_H
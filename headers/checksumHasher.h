@@ -0,0 +1,72 @@
+#ifndef CHECKSUMHASHER_H
+#define CHECKSUMHASHER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "checksumEngine.h"
+
+// Read only view of caller owned bytes, handed to the kernels without a copy
+class byteSpan
+{
+public:
+    byteSpan() : bytes(nullptr), length(0) {}
+    byteSpan(const void *data, qint64 size) : bytes(static_cast<const unsigned char *>(data)), length(size) {}
+    byteSpan(const QByteArray &array)
+        : bytes(reinterpret_cast<const unsigned char *>(array.constData())), length(array.size()) {}
+
+    const unsigned char *data() const { return bytes; }
+    qint64 size() const { return length; }
+    bool isEmpty() const { return length == 0; }
+    // Bytes [offset, offset + size), up to the end if size is negative
+    byteSpan mid(qint64 offset, qint64 size = -1) const
+    {
+        offset = qBound(qint64(0), offset, length);
+        if (size < 0 || size > length - offset) size = length - offset;
+        return byteSpan(bytes + offset, size);
+    }
+
+private:
+    const unsigned char *bytes;
+    qint64 length;
+};
+
+// Incremental hasher for one checksum type, the entry point of the ChecksumCore library for
+// callers that have their data in memory. Splitting a message into update() calls of any size
+// and alignment gives the same digest as hashing it at once. Depends on QtCore only.
+//
+//     checksumHasher hasher(checksumEngine::CRC32C);
+//     hasher.update(header);
+//     hasher.update(byteSpan(payload, payloadSize));
+//     QString checksum = hasher.finalHex();
+class checksumHasher
+{
+public:
+    // Creates a hasher ready for the first update()
+    explicit checksumHasher(checksumEngine::ChecksumType type);
+
+    // Checksum type computed
+    checksumEngine::ChecksumType type() const;
+    // Starts a new message, discarding everything fed so far
+    void init();
+    // Feeds the next bytes of the message
+    void update(byteSpan data);
+    // Digest of the bytes fed since init(), big endian like its hex form. The state is kept,
+    // further update() calls extend the same message.
+    QByteArray final() const;
+    // Digest as upper case hex, the form shown and stored everywhere else
+    QString finalHex() const;
+
+    // Digest of one buffer
+    static QByteArray hash(checksumEngine::ChecksumType type, byteSpan data);
+    // Number of bytes final() returns
+    static int digestSize(checksumEngine::ChecksumType type);
+
+private:
+    Q_DISABLE_COPY(checksumHasher)
+
+    checksumEngine::ChecksumType hashType;
+    checksumEngine::checksumState state;
+};
+
+#endif // CHECKSUMHASHER_H
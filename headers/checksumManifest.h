@@ -0,0 +1,58 @@
+#ifndef CHECKSUMMANIFEST_H
+#define CHECKSUMMANIFEST_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "checksumEngine.h"
+
+// Reads and writes checksum list files:
+//   sha256sum / md5sum style   "<hex>  <path>" or "<hex> *<path>", '\' prefixed escaped names
+//   BSD tagged style           "SHA256 (<path>) = <hex>"
+//   SFV                        "<path> <crc32>", ';' starts a comment
+// Relative paths are resolved against the folder of the list file.
+class checksumManifest
+{
+public:
+    enum Format {
+        SumFormat,      // sha256sum, md5sum and friends
+        SfvFormat       // Simple File Verification, CRC-32 only
+    };
+
+    // One line of a list file
+    struct entry
+    {
+        // Path as written in the list
+        QString name;
+        // Absolute path of the file
+        QString filePath;
+        // Upper case hex digest the file should have
+        QString expected;
+        checksumEngine::ChecksumType type;
+    };
+
+    // Parses a list file, lines that are not checksum lines are counted in skippedLines
+    static bool load(const QString &manifestPath, QVector<entry> *entries, QString *error,
+                     int *skippedLines = nullptr);
+    // Writes checksums of files, paths relative to the list file's folder where possible
+    static bool save(const QString &manifestPath, Format format, const QVector<entry> &entries, QString *error);
+
+    // Format and checksum type implied by a file name, e.g. "release.sha256"; false if unknown
+    static bool typeFromFileName(const QString &manifestPath, checksumEngine::ChecksumType *type, Format *format);
+    // Checksum type with the given number of hex digits, false if none; shared lengths give the older type
+    static bool typeFromDigestLength(int length, checksumEngine::ChecksumType *type);
+
+private:
+    // Parses one line, returns false if it is no checksum line
+    static bool parseLine(const QString &line, Format format, checksumEngine::ChecksumType defaultType,
+                          bool typeKnown, entry *parsed);
+    // Whether text is a hex digest of a known length
+    static bool isDigest(const QString &text);
+    // Reverses the sha256sum escaping of '\\' and '\n' in file names
+    static QString unescapeName(const QString &name);
+    // Applies the sha256sum escaping, sets escaped if anything was escaped
+    static QString escapeName(const QString &name, bool *escaped);
+};
+
+#endif // CHECKSUMMANIFEST_H
@@ -0,0 +1,91 @@
+#ifndef CHECKSUMTABLEMODEL_H
+#define CHECKSUMTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+
+#include "manifestVerifier.h"
+
+// File list shown in the main table. Rows live in one contiguous array and are found by
+// path through a hash index, so adding and updating files costs the same at any list size.
+class checksumTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        ChecksumColumn,
+        StatusColumn,
+        PathColumn,
+        OpenFolderColumn,
+        ColumnCount
+    };
+
+    // Full path of the row's file, for any column
+    static const int FilePathRole = Qt::UserRole;
+    // manifestVerifier::Status of the row, for any column
+    static const int StatusRole = Qt::UserRole + 1;
+    // Hashing progress of the row's file in per mille, -1 while it is not being read
+    static const int ProgressRole = Qt::UserRole + 2;
+    // Read rate of the row's file in MB/s while it is being read
+    static const int ThroughputRole = Qt::UserRole + 3;
+
+    // Constructor
+    explicit checksumTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Appends files that are not listed yet in one insertion, returns the paths that were new
+    QStringList addFiles(const QStringList &filePaths, const QString &checksum);
+    // Row of a file, -1 if it is not listed
+    int rowOf(const QString &filePath) const;
+    // Full path of the file in a row
+    QString filePath(int row) const;
+    // Folder containing the file in a row
+    QString folderPath(int row) const;
+    // Checksum text shown in a row
+    QString checksum(int row) const;
+    // Replaces the checksum text of a row
+    void setChecksum(int row, const QString &checksum);
+    // Replaces the checksum text of many rows with a single change notification
+    void setChecksums(const QVector<QPair<int, QString>> &checksums);
+    // Shows a progress bar instead of the checksum until the checksum is set, -1 removes it
+    void setProgress(int row, int permille, double mbPerSecond);
+    // Verification status of a row
+    manifestVerifier::Status status(int row) const;
+    // Sets the verification status of a row, expected is shown when the checksum differs
+    void setStatus(int row, manifestVerifier::Status status, const QString &expected = QString());
+    // Sets the status of every row back to Pending
+    void clearStatus();
+    // Removes every row
+    void clear();
+
+private:
+    // One row, the name and folder columns are views into the stored path
+    struct fileRecord
+    {
+        QString filePath;
+        int nameStart;
+        QString checksum;
+        manifestVerifier::Status status;
+        // Checksum the last verified list expected, kept for failed rows only
+        QString expected;
+        // Per mille, -1 when no bar is shown
+        qint16 progress;
+        float mbPerSecond;
+    };
+
+    // Rows in display order
+    QVector<fileRecord> records;
+    // Row of every listed path
+    QHash<QString, int> rowIndex;
+};
+
+#endif // CHECKSUMTABLEMODEL_H
@@ -0,0 +1,47 @@
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <QStringList>
+
+#include "checksumEngine.h"
+
+class directoryWalker;
+
+// Headless batch mode, e.g. "CrcChecksumCalculator --algo crc32 --jobs 8 <paths...>".
+// Runs on QCoreApplication and prints sha256sum style lines, "--check <lists...>" verifies them
+// and "--duplicates <paths...>" lists files with identical contents.
+class commandLine
+{
+public:
+    // How the persistent checksum database is used
+    enum CacheMode {
+        UseCache,       // reuse checksums of unchanged files
+        ForceRehash,    // read every file, still update the database
+        NoCache         // neither read nor write the database
+    };
+
+    // True when the process was started with an option of the headless mode or --cli
+    static bool isRequested(int argc, char *argv[]);
+    // Paths among the arguments of a GUI start, e.g. from "Open with", made absolute
+    static QStringList pathArguments(const QStringList &arguments);
+    // Parses the arguments, hashes every given file and directory tree, returns the exit code
+    static int run(const QStringList &arguments);
+
+private:
+    // Hashes the files found by walking paths on jobs threads while the walk is still running,
+    // prints the results in the order the files were found
+    static bool hashFiles(directoryWalker &walker, const QStringList &paths, bool sorted,
+                          checksumEngine::ChecksumType type, checksumEngine::IoBackend backend,
+                          CacheMode cacheMode, int jobs);
+    // Checks the files listed in sha256sum, md5sum or SFV style lists on jobs threads, largest
+    // file first, and prints "name: OK" or "name: FAILED" in list order
+    static bool checkLists(const QStringList &manifestPaths, checksumEngine::IoBackend backend,
+                           CacheMode cacheMode, int jobs, bool failFast);
+    // Finds files with identical contents among the files found by walking paths and prints
+    // them in groups separated by blank lines, the group wasting most space first
+    static bool findDuplicates(directoryWalker &walker, const QStringList &paths,
+                               checksumEngine::ChecksumType type, checksumEngine::IoBackend backend,
+                               CacheMode cacheMode, int jobs);
+};
+
+#endif // COMMANDLINE_H
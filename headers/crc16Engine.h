@@ -0,0 +1,28 @@
+#ifndef CRC16ENGINE_H
+#define CRC16ENGINE_H
+
+#include <QtGlobal>
+
+// CRC-16 (polynomial 0x8005, MSB first, initial value 0, no final xor) kernels.
+// Every function continues from a running crc: pass 0 for the first block and the
+// previous return value for the following ones.
+namespace crc16Engine {
+
+// Default kernel used by computeCrc
+quint16 update(quint16 crc, const unsigned char *data, qint64 len);
+
+// Crc of two concatenated blocks from the crc of each block and the length of the second,
+// lets parts of a file be hashed in parallel
+quint16 combine(quint16 crc1, quint16 crc2, qint64 len2);
+
+// One table lookup per byte, kept as the reference implementation
+quint16 updateBytewise(quint16 crc, const unsigned char *data, qint64 len);
+// Eight table lookups per 8 byte block
+quint16 updateSlicing8(quint16 crc, const unsigned char *data, qint64 len);
+
+// Checks the slicing kernel against the bytewise reference over many lengths and alignments
+bool selfTest();
+
+} // namespace crc16Engine
+
+#endif // CRC16ENGINE_H
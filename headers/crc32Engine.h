@@ -0,0 +1,49 @@
+#ifndef CRC32ENGINE_H
+#define CRC32ENGINE_H
+
+#include <QtGlobal>
+
+// CRC-32 (reflected polynomial 0xEDB88320) kernels.
+// Every function continues from a running crc: pass 0 for the first block and the
+// previous return value for the following ones.
+namespace crc32Engine {
+
+// Available implementations, in order of preference
+enum Kernel {
+    Bytewise,
+    Slicing8,
+    Slicing16,
+    Pclmul
+};
+
+// Default kernel used by computeCrc32, picked once at runtime
+quint32 update(quint32 crc, const unsigned char *data, qint64 len);
+// Runs one specific kernel, which must be supported by this CPU
+quint32 updateWith(Kernel kernel, quint32 crc, const unsigned char *data, qint64 len);
+
+// Crc of two concatenated blocks from the crc of each block and the length of the second,
+// lets parts of a file be hashed in parallel
+quint32 combine(quint32 crc1, quint32 crc2, qint64 len2);
+
+// Kernel used by update()
+Kernel activeKernel();
+// Whether the kernel was compiled in and the CPU can run it
+bool isKernelSupported(Kernel kernel);
+// Human readable kernel name
+const char *kernelName(Kernel kernel);
+// Checks every supported kernel against the bytewise reference over many lengths and
+// alignments, returns false on the first mismatch
+bool selfTest();
+
+// Classic one table lookup per byte, kept as the reference implementation
+quint32 updateBytewise(quint32 crc, const unsigned char *data, qint64 len);
+// Eight table lookups per 8 byte block
+quint32 updateSlicing8(quint32 crc, const unsigned char *data, qint64 len);
+// Sixteen table lookups per 16 byte block
+quint32 updateSlicing16(quint32 crc, const unsigned char *data, qint64 len);
+// Carry-less multiply folding, x86 with PCLMULQDQ and SSE4.1 only
+quint32 updatePclmul(quint32 crc, const unsigned char *data, qint64 len);
+
+} // namespace crc32Engine
+
+#endif // CRC32ENGINE_H
@@ -0,0 +1,44 @@
+#ifndef CRC32CENGINE_H
+#define CRC32CENGINE_H
+
+#include <QtGlobal>
+
+// CRC-32C (Castagnoli, reflected polynomial 0x82F63B78) kernels.
+// Every function continues from a running crc: pass 0 for the first block and the
+// previous return value for the following ones.
+namespace crc32cEngine {
+
+// Available implementations, in order of preference
+enum Kernel {
+    Bytewise,
+    Slicing8,
+    Sse42
+};
+
+// Default kernel, picked once at runtime
+quint32 update(quint32 crc, const unsigned char *data, qint64 len);
+// Runs one specific kernel, which must be supported by this CPU
+quint32 updateWith(Kernel kernel, quint32 crc, const unsigned char *data, qint64 len);
+
+// Crc of two concatenated blocks from the crc of each block and the length of the second
+quint32 combine(quint32 crc1, quint32 crc2, qint64 len2);
+
+// Kernel used by update()
+Kernel activeKernel();
+// Whether the kernel was compiled in and the CPU can run it
+bool isKernelSupported(Kernel kernel);
+// Human readable kernel name
+const char *kernelName(Kernel kernel);
+// Checks every supported kernel against the bytewise reference and the check value
+bool selfTest();
+
+// One table lookup per byte, the reference implementation
+quint32 updateBytewise(quint32 crc, const unsigned char *data, qint64 len);
+// Eight table lookups per 8 byte block
+quint32 updateSlicing8(quint32 crc, const unsigned char *data, qint64 len);
+// SSE4.2 crc32 instruction on three interleaved streams, x86 only
+quint32 updateSse42(quint32 crc, const unsigned char *data, qint64 len);
+
+} // namespace crc32cEngine
+
+#endif // CRC32CENGINE_H
@@ -0,0 +1,28 @@
+#ifndef CRC64ENGINE_H
+#define CRC64ENGINE_H
+
+#include <QtGlobal>
+
+// CRC-64/XZ (reflected polynomial 0xC96C5795D7870F42, as used by xz and 7-Zip) kernels.
+// Every function continues from a running crc: pass 0 for the first block and the
+// previous return value for the following ones.
+namespace crc64Engine {
+
+// Default kernel
+quint64 update(quint64 crc, const unsigned char *data, qint64 len);
+
+// Crc of two concatenated blocks from the crc of each block and the length of the second,
+// lets parts of a file be hashed in parallel
+quint64 combine(quint64 crc1, quint64 crc2, qint64 len2);
+
+// One table lookup per byte, kept as the reference implementation
+quint64 updateBytewise(quint64 crc, const unsigned char *data, qint64 len);
+// Eight table lookups per 8 byte block
+quint64 updateSlicing8(quint64 crc, const unsigned char *data, qint64 len);
+
+// Checks the slicing kernel against the bytewise reference over many lengths and alignments
+bool selfTest();
+
+} // namespace crc64Engine
+
+#endif // CRC64ENGINE_H
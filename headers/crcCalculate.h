@@ -5,7 +5,7 @@
 #include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
-#include <QTableWidget>
+#include <QTableView>
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QDesktopServices>
@@ -18,14 +18,34 @@
 #include <QMimeData>
 #include <QToolTip>
 #include <QComboBox>
-#include <QCryptographicHash>
+#include <QCheckBox>
 #include <QLineEdit>
 #include <QLabel>
+#include <QSet>
+#include <QVector>
+#include <QTimer>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <QDir>
+#include <QLocale>
+
+#include "checksumEngine.h"
+#include "hashResult.h"
+#include "checksumTableModel.h"
+#include "checksumManifest.h"
+#include "manifestVerifier.h"
+#include "duplicateFinder.h"
+#include "folderWatcher.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class crcCalculate; }
 QT_END_NAMESPACE
 
+class hashScheduler;
+class directoryWalker;
+
 // Class to calculate CRC checksum
 class crcCalculate : public QWidget
 {
@@ -37,18 +57,8 @@ public:
     // Destructor
     ~crcCalculate();
 
-    // Calculates checksum for a file
-    QString CalculateChecksum(const QString &filePath);
-    // Computes CRC value
-    unsigned short computeCrc(unsigned char *message, qint64 blk_len);
-
-    enum ChecksumType {
-        CRC16,
-        CRC32,
-        MD5,
-        SHA1,
-        SHA256
-    };
+    // Walks files and folders with the current filters, found files arrive in processFiles
+    void importPaths(const QStringList &paths);
 
 protected:
     // Handles drag enter event
@@ -59,28 +69,87 @@ protected:
 private slots:
     // Slot for add files button click
     void on_btnAddFiles_clicked();
+    // Slot for add folder button click
+    void on_btnAddFolder_clicked();
     // Slot for clear button click
     void on_btnClear_clicked();
-    // Slot for table item click
-    void onTableItemClicked(int row, int column);
+    // Slot for verify list button click
+    void on_btnVerify_clicked();
+    // Slot for export list button click
+    void on_btnExport_clicked();
+    // Slot for find duplicates button click
+    void on_btnDuplicates_clicked();
+    // Slot for table cell click
+    void onTableItemClicked(const QModelIndex &index);
     // Slot for checksum type change
     void onChecksumTypeChanged(int index);
+    // Slot for a batch of checksums finished by the worker pool
+    void onFilesHashed(const QVector<hashResult> &results);
+    // Slot for a batch of files found in an imported folder
+    void onFilesFound(const QStringList &filePaths, int walkGeneration);
+    // Slot for a batch of checked checksum list entries
+    void onEntriesVerified(const QVector<manifestVerifier::result> &results, int runGeneration);
+    // Slot for the end of a checksum list check
+    void onVerifyFinished(int passed, int failed, int missing, int runGeneration);
+    // Slot for the end of a duplicate search
+    void onDuplicatesFound(const QVector<duplicateFinder::group> &groups, const duplicateFinder::summary &counters,
+                           int runGeneration);
+    // Slot for files that changed in watched folders
+    void onWatchedFilesChanged(const QStringList &changedPaths, const QStringList &removedPaths);
+    // Slot for the progress timer, refreshes the progress bars and the status line
+    void onStatisticsTimer();
 
 private:
     // UI pointer
     Ui::crcCalculate *ui;
     // Current checksum type
-    ChecksumType currentType;
+    checksumEngine::ChecksumType currentType;
+    // Background hashing pool
+    hashScheduler *scheduler;
+    // Rows of the file table
+    checksumTableModel *tableModel;
+    // Lists dropped and imported folders in the background
+    directoryWalker *walker;
+    // Checks files against loaded checksum lists
+    manifestVerifier *verifier;
+    // Looks for files with identical contents among the listed ones
+    duplicateFinder *finder;
+    // Reports changes in imported folders while Watch Folders is checked
+    folderWatcher *watcher;
+    // Folders imported since the last Clear All, watched once Watch Folders is checked
+    QStringList importedFolders;
+    // Files that changed while they were being hashed, their results are out of date
+    QSet<QString> staleFiles;
+    // Entries of the checksum list being checked
+    QVector<checksumManifest::entry> verifyEntries;
+    // Checksums computed so far, keyed by file path
+    QHash<QString, hashResult> checksumCache;
+    // Files queued or being hashed
+    QSet<QString> pendingFiles;
+    // Refreshes progress while files are hashed
+    QTimer statisticsTimer;
+    // Files whose row shows a progress bar
+    QSet<QString> progressFiles;
+    // Whether the status line shows the summary of a finished run
+    bool statusIdle;
 
-    // Sets up the table widget
+    // Sets up the table view
     void setupTable();
-    // Finds row index by file path
-    int findRowByPath(const QString &fullFilePath);
-    // Processes a file to calculate checksum
-    void processFile(const QString &filePath);
+    // Adds files to the table and calculates their checksums
+    void processFiles(const QStringList &filePaths);
+    // Watches folders with the current filters
+    void watchFolders(const QStringList &folders);
     // Updates checksums for all files
     void updateChecksums();
-    // Computes CRC32
-    unsigned int computeCrc32(const QByteArray &data);
+    // Checksum types requested for each file
+    QVector<checksumEngine::ChecksumType> requestedTypes() const;
+    // Cached checksum of the current type, empty if there is none or Force Re-hash is checked
+    QString cachedChecksum(const QString &filePath) const;
+    // Queues the files that are not already being hashed
+    void queueFiles(const QStringList &filePaths);
+    // Stores checksums of one file and shows them, returns true if the file must be hashed again
+    bool applyResult(const hashResult &result);
+    // Lists duplicate groups in a dialog, double clicking a file opens its folder
+    void showDuplicateGroups(const QVector<duplicateFinder::group> &groups, const duplicateFinder::summary &counters);
 };
 #endif // CRCCALCULATE_H
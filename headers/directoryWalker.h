@@ -0,0 +1,139 @@
+#ifndef DIRECTORYWALKER_H
+#define DIRECTORYWALKER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <QSet>
+#include <QPair>
+#include <QStringList>
+#include <QRegularExpression>
+
+// Walks directory trees on a thread pool and streams the files it finds in batches, so
+// hashing can start long before a large tree is fully listed. Each directory is listed by
+// one thread, the subdirectories it contains are shared with the other threads.
+class directoryWalker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Compiled include and exclude glob lists, see setFilters()
+    class pathFilter
+    {
+    public:
+        pathFilter() = default;
+        pathFilter(const QString &include, const QString &exclude);
+
+        // Whether a file or directory is excluded, relativePath is the path below the walked root
+        bool excludes(const QString &name, const QString &relativePath) const;
+        // Whether a file that is not excluded passes the include list
+        bool includes(const QString &name, const QString &relativePath) const;
+
+    private:
+        QVector<QRegularExpression> includeNames;
+        QVector<QRegularExpression> includePaths;
+        QVector<QRegularExpression> excludeNames;
+        QVector<QRegularExpression> excludePaths;
+    };
+
+    // Constructor
+    explicit directoryWalker(QObject *parent = nullptr);
+    // Destructor, stops the walk and waits for the threads
+    ~directoryWalker();
+
+    // Glob patterns separated by ';' or ','. Patterns without '/' match the file name,
+    // patterns with '/' the path below the walked directory. An empty include list accepts
+    // every file, excluded directories are not entered. Applies to walks started later.
+    void setFilters(const QString &include, const QString &exclude);
+    // Whether symbolic links to directories are entered, loops are detected either way
+    void setFollowSymlinks(bool follow);
+    // Number of threads listing directories
+    void setThreadCount(int count);
+
+    // Adds files and directories to the walk, starting it if it is not running. Files are
+    // reported as they are, without filtering. Never blocks: directories added while a
+    // cancelled walk winds down start a new walk once its threads have left.
+    void add(const QStringList &paths);
+    // Stops the walk, batches already reported stay valid
+    void cancel();
+    // Blocks until the walk is finished or cancelled
+    void waitForFinished();
+    // Whether directories are still being listed
+    bool isRunning() const;
+    // Incremented by cancel(), batches reported with an older value belong to a cancelled walk
+    int generation() const;
+
+    // Number of files reported together
+    static const int BatchSize = 512;
+    // Longest time a found file is held back to fill a batch
+    static const int BatchIntervalMs = 100;
+
+signals:
+    // Emitted from the walking threads, connect with Qt::QueuedConnection unless the
+    // receiver is thread safe. Compare walkGeneration with generation() to drop batches that
+    // were still queued when the walk was cancelled.
+    void filesFound(const QStringList &filePaths, int walkGeneration);
+    // Emitted from a walking thread once the last directory is listed
+    void finished();
+
+private:
+    class walkJob;
+
+    // Directory waiting to be listed
+    struct pendingDirectory
+    {
+        QString path;
+        // Length of the walked root, the rest of path is matched by '/' patterns
+        int rootLength;
+        // (device, inode), or the canonical path where the platform reports no inode
+        QPair<quint64, quint64> key;
+        QString canonicalPath;
+    };
+
+    // Body of every walking thread
+    void work();
+    // Queues root directories and starts threads, a new walk if none is running. Must be
+    // called with the mutex held.
+    void startLocked(const QVector<pendingDirectory> &directories);
+    // Lists one directory, queues its subdirectories and adds its files to batch
+    void listDirectory(const pendingDirectory &directory, QStringList &batch);
+    // Reads what identifies a directory independent of the path it was reached by
+    static pendingDirectory makeDirectory(const QString &path, int rootLength);
+    // Returns false if the directory was seen before in this walk, i.e. a symlink loop
+    bool markVisited(const pendingDirectory &directory);
+    // Builds patterns from a ';' or ',' separated glob list
+    static void compilePatterns(const QString &globs, QVector<QRegularExpression> *names,
+                                QVector<QRegularExpression> *paths);
+    // Whether any name or path pattern matches
+    static bool matches(const QVector<QRegularExpression> &names, const QVector<QRegularExpression> &paths,
+                        const QString &name, const QString &relativePath);
+
+    QThreadPool pool;
+    mutable QMutex mutex;
+    // Signalled when directories are queued or the walk ends
+    QWaitCondition workAvailable;
+    // Signalled when the last thread leaves
+    QWaitCondition walkFinished;
+    // Directories not listed yet, depth first
+    QVector<pendingDirectory> queue;
+    // Roots added while a cancelled walk winds down, they start the next walk
+    QVector<pendingDirectory> deferred;
+    // (device, inode) of every directory entered in this walk
+    QSet<QPair<quint64, quint64>> visited;
+    // Canonical paths where the platform reports no inode
+    QSet<QString> visitedPaths;
+    // Threads inside work()
+    int activeWorkers;
+    // Threads currently listing a directory
+    int busyWorkers;
+    int threadCount;
+    int currentGeneration;
+    bool cancelled;
+    bool followSymlinks;
+    pathFilter filter;
+    pathFilter nextFilter;
+};
+
+#endif // DIRECTORYWALKER_H
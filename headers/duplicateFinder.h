@@ -0,0 +1,114 @@
+#ifndef DUPLICATEFINDER_H
+#define DUPLICATEFINDER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <QMetaType>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+#include "checksumEngine.h"
+
+// Finds files with identical contents while reading as little as possible. Files are grouped
+// by size first, files that share a size by a sample checksum of their first and last
+// SampleSize bytes, and only files that still collide are hashed completely. Hard links of one
+// file are read once and never count as wasted space.
+class duplicateFinder : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Files with the same contents
+    struct group
+    {
+        qint64 size = 0;
+        // Full checksum of the contents, upper case hex
+        QString checksum;
+        // Sorted paths
+        QStringList filePaths;
+    };
+
+    // Counters of a finished run
+    struct summary
+    {
+        // Files that were looked at, and their total size
+        int files = 0;
+        qint64 totalBytes = 0;
+        // Files left after grouping by size and after comparing samples
+        int sizeCandidates = 0;
+        int fullCandidates = 0;
+        // Bytes read for samples and full checksums, cached checksums included
+        qint64 bytesHashed = 0;
+        // Files that vanished or could not be read
+        int unreadable = 0;
+        // Groups found, the copies beyond the first of each and their size
+        int groups = 0;
+        int redundantFiles = 0;
+        qint64 wastedBytes = 0;
+
+        // One line summary, e.g. "3 groups, 5 redundant copies, 1.20 GB wasted; read 24.1 MB of
+        // 310.52 GB, 11 of 4210 files fully hashed"
+        QString text() const;
+    };
+
+    // Constructor
+    explicit duplicateFinder(QObject *parent = nullptr);
+    // Destructor, stops the run and waits for the threads
+    ~duplicateFinder();
+
+    // Checksum type that confirms a duplicate, SHA-256 by default. Types shorter than 128 bits
+    // are replaced by SHA-256, their collisions would report false duplicates.
+    void setChecksumType(checksumEngine::ChecksumType type);
+    // How files are read
+    void setBackend(checksumEngine::IoBackend backend);
+    // Whether full checksums come from and go to the persistent checksum database, on by default
+    void setUseDatabase(bool use);
+    // Files smaller than this are ignored, 1 by default so empty files are skipped
+    void setMinimumSize(qint64 size);
+    // Number of files read at the same time
+    void setThreadCount(int count);
+
+    // Starts looking for duplicates among the files, cancelling a run that is still going
+    void start(const QStringList &filePaths);
+    // Stops the current run, files being read are finished but not reported
+    void cancel();
+    // Blocks until the current run is finished or cancelled
+    void waitForFinished();
+    // Incremented by start() and cancel(), results reported with an older value are stale
+    int generation() const;
+
+    // Bytes read from each end of a file for its sample checksum
+    static const qint64 SampleSize = 4 * 1024;
+
+signals:
+    // Emitted from a worker thread when a run is complete, groups largest wasted space first.
+    // Not emitted for cancelled runs.
+    void finished(const QVector<duplicateFinder::group> &groups, const duplicateFinder::summary &counters,
+                  int runGeneration);
+
+private:
+    struct findRun;
+    class findJob;
+
+    // Body of the thread that runs the three stages
+    void find(const QSharedPointer<findRun> &run);
+    // Calls work(i) for every i in [0, count) on up to the pool's thread count, this one included
+    void forEachParallel(int count, const std::function<void(int)> &work);
+
+    QThreadPool pool;
+    QAtomicInt currentGeneration;
+    // Run started last, shared with its threads
+    QSharedPointer<findRun> currentRun;
+    checksumEngine::ChecksumType type;
+    checksumEngine::IoBackend backend;
+    bool useDatabase;
+    qint64 minimumSize;
+};
+Q_DECLARE_METATYPE(duplicateFinder::group)
+Q_DECLARE_METATYPE(duplicateFinder::summary)
+
+#endif // DUPLICATEFINDER_H
@@ -0,0 +1,29 @@
+#ifndef FILEIDENTITY_H
+#define FILEIDENTITY_H
+
+#include <QString>
+
+// What a file looked like on disk, used to tell whether stored checksums are still valid
+struct fileIdentity
+{
+    QString path;
+    qint64 size = -1;
+    // Modification time in nanoseconds since the epoch, as precise as the platform reports it
+    qint64 modified = 0;
+    // Inode number, file index on Windows
+    quint64 inode = 0;
+    // Device the file lives on
+    quint64 device = 0;
+
+    // Reads the identity of a file with a single stat, returns false if it does not exist
+    static bool read(const QString &filePath, fileIdentity *identity);
+
+    // True when both describe the same unchanged file
+    bool operator==(const fileIdentity &other) const
+    {
+        return size == other.size && modified == other.modified && inode == other.inode && path == other.path;
+    }
+    bool operator!=(const fileIdentity &other) const { return !(*this == other); }
+};
+
+#endif // FILEIDENTITY_H
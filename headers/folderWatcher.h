@@ -0,0 +1,155 @@
+#ifndef FOLDERWATCHER_H
+#define FOLDERWATCHER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QVector>
+#include <QStringList>
+
+#include "directoryWalker.h"
+
+class QFileSystemWatcher;
+class QSocketNotifier;
+
+// Keeps an eye on directory trees and reports files that appear, change or disappear. Each
+// directory gets one kernel watch (inotify on Linux, QFileSystemWatcher elsewhere) and a
+// snapshot of the size and modification time of its files. Changes only mark their directory;
+// once the tree has been quiet for QuietMs the marked directories are listed again on a pool
+// thread and compared with their snapshots. Nothing runs while nothing changes.
+//
+// On Linux a file counts as written when it is closed, so files still being written are not
+// read half way. Other platforms report a directory when an entry in it changes.
+class folderWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Constructor
+    explicit folderWatcher(QObject *parent = nullptr);
+    // Destructor, removes every watch and waits for running scans
+    ~folderWatcher();
+
+    // Filters and symlink setting of trees watched from now on, as in directoryWalker
+    void setFilters(const QString &include, const QString &exclude);
+    void setFollowSymlinks(bool follow);
+
+    // Starts watching directory trees. Their current files are taken as the starting point and
+    // not reported. Trees that are already watched are skipped.
+    void watch(const QStringList &directories);
+    // Stops watching everything, changes not reported yet are dropped
+    void clear();
+    // Number of directories being watched
+    int directoryCount() const;
+
+    // Quiet time after the last change before marked directories are listed
+    static const int QuietMs = 300;
+    // Longest time a change waits while the tree keeps changing
+    static const int MaxDelayMs = 2000;
+    // Directories listed by one pool job
+    static const int ScanBatchSize = 64;
+
+signals:
+    // Files that appeared or whose size or modification time changed, and files that are gone
+    void filesChanged(const QStringList &changedPaths, const QStringList &removedPaths);
+
+private slots:
+    // A kernel watch reported a change in a directory
+    void onDirectoryChanged(const QString &path);
+    // Reads pending inotify events, Linux only
+    void onWatchEvents();
+    // The tree was quiet long enough, lists the marked directories
+    void onSettled();
+
+private:
+    class scanJob;
+
+    // What identifies a file's contents without reading them
+    struct fileStamp
+    {
+        qint64 size;
+        qint64 modified;
+    };
+
+    // Directory tree added by watch()
+    struct watchRoot
+    {
+        // Length of the root path including the separator, the rest is matched by '/' patterns
+        int rootLength;
+        directoryWalker::pathFilter filter;
+        bool followSymlinks;
+    };
+
+    // One watched directory
+    struct watchedDirectory
+    {
+        int root;
+        // (device, inode) of the directory
+        QPair<quint64, quint64> key;
+        // inotify watch descriptor, -1 without one
+        int descriptor;
+        // Snapshot of the files, by name
+        QHash<QString, fileStamp> files;
+        // Paths of the watched subdirectories
+        QSet<QString> subdirectories;
+        // A listing is on its way, and whether it is already out of date
+        bool scanning;
+        bool rescan;
+    };
+
+    // Contents of a directory, read on a pool thread
+    struct listing
+    {
+        QString path;
+        bool exists;
+        QHash<QString, fileStamp> files;
+        // Path and (device, inode) of every subdirectory that passes the filters
+        QVector<QPair<QString, QPair<quint64, quint64>>> subdirectories;
+    };
+
+    // Queues listings of directories, report tells whether differences are reported
+    void scan(const QStringList &paths, bool report);
+    // Reads a directory with the filters of its root, runs on a pool thread
+    static listing list(const QString &path, const watchRoot &root);
+    // Compares listings with the snapshots, watches new subdirectories and reports the changes
+    void applyListings(const QVector<listing> &listings, bool report, int scanGeneration);
+    // Starts watching one directory, false if it is watched already
+    bool addDirectory(const QString &path, int root, const QPair<quint64, quint64> &key);
+    // Stops watching a directory and its subdirectories, their files go to removed
+    void removeDirectory(const QString &path, QStringList *removed);
+    // Marks a directory for listing and (re)starts the quiet timer
+    void markDirty(const QString &path);
+
+    QThreadPool pool;
+    // Every watched directory by path
+    QHash<QString, watchedDirectory> directories;
+    // (device, inode) of every watched directory, so links into a watched tree are skipped
+    QSet<QPair<quint64, quint64>> watchedKeys;
+    QVector<watchRoot> roots;
+    // Directories marked since the last listing
+    QSet<QString> dirty;
+    QTimer settleTimer;
+    // Time since the first change of the current burst
+    QElapsedTimer burst;
+    // Incremented by clear(), listings of an older generation are dropped
+    int currentGeneration;
+    directoryWalker::pathFilter nextFilter;
+    bool nextFollowSymlinks;
+
+#ifdef Q_OS_LINUX
+    int inotifyFd;
+    QSocketNotifier *notifier;
+    // Watched directory of every inotify watch descriptor
+    QHash<int, QString> descriptors;
+    // Whether running out of inotify watches was reported
+    bool warnedLimit;
+#else
+    QFileSystemWatcher *systemWatcher;
+#endif
+};
+
+#endif // FOLDERWATCHER_H
@@ -0,0 +1,26 @@
+#ifndef HASHRESULT_H
+#define HASHRESULT_H
+
+#include <QString>
+#include <QDateTime>
+#include <QHash>
+#include <QMetaType>
+
+// Checksums of one file together with the file state they were computed from
+struct hashResult
+{
+    QString filePath;
+    qint64 size = -1;
+    QDateTime modified;
+    // Upper case hex digests keyed by checksumEngine::ChecksumType
+    QHash<int, QString> checksums;
+
+    // True when the file still has the size and modification time seen while hashing
+    bool matches(qint64 currentSize, const QDateTime &currentModified) const
+    {
+        return size == currentSize && modified == currentModified;
+    }
+};
+Q_DECLARE_METATYPE(hashResult)
+
+#endif // HASHRESULT_H
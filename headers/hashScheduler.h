@@ -0,0 +1,79 @@
+#ifndef HASHSCHEDULER_H
+#define HASHSCHEDULER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+
+#include "checksumEngine.h"
+#include "hashResult.h"
+
+// Runs file hashing jobs with a set of worker threads per block device. Each device's workers
+// are pinned to the NUMA node its controller hangs off (spread over the nodes when that is not
+// known) and share that node's cores with the other busy devices on it, a spinning disk gets
+// only systemTopology::RotationalReaders so its head is not torn between many files.
+class hashScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Constructor
+    explicit hashScheduler(QObject *parent = nullptr);
+    // Destructor, waits for running jobs
+    ~hashScheduler();
+
+    // Queues a file to be hashed with all given checksum types in a single pass
+    void enqueue(const QString &filePath, const QVector<checksumEngine::ChecksumType> &types);
+    // Queues files in jobs of up to BatchSize files, each job reads its files in inode order
+    void enqueue(const QStringList &filePaths, const QVector<checksumEngine::ChecksumType> &types);
+    // Drops queued jobs and discards results of jobs that are already running
+    void cancelAll();
+    // Number of worker threads over all devices
+    int workerCount() const;
+    // Ignore the persistent checksum database and re-read every file queued from now on
+    void setForceRehash(bool force);
+
+    // Whether a job queued with jobGeneration was not cancelled since
+    bool isCurrent(int jobGeneration) const;
+    // Called from worker threads with the files a job finished
+    void reportResults(int jobGeneration, const QVector<hashResult> &results);
+
+    // Files hashed by one job
+    static const int BatchSize = 32;
+    // Longest time a job holds back finished results, e.g. while it hashes a large file
+    static const int ReportIntervalMs = 100;
+
+signals:
+    // Emitted from a worker thread, connect with Qt::QueuedConnection
+    void filesHashed(const QVector<hashResult> &results);
+
+private:
+    // Workers of one block device
+    struct deviceLane
+    {
+        quint64 device;
+        // Node the workers are pinned to
+        int node;
+        // Files queued and not finished yet
+        QAtomicInt pending;
+        QThreadPool pool;
+    };
+
+    // Lane of the device a file lives on, created on first use
+    deviceLane *laneFor(const QString &filePath);
+    // Shares the cores of every node among its lanes that have work
+    void balanceLanes();
+
+    QVector<deviceLane *> lanes;
+    // Device of every directory files were queued from, so a batch costs one stat per directory
+    QHash<QString, quint64> directoryDevices;
+    // Incremented by cancelAll so late results can be recognised
+    QAtomicInt generation;
+    // Whether new jobs bypass the persistent checksum database
+    bool forceRehash;
+};
+
+#endif // HASHSCHEDULER_H
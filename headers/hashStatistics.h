@@ -0,0 +1,155 @@
+#ifndef HASHSTATISTICS_H
+#define HASHSTATISTICS_H
+
+#include <QAtomicInt>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+// Live counters of the hashing work in this process: bytes hashed, time spent waiting for data
+// versus hashing it, queued files and the files being read right now. checksumEngine feeds
+// every block it hashes, the schedulers report queued and completed files. Thread safe.
+//
+// The totals are kept per thread in atomics and summed by current(), so hashing threads only
+// take the mutex for files registered with fileStarted. Small files are not registered unless
+// the per file log is open, they only add to the totals.
+//
+// I/O wait is the wall time of a block minus the CPU time the thread used for it, so it also
+// covers page faults of memory mapped reads.
+class hashStatistics
+{
+public:
+    // A file being hashed
+    struct fileProgress
+    {
+        QString filePath;
+        qint64 size;
+        qint64 bytesDone;
+        double mbPerSecond;
+    };
+
+    // State at one point in time
+    struct snapshot
+    {
+        qint64 bytesDone = 0;
+        qint64 filesQueued = 0;
+        qint64 filesDone = 0;
+        // Files queued but not completed yet, including the active ones
+        qint64 queueDepth = 0;
+        // Time since the current run started
+        qint64 elapsedMs = 0;
+        // Summed over all hashing threads
+        qint64 cpuNs = 0;
+        qint64 ioWaitNs = 0;
+        // Over the last ThroughputWindowMs
+        double mbPerSecond = 0;
+        // Estimated from the active files and the average size of finished ones, -1 if unknown
+        qint64 bytesRemaining = -1;
+        double etaSeconds = -1;
+        QVector<fileProgress> activeFiles;
+
+        // Share of the hashing threads' time spent waiting for data, 0 to 1
+        double ioWaitShare() const;
+        // One line summary, e.g. "3 of 120 files, 1.2 GB at 412 MB/s, I/O wait 63%, ETA 0:08"
+        QString statusText() const;
+    };
+
+    // Process wide instance
+    static hashStatistics &instance();
+
+    // Files handed to a scheduler, starts a new run when nothing was pending
+    void addQueued(int files);
+    // Files a scheduler is done with, hashed, cached or failed
+    void addCompleted(int files);
+
+    // Called by checksumEngine around every file it reads. A file read by several callers at
+    // once, e.g. the scheduler and the manifest verifier, shares one entry that stays until
+    // the last of them finishes.
+    void fileStarted(const QString &filePath, qint64 size);
+    void fileFinished(const QString &filePath, bool ok);
+    // Called by checksumEngine for every block, from any thread
+    void addBlock(const QString &filePath, qint64 bytes, qint64 wallNs, qint64 cpuNs);
+    // Called by checksumEngine for an unregistered small file, without the lock
+    void addSmallFile(qint64 bytes);
+    // Whether every file has to be registered because the per file log is open
+    bool logsFiles() const;
+
+    // Current state, also samples the throughput
+    snapshot current();
+    // Clears every counter and starts a new run
+    void reset();
+
+    // Writes one record per hashed file and a summary on close, JSON lines if the path ends
+    // in .json, CSV otherwise
+    bool openLog(const QString &logPath, QString *error);
+    void closeLog();
+
+    // Monotonic wall clock and CPU time of the calling thread in nanoseconds
+    static qint64 wallNs();
+    static qint64 threadCpuNs();
+    // Byte count for status lines, e.g. "1.25 GB", "3.4 MB" or "0.5 KB"
+    static QString formatBytes(qint64 bytes);
+
+    // Window the current throughput is averaged over
+    static const int ThroughputWindowMs = 3000;
+
+private:
+    hashStatistics();
+
+    // Bookkeeping of a file being hashed
+    struct fileState
+    {
+        qint64 size = 0;
+        qint64 bytesDone = 0;
+        qint64 startedNs = 0;
+        qint64 cpuNs = 0;
+        qint64 ioWaitNs = 0;
+        // Callers reading the file right now, size and bytesDone are summed over them
+        int users = 0;
+    };
+
+    // Counters of the whole process
+    struct totals
+    {
+        qint64 bytesDone = 0;
+        qint64 bytesOfFinishedFiles = 0;
+        qint64 filesFinished = 0;
+        qint64 filesDone = 0;
+        qint64 cpuNs = 0;
+        qint64 ioWaitNs = 0;
+    };
+    // Counters one thread adds to, defined in the source file
+    struct threadCounters;
+    struct threadSlot;
+
+    // Counters of the calling thread, registered on first use
+    threadCounters &local();
+    // Folds the counters of an exiting thread into the retired ones
+    void retire(threadCounters *counters);
+    // Sum over all threads since the current run started, mutex must be held
+    totals sumLocked() const;
+    // Starts a new run, mutex must be held
+    void resetLocked();
+    // Appends a line to the log, mutex must be held
+    void writeRecord(const QString &filePath, qint64 size, qint64 wallNs, qint64 cpuNs, qint64 ioWaitNs, bool ok);
+
+    QMutex mutex;
+    QHash<QString, fileState> activeFiles;
+    QVector<threadCounters *> threads;
+    // Left behind by exited threads
+    totals retired;
+    // Sum at the start of the current run
+    totals base;
+    qint64 runStartedNs;
+    qint64 filesQueued;
+    // (time, bytesDone) pairs of the last ThroughputWindowMs
+    QVector<QPair<qint64, qint64>> samples;
+    QFile log;
+    bool jsonLog;
+    QAtomicInt logging;
+};
+
+#endif // HASHSTATISTICS_H
@@ -0,0 +1,105 @@
+#ifndef MANIFESTVERIFIER_H
+#define MANIFESTVERIFIER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <QMetaType>
+#include <QVector>
+
+#include "checksumEngine.h"
+#include "checksumManifest.h"
+#include "hashResult.h"
+
+// Checks files against the entries of checksum lists on a thread pool. Entries are split by
+// the device they live on and every device gets its own readers, pinned to the NUMA node of
+// its controller: a spinning disk a couple, an SSD its share of that node's cores. On each
+// device the largest files are started first so one big file does not run alone at the end,
+// and a run can stop at the first failure.
+class manifestVerifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Status {
+        Pending,        // not checked yet, or skipped after a failure
+        Passed,         // checksum matches
+        Failed,         // checksum differs
+        Missing,        // file does not exist
+        Unreadable      // file exists but could not be read
+    };
+
+    // Outcome for one entry
+    struct result
+    {
+        // Position of the entry in the list passed to start()
+        int index = -1;
+        Status status = Pending;
+        // Every checksum computed for the file, including the extra types
+        hashResult hashed;
+    };
+
+    // Constructor
+    explicit manifestVerifier(QObject *parent = nullptr);
+    // Destructor, stops the run and waits for the threads
+    ~manifestVerifier();
+
+    // Stops a run once an entry fails, is missing or cannot be read. Applies to runs started later.
+    void setStopOnFailure(bool stop);
+    // Checksum types computed along with the listed one in the same read, e.g. for display
+    void setExtraTypes(const QVector<checksumEngine::ChecksumType> &types);
+    // How files are read
+    void setBackend(checksumEngine::IoBackend backend);
+    // Whether fresh checksums are stored in the persistent checksum database, on by default
+    void setUpdateDatabase(bool update);
+    // Number of files checked at the same time
+    void setThreadCount(int count);
+
+    // Starts checking entries, cancelling a run that is still going
+    void start(const QVector<checksumManifest::entry> &entries);
+    // Stops the current run, files being read are finished but not reported
+    void cancel();
+    // Blocks until the current run is finished or cancelled
+    void waitForFinished();
+    // Incremented by start() and cancel(), results reported with an older value are stale
+    int generation() const;
+
+    // Text shown for a status, empty for Pending
+    static QString statusText(Status status);
+
+    // Longest time a thread holds back finished results
+    static const int ReportIntervalMs = 100;
+
+signals:
+    // Emitted from a worker thread, connect with Qt::QueuedConnection unless the receiver is
+    // thread safe
+    void entriesVerified(const QVector<manifestVerifier::result> &results, int runGeneration);
+    // Emitted from a worker thread once every entry is checked or the run stopped at a failure,
+    // not emitted for cancelled runs. Unreadable files count as missing.
+    void finished(int passed, int failed, int missing, int runGeneration);
+
+private:
+    struct verifyRun;
+    class verifyJob;
+
+    // Stats every entry, reports missing ones, splits the rest by device largest first and
+    // assigns the threads to the devices
+    void plan(const QSharedPointer<verifyRun> &run);
+    // Body of every worker thread, starting on the entries of one device
+    void work(const QSharedPointer<verifyRun> &run, int lane);
+    // Forwards results unless the run was cancelled
+    void report(const QSharedPointer<verifyRun> &run, const QVector<result> &results);
+
+    QThreadPool pool;
+    QAtomicInt currentGeneration;
+    // Run started last, shared with its threads
+    QSharedPointer<verifyRun> currentRun;
+    bool stopOnFailure;
+    QVector<checksumEngine::ChecksumType> extraTypes;
+    checksumEngine::IoBackend backend;
+    bool updateDatabase;
+};
+Q_DECLARE_METATYPE(manifestVerifier::result)
+
+#endif // MANIFESTVERIFIER_H
@@ -0,0 +1,20 @@
+#ifndef OPENFOLDERDELEGATE_H
+#define OPENFOLDERDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// Paints the "open file location" button of a table row. Nothing is instantiated per row,
+// clicks are handled by the view's clicked() signal.
+class openFolderDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    // Constructor
+    explicit openFolderDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // OPENFOLDERDELEGATE_H
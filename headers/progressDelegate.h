@@ -0,0 +1,19 @@
+#ifndef PROGRESSDELEGATE_H
+#define PROGRESSDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// Paints a progress bar with the file's read rate in the checksum cell of files that are being
+// hashed, the checksum text otherwise.
+class progressDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    // Constructor
+    explicit progressDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // PROGRESSDELEGATE_H
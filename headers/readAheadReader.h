@@ -0,0 +1,107 @@
+#ifndef READAHEADREADER_H
+#define READAHEADREADER_H
+
+#include <QFile>
+
+// Reads a range of a file ahead of its consumer so the disk and the checksum kernels work at
+// the same time. Up to Depth blocks are in flight: through io_uring on Linux when the kernel
+// allows it, otherwise through a pool thread filling a ring of buffers. Filled blocks are
+// handed out in file order straight from those buffers, nothing is copied.
+//
+// The buffers (and the io_uring queue) belong to the calling thread and are reused by its
+// next reader, so streaming many files allocates nothing. They are placed on the NUMA node
+// the thread is pinned to, and the pool thread of a ThreadRead is pinned to the same node.
+class readAheadReader
+{
+public:
+    enum Method {
+        SyncRead,       // one read at a time on the calling thread
+        ThreadRead,     // a pool thread reads ahead into the ring of buffers
+        UringRead       // io_uring keeps the reads in flight, Linux only
+    };
+
+    // Blocks in the ring: one held by the consumer, the others being read
+    static const int Depth = 4;
+    // Bytes per block
+    static const int BlockSize = 1024 * 1024;
+
+    // Reads the bytes [offset, end) of a file opened unbuffered, up to its end if end is
+    // negative. Sync and thread reads continue from the file's position, which must be offset.
+    readAheadReader(QFile &file, qint64 offset, qint64 end);
+    // Waits for the reads still in flight
+    ~readAheadReader();
+
+    // Returns the next block in file order, valid until the following call. Returns false at
+    // the end of the range and on errors, see failed().
+    bool next(const unsigned char **data, qint64 *length);
+    // Whether a read failed or a bounded range ended early
+    bool failed() const;
+    // How this reader gets its blocks
+    Method method() const;
+
+    // Method used for regular files on this system
+    static Method preferredMethod();
+    // Human readable method name
+    static const char *methodName(Method method);
+
+private:
+    // Per thread buffers and io_uring queue
+    struct context;
+    // State shared with the pool thread of a ThreadRead
+    struct threadPipeline;
+
+    // A block read through io_uring
+    struct uringSlot
+    {
+        qint64 offset;
+        qint64 length;
+        // Bytes that arrived so far, a short read is continued into the rest of the block
+        qint64 received;
+        bool inFlight;
+        int result;
+    };
+
+    // Buffers of the calling thread
+    static context *threadContext();
+    // Read loop of the pool thread of a ThreadRead
+    static void readAhead(threadPipeline *pipeline);
+
+    bool startUring();
+    bool startThread();
+    bool nextUring(const unsigned char **data, qint64 *length);
+    bool nextThread(const unsigned char **data, qint64 *length);
+    bool nextSync(const unsigned char **data, qint64 *length);
+    // Bytes of the next block to request, 0 once the range is exhausted
+    qint64 nextBlockLength() const;
+    // Queues the next block into slot, or marks it unused once nothing is left
+    void queueSlot(int slot);
+    // Queues the rest of a block, all of it for a new block
+    void queueRemainder(int slot);
+    // Collects completions until slot is complete
+    bool waitForSlot(int slot);
+    // Collects every outstanding completion so the buffers can be reused
+    void drainUring();
+
+    QFile &file;
+    // Next byte to request
+    qint64 offset;
+    qint64 end;
+    Method usedMethod;
+    bool finished;
+    bool error;
+    context *buffers;
+    bool ownsBuffers;
+
+    // UringRead
+    uringSlot slots[Depth];
+    int head;
+    // The head block was handed out completely and is requeued by the next call
+    bool recycleHead;
+
+    // ThreadRead
+    threadPipeline *pipeline;
+    int readIndex;
+    bool holdingSlot;
+};
+
+#endif // READAHEADREADER_H
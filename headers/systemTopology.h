@@ -0,0 +1,55 @@
+#ifndef SYSTEMTOPOLOGY_H
+#define SYSTEMTOPOLOGY_H
+
+#include <QtGlobal>
+
+// What the machine looks like to the hashing threads: NUMA nodes and their CPUs, the L2 cache
+// size, and which node and kind of drive serves a block device. Read once from sysfs on Linux
+// and from the processor information on Windows; elsewhere the machine is one node.
+//
+// Threads are pinned to a node so the buffers they fill and the page cache they fault in stay
+// on the memory controller of the CPUs that hash them. On a machine with a single node pinning
+// does nothing and the scheduler keeps moving threads freely. Thread safe.
+class systemTopology
+{
+public:
+    // Number of NUMA nodes, 1 when the platform does not report them
+    static int nodeCount();
+    // CPUs of a node this process may run on
+    static int cpuCount(int node);
+    // Node the calling thread runs on right now
+    static int currentNode();
+
+    // Node of the controller a block device hangs off, -1 if unknown
+    static int deviceNode(quint64 device);
+    // Whether the device is a spinning disk, which reads fastest from few streams
+    static bool isRotational(quint64 device);
+    // Threads reading a device at the same time when it is served from a node shared with
+    // devicesOnNode devices, node -1 for a thread that may run anywhere
+    static int readerCount(quint64 device, int node, int devicesOnNode);
+
+    // L2 cache of one core in bytes, 256 KiB if unknown
+    static qint64 l2CacheSize();
+
+    // Pins the calling thread to the CPUs of a node, -1 lets it run anywhere again. Returns
+    // false if nothing was pinned, e.g. on a single node machine.
+    static bool pinThread(int node);
+    // Node the calling thread is pinned to, -1 if it is not
+    static int threadNode();
+
+    // Page aligned memory placed on the calling thread's node, nullptr if it cannot be had
+    static void *allocate(qint64 size);
+    // Returns memory from allocate()
+    static void release(void *data, qint64 size);
+
+    // Threads that read one spinning disk, more only make its head seek
+    static const int RotationalReaders = 2;
+
+private:
+    struct topology;
+
+    // Process wide topology, read on first use
+    static topology &instance();
+};
+
+#endif // SYSTEMTOPOLOGY_H
@@ -0,0 +1,57 @@
+#ifndef XXH3ENGINE_H
+#define XXH3ENGINE_H
+
+#include <QtGlobal>
+
+// XXH3 64 and 128 bit hashes (xxHash 0.8, seed 0, default secret), bit compatible with
+// XXH3_64bits / XXH3_128bits and "xxhsum -H3" / "xxhsum -H2".
+namespace xxh3Engine {
+
+// 128 bit result, printed high word first like XXH128_canonical_t
+struct value128
+{
+    quint64 low;
+    quint64 high;
+};
+
+// Running state of one input fed in arbitrary blocks. Both widths come from the same state.
+class hashState
+{
+public:
+    hashState();
+    // Starts over with an empty input
+    void reset();
+    // Feeds the next block of the input
+    void update(const unsigned char *data, qint64 len);
+    // Hash of everything fed so far, the state can keep going afterwards
+    quint64 digest64() const;
+    value128 digest128() const;
+
+private:
+    // Bytes kept back between updates, a multiple of the stripe length
+    static const int BufferSize = 256;
+
+    alignas(16) quint64 acc[8];
+    alignas(16) unsigned char buffer[BufferSize];
+    int bufferedSize;
+    // Stripes accumulated since the last scramble
+    int stripesSoFar;
+    quint64 totalLength;
+
+    // Runs the accumulators over the data still in the buffer, on a copy of acc
+    void finishLong(quint64 *finalAcc) const;
+};
+
+// One shot helpers
+quint64 hash64(const unsigned char *data, qint64 len);
+value128 hash128(const unsigned char *data, qint64 len);
+
+// Whether stripes are accumulated with SSE2 rather than the portable code
+bool usesSse2();
+// Checks both widths against reference values over every length class, streamed in
+// several block sizes
+bool selfTest();
+
+} // namespace xxh3Engine
+
+#endif // XXH3ENGINE_H
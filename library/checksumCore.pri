@@ -0,0 +1,32 @@
+# Checksum kernels, file hashing and the checksumHasher API. Depends on QtCore only and is
+# compiled into the ChecksumCore library, which the application, the benchmark and the tests
+# link through linkChecksumCore.pri.
+
+SOURCES += \
+    $$PWD/../src/blake3Engine.cpp \
+    $$PWD/../src/checksumEngine.cpp \
+    $$PWD/../src/checksumHasher.cpp \
+    $$PWD/../src/crc16Engine.cpp \
+    $$PWD/../src/crc32Engine.cpp \
+    $$PWD/../src/crc32cEngine.cpp \
+    $$PWD/../src/crc64Engine.cpp \
+    $$PWD/../src/hashStatistics.cpp \
+    $$PWD/../src/readAheadReader.cpp \
+    $$PWD/../src/systemTopology.cpp \
+    $$PWD/../src/xxh3Engine.cpp
+
+HEADERS += \
+    $$PWD/../headers/blake3Engine.h \
+    $$PWD/../headers/checksumEngine.h \
+    $$PWD/../headers/checksumHasher.h \
+    $$PWD/../headers/crc16Engine.h \
+    $$PWD/../headers/crc32Engine.h \
+    $$PWD/../headers/crc32cEngine.h \
+    $$PWD/../headers/crc64Engine.h \
+    $$PWD/../headers/hashStatistics.h \
+    $$PWD/../headers/readAheadReader.h \
+    $$PWD/../headers/systemTopology.h \
+    $$PWD/../headers/xxh3Engine.h
+
+INCLUDEPATH += $$PWD/../headers
+DEPENDPATH += $$PWD/../headers
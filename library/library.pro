@@ -0,0 +1,16 @@
+# ChecksumCore: the checksum kernels and file hashing as a static library without any GUI
+# dependency. Built first by the root project; other projects link bin/libChecksumCore.a (or
+# ChecksumCore.lib) through linkChecksumCore.pri and include checksumHasher.h.
+
+QT       += core
+QT       -= gui
+
+TEMPLATE = lib
+CONFIG += c++14 staticlib
+
+TARGET = ChecksumCore
+DESTDIR = $$PWD/../bin/
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(checksumCore.pri)
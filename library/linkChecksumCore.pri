@@ -0,0 +1,9 @@
+# Links the ChecksumCore library built by library.pro. Included by the application, the tests
+# and the benchmark, which the root project builds after the library.
+
+INCLUDEPATH += $$PWD/../headers
+DEPENDPATH += $$PWD/../headers
+
+LIBS += -L$$PWD/../bin -lChecksumCore
+win32-msvc*: PRE_TARGETDEPS += $$PWD/../bin/ChecksumCore.lib
+else: PRE_TARGETDEPS += $$PWD/../bin/libChecksumCore.a
@@ -0,0 +1,697 @@
+#include "blake3Engine.h"
+
+#include <QtEndian>
+#include <QByteArray>
+
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86_64) || (defined(Q_PROCESSOR_X86) && defined(__SSE2__))
+#  define BLAKE3_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if defined(Q_PROCESSOR_X86_64) && (defined(Q_CC_GNU) || defined(Q_CC_MSVC))
+#  define BLAKE3_HAVE_AVX2
+#  include <immintrin.h>
+#  if defined(Q_CC_MSVC)
+#    include <intrin.h>
+#    define BLAKE3_TARGET_AVX2
+#  else
+#    define BLAKE3_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace {
+
+const quint32 IV[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+// Message word order of each of the seven rounds
+constexpr quint8 Schedule[7][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+    {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+    { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+    { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+    {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+    { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+const int BlockLength = 64;
+const int BlocksPerChunk = blake3Engine::ChunkLength / BlockLength;
+
+enum Flags {
+    ChunkStart = 1 << 0,
+    ChunkEnd   = 1 << 1,
+    Parent     = 1 << 2,
+    Root       = 1 << 3
+};
+
+inline quint32 rotr32(quint32 x, int r) { return (x >> r) | (x << (32 - r)); }
+
+// Quarter round on state words a, b, c, d with message words x and y
+#define BLAKE3_G(a, b, c, d, x, y)              \
+    s[a] = s[a] + s[b] + (x);                   \
+    s[d] = rotr32(s[d] ^ s[a], 16);             \
+    s[c] = s[c] + s[d];                         \
+    s[b] = rotr32(s[b] ^ s[c], 12);             \
+    s[a] = s[a] + s[b] + (y);                   \
+    s[d] = rotr32(s[d] ^ s[a], 8);              \
+    s[c] = s[c] + s[d];                         \
+    s[b] = rotr32(s[b] ^ s[c], 7)
+
+// Columns then diagonals. Written out so every index is a constant and the state stays in registers.
+#define BLAKE3_ROUND(r)                                                         \
+    BLAKE3_G(0, 4,  8, 12, m[Schedule[r][0]],  m[Schedule[r][1]]);              \
+    BLAKE3_G(1, 5,  9, 13, m[Schedule[r][2]],  m[Schedule[r][3]]);              \
+    BLAKE3_G(2, 6, 10, 14, m[Schedule[r][4]],  m[Schedule[r][5]]);              \
+    BLAKE3_G(3, 7, 11, 15, m[Schedule[r][6]],  m[Schedule[r][7]]);              \
+    BLAKE3_G(0, 5, 10, 15, m[Schedule[r][8]],  m[Schedule[r][9]]);              \
+    BLAKE3_G(1, 6, 11, 12, m[Schedule[r][10]], m[Schedule[r][11]]);             \
+    BLAKE3_G(2, 7,  8, 13, m[Schedule[r][12]], m[Schedule[r][13]]);             \
+    BLAKE3_G(3, 4,  9, 14, m[Schedule[r][14]], m[Schedule[r][15]])
+
+// Compresses one block of 16 message words into cv, keeping the first 8 output words: the
+// chaining value of the node, or the first 32 bytes of the root output
+inline void compress(quint32 *cv, const quint32 *m, quint32 blockLength, quint64 counter, quint32 flags)
+{
+    quint32 s[16] = {
+        cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        IV[0], IV[1], IV[2], IV[3],
+        static_cast<quint32>(counter), static_cast<quint32>(counter >> 32), blockLength, flags
+    };
+
+    BLAKE3_ROUND(0);
+    BLAKE3_ROUND(1);
+    BLAKE3_ROUND(2);
+    BLAKE3_ROUND(3);
+    BLAKE3_ROUND(4);
+    BLAKE3_ROUND(5);
+    BLAKE3_ROUND(6);
+
+    for (int i = 0; i < 8; ++i) {
+        cv[i] = s[i] ^ s[i + 8];
+    }
+}
+
+#undef BLAKE3_ROUND
+#undef BLAKE3_G
+
+// Loads a block of up to BlockLength bytes as message words, zero padded
+inline void loadBlock(quint32 *m, const unsigned char *data, int len)
+{
+    if (len == BlockLength) {
+        for (int i = 0; i < 16; ++i) m[i] = qFromLittleEndian<quint32>(data + 4 * i);
+        return;
+    }
+    unsigned char padded[BlockLength] = {};
+    std::memcpy(padded, data, static_cast<size_t>(len));
+    for (int i = 0; i < 16; ++i) m[i] = qFromLittleEndian<quint32>(padded + 4 * i);
+}
+
+// Chaining value of a parent node, written to left
+inline void parentChainingValue(quint32 *left, const quint32 *right, quint32 flags)
+{
+    quint32 m[16];
+    std::memcpy(m, left, 8 * sizeof(quint32));
+    std::memcpy(m + 8, right, 8 * sizeof(quint32));
+    std::memcpy(left, IV, 8 * sizeof(quint32));
+    compress(left, m, BlockLength, 0, Parent | flags);
+}
+
+#ifdef BLAKE3_HAVE_SSE2
+// Chunks hashed side by side, one per 32 bit lane
+const int Lanes = 4;
+
+inline __m128i rotr128(__m128i x, int r)
+{
+    return _mm_or_si128(_mm_srli_epi32(x, r), _mm_slli_epi32(x, 32 - r));
+}
+
+// Rotation by 16 swaps the 16 bit halves of every word
+inline __m128i rotr128by16(__m128i x)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+}
+
+#define BLAKE3_G4(a, b, c, d, x, y)                                             \
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), (x));                       \
+    v[d] = rotr128by16(_mm_xor_si128(v[d], v[a]));                              \
+    v[c] = _mm_add_epi32(v[c], v[d]);                                           \
+    v[b] = rotr128(_mm_xor_si128(v[b], v[c]), 12);                              \
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), (y));                       \
+    v[d] = rotr128(_mm_xor_si128(v[d], v[a]), 8);                               \
+    v[c] = _mm_add_epi32(v[c], v[d]);                                           \
+    v[b] = rotr128(_mm_xor_si128(v[b], v[c]), 7)
+
+#define BLAKE3_ROUND4(r)                                                        \
+    BLAKE3_G4(0, 4,  8, 12, m[Schedule[r][0]],  m[Schedule[r][1]]);             \
+    BLAKE3_G4(1, 5,  9, 13, m[Schedule[r][2]],  m[Schedule[r][3]]);             \
+    BLAKE3_G4(2, 6, 10, 14, m[Schedule[r][4]],  m[Schedule[r][5]]);             \
+    BLAKE3_G4(3, 7, 11, 15, m[Schedule[r][6]],  m[Schedule[r][7]]);             \
+    BLAKE3_G4(0, 5, 10, 15, m[Schedule[r][8]],  m[Schedule[r][9]]);             \
+    BLAKE3_G4(1, 6, 11, 12, m[Schedule[r][10]], m[Schedule[r][11]]);            \
+    BLAKE3_G4(2, 7,  8, 13, m[Schedule[r][12]], m[Schedule[r][13]]);            \
+    BLAKE3_G4(3, 4,  9, 14, m[Schedule[r][14]], m[Schedule[r][15]])
+
+// Transposes four rows of four words, so word i of every row ends up in row i
+inline void transpose4(__m128i *r)
+{
+    __m128i ab01 = _mm_unpacklo_epi32(r[0], r[1]);
+    __m128i ab23 = _mm_unpackhi_epi32(r[0], r[1]);
+    __m128i cd01 = _mm_unpacklo_epi32(r[2], r[3]);
+    __m128i cd23 = _mm_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm_unpacklo_epi64(ab01, cd01);
+    r[1] = _mm_unpackhi_epi64(ab01, cd01);
+    r[2] = _mm_unpacklo_epi64(ab23, cd23);
+    r[3] = _mm_unpackhi_epi64(ab23, cd23);
+}
+
+/***************************************************************************************************
+* @description : This function hashes Lanes consecutive full chunks at once with SSE2, one chunk
+*                per lane, and returns their chaining values. None of them may be the root.
+* @param : const unsigned char *input, quint64 counter, quint32 out[][8]
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashChunksSse2(const unsigned char *input, quint64 counter, quint32 out[Lanes][8])
+{
+    __m128i h[8];
+    for (int i = 0; i < 8; ++i) {
+        h[i] = _mm_set1_epi32(static_cast<int>(IV[i]));
+    }
+    const __m128i counterLow = _mm_setr_epi32(static_cast<int>(counter), static_cast<int>(counter + 1),
+                                              static_cast<int>(counter + 2), static_cast<int>(counter + 3));
+    const __m128i counterHigh = _mm_setr_epi32(static_cast<int>((counter) >> 32), static_cast<int>((counter + 1) >> 32),
+                                               static_cast<int>((counter + 2) >> 32), static_cast<int>((counter + 3) >> 32));
+
+    for (int b = 0; b < BlocksPerChunk; ++b) {
+        __m128i m[16];
+        for (int k = 0; k < 4; ++k) {
+            for (int lane = 0; lane < Lanes; ++lane) {
+                m[4 * k + lane] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                    input + lane * blake3Engine::ChunkLength + b * BlockLength + 16 * k));
+            }
+            transpose4(m + 4 * k);
+        }
+
+        quint32 flags = 0;
+        if (b == 0) flags |= ChunkStart;
+        if (b == BlocksPerChunk - 1) flags |= ChunkEnd;
+
+        __m128i v[16] = {
+            h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+            _mm_set1_epi32(static_cast<int>(IV[0])), _mm_set1_epi32(static_cast<int>(IV[1])),
+            _mm_set1_epi32(static_cast<int>(IV[2])), _mm_set1_epi32(static_cast<int>(IV[3])),
+            counterLow, counterHigh, _mm_set1_epi32(BlockLength), _mm_set1_epi32(static_cast<int>(flags))
+        };
+
+        BLAKE3_ROUND4(0);
+        BLAKE3_ROUND4(1);
+        BLAKE3_ROUND4(2);
+        BLAKE3_ROUND4(3);
+        BLAKE3_ROUND4(4);
+        BLAKE3_ROUND4(5);
+        BLAKE3_ROUND4(6);
+
+        for (int i = 0; i < 8; ++i) {
+            h[i] = _mm_xor_si128(v[i], v[i + 8]);
+        }
+    }
+
+    transpose4(h);
+    transpose4(h + 4);
+    for (int lane = 0; lane < Lanes; ++lane) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out[lane]), h[lane]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out[lane] + 4), h[lane + 4]);
+    }
+}
+
+#undef BLAKE3_ROUND4
+#undef BLAKE3_G4
+#endif // BLAKE3_HAVE_SSE2
+
+#ifdef BLAKE3_HAVE_AVX2
+// Chunks hashed side by side with AVX2
+const int WideLanes = 8;
+
+#define BLAKE3_ROTR256(x, r) _mm256_or_si256(_mm256_srli_epi32((x), (r)), _mm256_slli_epi32((x), 32 - (r)))
+
+#define BLAKE3_G8(a, b, c, d, x, y)                                             \
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), (x));                 \
+    v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot16);            \
+    v[c] = _mm256_add_epi32(v[c], v[d]);                                        \
+    v[b] = BLAKE3_ROTR256(_mm256_xor_si256(v[b], v[c]), 12);                    \
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), (y));                 \
+    v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot8);             \
+    v[c] = _mm256_add_epi32(v[c], v[d]);                                        \
+    v[b] = BLAKE3_ROTR256(_mm256_xor_si256(v[b], v[c]), 7)
+
+#define BLAKE3_ROUND8(r)                                                        \
+    BLAKE3_G8(0, 4,  8, 12, m[Schedule[r][0]],  m[Schedule[r][1]]);             \
+    BLAKE3_G8(1, 5,  9, 13, m[Schedule[r][2]],  m[Schedule[r][3]]);             \
+    BLAKE3_G8(2, 6, 10, 14, m[Schedule[r][4]],  m[Schedule[r][5]]);             \
+    BLAKE3_G8(3, 7, 11, 15, m[Schedule[r][6]],  m[Schedule[r][7]]);             \
+    BLAKE3_G8(0, 5, 10, 15, m[Schedule[r][8]],  m[Schedule[r][9]]);             \
+    BLAKE3_G8(1, 6, 11, 12, m[Schedule[r][10]], m[Schedule[r][11]]);            \
+    BLAKE3_G8(2, 7,  8, 13, m[Schedule[r][12]], m[Schedule[r][13]]);            \
+    BLAKE3_G8(3, 4,  9, 14, m[Schedule[r][14]], m[Schedule[r][15]])
+
+// Transposes eight rows of eight words
+BLAKE3_TARGET_AVX2 inline void transpose8(__m256i *r)
+{
+    __m256i t[8];
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    __m256i u[8];
+    for (int i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+/***************************************************************************************************
+* @description : This function hashes WideLanes consecutive full chunks at once with AVX2, one
+*                chunk per lane.
+* @param : const unsigned char *input, quint64 counter, quint32 out[][8]
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+BLAKE3_TARGET_AVX2 void hashChunksAvx2(const unsigned char *input, quint64 counter, quint32 out[WideLanes][8])
+{
+    const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m256i rot8 = _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                          1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+
+    quint32 counters[2][WideLanes];
+    for (int lane = 0; lane < WideLanes; ++lane) {
+        counters[0][lane] = static_cast<quint32>(counter + lane);
+        counters[1][lane] = static_cast<quint32>((counter + lane) >> 32);
+    }
+    const __m256i counterLow = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counters[0]));
+    const __m256i counterHigh = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counters[1]));
+
+    __m256i h[8];
+    for (int i = 0; i < 8; ++i) {
+        h[i] = _mm256_set1_epi32(static_cast<int>(IV[i]));
+    }
+
+    for (int b = 0; b < BlocksPerChunk; ++b) {
+        __m256i m[16];
+        for (int half = 0; half < 2; ++half) {
+            for (int lane = 0; lane < WideLanes; ++lane) {
+                m[8 * half + lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+                    input + lane * blake3Engine::ChunkLength + b * BlockLength + 32 * half));
+            }
+            transpose8(m + 8 * half);
+        }
+
+        quint32 flags = 0;
+        if (b == 0) flags |= ChunkStart;
+        if (b == BlocksPerChunk - 1) flags |= ChunkEnd;
+
+        __m256i v[16] = {
+            h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+            _mm256_set1_epi32(static_cast<int>(IV[0])), _mm256_set1_epi32(static_cast<int>(IV[1])),
+            _mm256_set1_epi32(static_cast<int>(IV[2])), _mm256_set1_epi32(static_cast<int>(IV[3])),
+            counterLow, counterHigh, _mm256_set1_epi32(BlockLength), _mm256_set1_epi32(static_cast<int>(flags))
+        };
+
+        BLAKE3_ROUND8(0);
+        BLAKE3_ROUND8(1);
+        BLAKE3_ROUND8(2);
+        BLAKE3_ROUND8(3);
+        BLAKE3_ROUND8(4);
+        BLAKE3_ROUND8(5);
+        BLAKE3_ROUND8(6);
+
+        for (int i = 0; i < 8; ++i) {
+            h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+        }
+    }
+
+    transpose8(h);
+    for (int lane = 0; lane < WideLanes; ++lane) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out[lane]), h[lane]);
+    }
+}
+
+#undef BLAKE3_ROUND8
+#undef BLAKE3_G8
+#undef BLAKE3_ROTR256
+
+bool cpuHasAvx2()
+{
+#if defined(Q_CC_MSVC)
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool osSavesYmm = (regs[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+    __cpuid(regs, 0);
+    if (!osSavesYmm || regs[0] < 7) return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif // BLAKE3_HAVE_AVX2
+
+} // namespace
+
+/***************************************************************************************************
+* @description : Constructor for an empty input.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+blake3Engine::hashState::hashState()
+{
+    reset();
+}
+
+/***************************************************************************************************
+* @description : This function starts over, at offset bytes into the input.
+* @param : quint64 offset - multiple of ChunkLength
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hashState::reset(quint64 offset)
+{
+    std::memcpy(cv, IV, sizeof(cv));
+    blockLength = 0;
+    blocksCompressed = 0;
+    startChunk = offset / ChunkLength;
+    chunkCounter = startChunk;
+    stackSize = 0;
+}
+
+/***************************************************************************************************
+* @description : This function feeds the next block of the input. A completed chunk is only
+*                finished when more input arrives, as the last chunk of a one chunk input is the
+*                root and is compressed differently.
+* @param : const unsigned char *data, qint64 len
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hashState::update(const unsigned char *data, qint64 len)
+{
+    while (len > 0) {
+        if (blocksCompressed * BlockLength + blockLength == ChunkLength) {
+            quint32 chunkCv[8];
+            chunkChainingValue(chunkCv);
+            ++chunkCounter;
+            pushChainingValue(chunkCv, 0, chunkCounter - startChunk);
+            std::memcpy(cv, IV, sizeof(cv));
+            blockLength = 0;
+            blocksCompressed = 0;
+        }
+
+#ifdef BLAKE3_HAVE_AVX2
+        // Whole chunks several at a time, as long as the last one is not the final chunk
+        static const bool avx2 = cpuHasAvx2();
+        if (avx2 && blockLength == 0 && blocksCompressed == 0 && len > WideLanes * ChunkLength) {
+            quint32 chunkCvs[WideLanes][8];
+            hashChunksAvx2(data, chunkCounter, chunkCvs);
+            for (int lane = 0; lane < WideLanes; ++lane) {
+                ++chunkCounter;
+                pushChainingValue(chunkCvs[lane], 0, chunkCounter - startChunk);
+            }
+            data += WideLanes * ChunkLength;
+            len -= WideLanes * ChunkLength;
+            continue;
+        }
+#endif
+#ifdef BLAKE3_HAVE_SSE2
+        if (blockLength == 0 && blocksCompressed == 0 && len > Lanes * ChunkLength) {
+            quint32 chunkCvs[Lanes][8];
+            hashChunksSse2(data, chunkCounter, chunkCvs);
+            for (int lane = 0; lane < Lanes; ++lane) {
+                ++chunkCounter;
+                pushChainingValue(chunkCvs[lane], 0, chunkCounter - startChunk);
+            }
+            data += Lanes * ChunkLength;
+            len -= Lanes * ChunkLength;
+            continue;
+        }
+#endif
+
+        qint64 take = ChunkLength - (blocksCompressed * BlockLength + blockLength);
+        if (take > len) take = len;
+        chunkUpdate(data, take);
+        data += take;
+        len -= take;
+    }
+}
+
+/***************************************************************************************************
+* @description : This function feeds bytes of the current chunk. Blocks are compressed straight
+*                from the input when they are complete and not the last one fed; the last block
+*                stays buffered because it may end the chunk.
+* @param : const unsigned char *data, qint64 len
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hashState::chunkUpdate(const unsigned char *data, qint64 len)
+{
+    quint32 m[16];
+    while (len > 0) {
+        const quint32 startFlag = blocksCompressed == 0 ? ChunkStart : 0;
+
+        if (blockLength == BlockLength) {
+            loadBlock(m, block, BlockLength);
+            compress(cv, m, BlockLength, chunkCounter, startFlag);
+            ++blocksCompressed;
+            blockLength = 0;
+            continue;
+        }
+        if (blockLength == 0 && len > BlockLength) {
+            loadBlock(m, data, BlockLength);
+            compress(cv, m, BlockLength, chunkCounter, startFlag);
+            ++blocksCompressed;
+            data += BlockLength;
+            len -= BlockLength;
+            continue;
+        }
+
+        int take = BlockLength - blockLength;
+        if (take > len) take = static_cast<int>(len);
+        std::memcpy(block + blockLength, data, static_cast<size_t>(take));
+        blockLength += take;
+        data += take;
+        len -= take;
+    }
+}
+
+/***************************************************************************************************
+* @description : This function compresses the buffered last block of the current chunk.
+* @param : quint32 *out
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hashState::chunkChainingValue(quint32 *out) const
+{
+    quint32 m[16];
+    loadBlock(m, block, blockLength);
+    std::memcpy(out, cv, sizeof(cv));
+    compress(out, m, static_cast<quint32>(blockLength), chunkCounter,
+             ChunkEnd | (blocksCompressed == 0 ? ChunkStart : 0));
+}
+
+/***************************************************************************************************
+* @description : This function pushes the chaining value of a subtree of 2^level chunks. Every
+*                trailing zero bit of the chunk count above level means the subtree below on the
+*                stack has the same size and both are joined into their parent.
+* @param : const quint32 *cv, int level, quint64 totalChunks
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hashState::pushChainingValue(const quint32 *cv, int level, quint64 totalChunks)
+{
+    quint32 merged[8];
+    std::memcpy(merged, cv, sizeof(merged));
+
+    quint64 total = totalChunks >> level;
+    while ((total & 1) == 0 && stackSize > 0) {
+        --stackSize;
+        parentChainingValue(stack[stackSize], merged, 0);
+        std::memcpy(merged, stack[stackSize], sizeof(merged));
+        total >>= 1;
+    }
+    std::memcpy(stack[stackSize++], merged, sizeof(merged));
+}
+
+/***************************************************************************************************
+* @description : This function continues with the state of the following range. The range's
+*                subtrees are complete and aligned, so they are pushed like chunks of their size;
+*                its unfinished chunk becomes the current one.
+* @param : const hashState &next
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hashState::append(const hashState &next)
+{
+    const bool nextEmpty = next.chunkCounter == next.startChunk && next.blockLength == 0
+                           && next.blocksCompressed == 0;
+    if (nextEmpty) return;
+
+    if (blocksCompressed * BlockLength + blockLength == ChunkLength) {
+        quint32 chunkCv[8];
+        chunkChainingValue(chunkCv);
+        ++chunkCounter;
+        pushChainingValue(chunkCv, 0, chunkCounter - startChunk);
+    }
+
+    const quint64 nextChunks = next.chunkCounter - next.startChunk;
+    int entry = 0;
+    for (int level = 63; level >= 0; --level) {
+        if ((nextChunks >> level) & 1) {
+            chunkCounter += quint64(1) << level;
+            pushChainingValue(next.stack[entry++], level, chunkCounter - startChunk);
+        }
+    }
+
+    std::memcpy(cv, next.cv, sizeof(cv));
+    std::memcpy(block, next.block, sizeof(block));
+    blockLength = next.blockLength;
+    blocksCompressed = next.blocksCompressed;
+    chunkCounter = next.chunkCounter;
+}
+
+/***************************************************************************************************
+* @description : This function joins the current chunk with the stacked subtrees from right to
+*                left and compresses the last node with the root flag.
+* @param : unsigned char *out - OutLength bytes
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hashState::finalize(unsigned char *out) const
+{
+    quint32 m[16];
+    quint32 root[8];
+    quint32 flags;
+    quint32 length;
+
+    if (stackSize == 0) {
+        loadBlock(m, block, blockLength);
+        std::memcpy(root, cv, sizeof(root));
+        flags = ChunkEnd | (blocksCompressed == 0 ? ChunkStart : 0);
+        length = static_cast<quint32>(blockLength);
+    } else {
+        quint32 right[8];
+        chunkChainingValue(right);
+        for (int i = stackSize - 1; i > 0; --i) {
+            quint32 left[8];
+            std::memcpy(left, stack[i], sizeof(left));
+            parentChainingValue(left, right, 0);
+            std::memcpy(right, left, sizeof(right));
+        }
+        std::memcpy(m, stack[0], 8 * sizeof(quint32));
+        std::memcpy(m + 8, right, 8 * sizeof(quint32));
+        std::memcpy(root, IV, sizeof(root));
+        flags = Parent;
+        length = BlockLength;
+    }
+
+    // The root output is counted in output blocks, not chunks
+    compress(root, m, length, 0, flags | Root);
+    for (int i = 0; i < 8; ++i) {
+        qToLittleEndian<quint32>(root[i], out + 4 * i);
+    }
+}
+
+/***************************************************************************************************
+* @description : This function hashes one buffer.
+* @param : const unsigned char *data, qint64 len, unsigned char *out
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void blake3Engine::hash(const unsigned char *data, qint64 len, unsigned char *out)
+{
+    hashState state;
+    state.update(data, len);
+    state.finalize(out);
+}
+
+/***************************************************************************************************
+* @description : This function checks the first 8 digest bytes against values from the reference
+*                implementation. Every input is also streamed in odd block sizes and split into
+*                power of two ranges that are hashed separately and appended.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool blake3Engine::selfTest()
+{
+    struct vector
+    {
+        qint64 length;
+        quint64 prefix;
+    };
+    static const vector Vectors[] = {
+        {      0, Q_UINT64_C(0xAF1349B9F5F9A1A6) },
+        {      1, Q_UINT64_C(0xCAEBFD3859F5380E) },
+        {     63, Q_UINT64_C(0xD71436598107F257) },
+        {     64, Q_UINT64_C(0x7B1409D32C8C4103) },
+        {     65, Q_UINT64_C(0x67A4C9B236C32203) },
+        {   1023, Q_UINT64_C(0xB21094E15D472D58) },
+        {   1024, Q_UINT64_C(0x19EC9C3CC6F9A190) },
+        {   1025, Q_UINT64_C(0x9FA29DF3FFBB36B2) },
+        {   2048, Q_UINT64_C(0x9594E0F4A5FB85F4) },
+        {   2049, Q_UINT64_C(0x24BEE2A41463A662) },
+        {   3072, Q_UINT64_C(0x4F45B5122FA4566E) },
+        {   4097, Q_UINT64_C(0x709476B889D8F557) },
+        {   8193, Q_UINT64_C(0x90F0B8D7B117C9E7) },
+        {  31744, Q_UINT64_C(0x259D5D8FB19F6497) },
+        { 131072, Q_UINT64_C(0xB45C3F544639220E) },
+        { 131075, Q_UINT64_C(0x4896375361B8F6BF) }
+    };
+    static const qint64 BlockSizes[] = { 1, 63, 64, 65, 1000, 1024, 4097 };
+    static const qint64 RangeSizes[] = { 1024, 4096, 32768 };
+
+    QByteArray buffer(131075, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < buffer.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = static_cast<char>(seed >> 24);
+    }
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(buffer.constData());
+
+    unsigned char out[OutLength];
+    for (const vector &v : Vectors) {
+        hash(data, v.length, out);
+        if (qFromBigEndian<quint64>(out) != v.prefix) return false;
+
+        for (qint64 blockSize : BlockSizes) {
+            hashState state;
+            for (qint64 done = 0; done < v.length; done += blockSize) {
+                state.update(data + done, qMin(blockSize, v.length - done));
+            }
+            state.finalize(out);
+            if (qFromBigEndian<quint64>(out) != v.prefix) return false;
+        }
+
+        for (qint64 rangeSize : RangeSizes) {
+            hashState state;
+            for (qint64 offset = 0; offset < v.length; offset += rangeSize) {
+                hashState range;
+                range.reset(static_cast<quint64>(offset));
+                range.update(data + offset, qMin(rangeSize, v.length - offset));
+                state.append(range);
+            }
+            state.finalize(out);
+            if (qFromBigEndian<quint64>(out) != v.prefix) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,464 @@
+#include "checksumDatabase.h"
+#include "crc32Engine.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+namespace {
+
+// First bytes of the journal, followed by the format version and a random journal id
+const QByteArray JournalMagic = "CrcChecksumCalculator-cache 1 ";
+// Pending records are written once this many have accumulated
+const int FlushThreshold = 256;
+// The journal is compacted when it holds more dead records than this and than live entries
+const int CompactThreshold = 4096;
+// How long to wait for another process holding the journal lock
+const int LockTimeoutMs = 10000;
+
+QByteArray newHeader()
+{
+    return JournalMagic + QByteArray::number(QRandomGenerator::global()->generate64(), 16) + '\n';
+}
+
+} // namespace
+
+/***************************************************************************************************
+* @description : This function returns the process wide database, stored as checksum-cache.db in
+*                the application's app-data directory.
+* @param : None
+* @return : checksumDatabase &
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+checksumDatabase &checksumDatabase::instance()
+{
+    static checksumDatabase database(
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/checksum-cache.db");
+    return database;
+}
+
+/***************************************************************************************************
+* @description : Constructor for checksumDatabase class. A missing journal is created on the
+*                first flush.
+* @param : const QString &journalPath
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+checksumDatabase::checksumDatabase(const QString &journalPath)
+    : path(journalPath)
+    , deadRecords(0)
+    , loadedOffset(0)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    load();
+}
+
+/***************************************************************************************************
+* @description : Destructor for checksumDatabase class.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+checksumDatabase::~checksumDatabase()
+{
+    flush();
+}
+
+/***************************************************************************************************
+* @description : This function looks up checksums of a file. The cached entry must have been
+*                recorded for the same path, size, modification time and inode.
+* @param : const fileIdentity &identity, const QVector<ChecksumType> &types, QHash<int, QString> *checksums
+* @return : bool - true if every requested type was found
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumDatabase::lookup(const fileIdentity &identity, const QVector<checksumEngine::ChecksumType> &types,
+                              QHash<int, QString> *checksums)
+{
+    QMutexLocker locker(&mutex);
+
+    auto it = entries.constFind(identity.path);
+    if (it == entries.constEnd() || it->identity != identity) return false;
+
+    QHash<int, QString> found;
+    for (checksumEngine::ChecksumType type : types) {
+        auto checksum = it->checksums.constFind(type);
+        if (checksum == it->checksums.constEnd()) return false;
+        found.insert(type, checksum.value());
+    }
+
+    *checksums = found;
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function records checksums of a file. Checksums of other types that are
+*                still valid for the same file state are kept. A full batch of pending records
+*                is written after the mutex is released.
+* @param : const fileIdentity &identity, const QHash<int, QString> &checksums
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumDatabase::store(const fileIdentity &identity, const QHash<int, QString> &checksums)
+{
+    QVector<entry> records;
+    {
+        QMutexLocker locker(&mutex);
+
+        auto it = entries.find(identity.path);
+        if (it == entries.end()) {
+            it = entries.insert(identity.path, entry());
+        } else {
+            ++deadRecords;
+        }
+
+        if (it->identity != identity) {
+            it->identity = identity;
+            it->checksums.clear();
+        }
+        for (auto checksum = checksums.constBegin(); checksum != checksums.constEnd(); ++checksum) {
+            it->checksums.insert(checksum.key(), checksum.value());
+        }
+
+        pending.append(*it);
+        if (pending.size() < FlushThreshold) return;
+        records.swap(pending);
+    }
+    appendRecords(records);
+}
+
+/***************************************************************************************************
+* @description : This function returns checksums of a file from the database when they are valid
+*                for its current state and hashes it otherwise. Fresh results are stored.
+* @param : const QString &filePath, const QVector<ChecksumType> &types, IoBackend backend, bool forceRehash
+* @return : QHash<int, QString>
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QHash<int, QString> checksumDatabase::checksums(const QString &filePath,
+                                                const QVector<checksumEngine::ChecksumType> &types,
+                                                checksumEngine::IoBackend backend, bool forceRehash)
+{
+    fileIdentity identity;
+    if (!fileIdentity::read(filePath, &identity)) identity.size = -1;
+
+    return checksums(identity, types, backend, forceRehash);
+}
+
+/***************************************************************************************************
+* @description : This function does the same for a file whose identity the caller already read,
+*                which saves a second stat when files are sorted by inode first.
+* @param : const fileIdentity &identity, const QVector<ChecksumType> &types, IoBackend backend,
+*          bool forceRehash
+* @return : QHash<int, QString>
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QHash<int, QString> checksumDatabase::checksums(const fileIdentity &identity,
+                                                const QVector<checksumEngine::ChecksumType> &types,
+                                                checksumEngine::IoBackend backend, bool forceRehash)
+{
+    bool known = identity.size >= 0;
+
+    QHash<int, QString> result;
+    if (known && !forceRehash && lookup(identity, types, &result)) return result;
+
+    result = checksumEngine::CalculateChecksums(identity.path, types, backend);
+    if (known && result.key("ERROR", -1) == -1) {
+        store(identity, result);
+    }
+    return result;
+}
+
+/***************************************************************************************************
+* @description : This function reads records other processes appended since the last load.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumDatabase::refresh()
+{
+    load();
+}
+
+/***************************************************************************************************
+* @description : This function writes pending records to the journal.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumDatabase::flush()
+{
+    QVector<entry> records;
+    {
+        QMutexLocker locker(&mutex);
+        records.swap(pending);
+    }
+    if (!records.isEmpty()) appendRecords(records);
+}
+
+/***************************************************************************************************
+* @description : This function returns the journal path.
+* @param : None
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString checksumDatabase::journalPath() const
+{
+    return path;
+}
+
+/***************************************************************************************************
+* @description : This function reads records appended since the previous load and merges them
+*                into the entries. The file is read without the mutex.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumDatabase::load()
+{
+    QMutexLocker writer(&journalMutex);
+
+    QVector<entry> records;
+    int corrupt = 0;
+    const bool replaced = readJournal(&records, &corrupt);
+
+    QMutexLocker locker(&mutex);
+    merge(records, corrupt, replaced, QVector<entry>());
+}
+
+/***************************************************************************************************
+* @description : This function reads the journal from where the previous read stopped. When the
+*                header changed the journal was compacted by someone else and is read from the
+*                start. A trailing line without newline is still being written and is left for
+*                the next read. Must be called with journalMutex held.
+* @param : QVector<entry> *records, int *corrupt
+* @return : bool - true if the journal was replaced and read from the start
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumDatabase::readJournal(QVector<entry> *records, int *corrupt)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QByteArray firstLine = file.readLine();
+    if (!firstLine.startsWith(JournalMagic) || !firstLine.endsWith('\n')) {
+        // Unknown or damaged journal, it is rewritten on the next flush
+        header.clear();
+        return false;
+    }
+
+    bool replaced = false;
+    if (firstLine != header || file.size() < loadedOffset) {
+        replaced = true;
+        header = firstLine;
+        loadedOffset = firstLine.size();
+    }
+
+    if (!file.seek(loadedOffset)) return replaced;
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (!line.endsWith('\n')) break;
+        loadedOffset += line.size();
+
+        entry record;
+        if (!parseRecord(line, &record)) {
+            ++*corrupt;
+            continue;
+        }
+        records->append(record);
+    }
+    return replaced;
+}
+
+/***************************************************************************************************
+* @description : This function merges records read from the journal into the entries instead of
+*                replacing them, so a journal compacted or truncated by another process does not
+*                lose what this process knows. Checksums of the same file state are combined.
+*                Entries this process has not written yet, pending or in the batch being
+*                written, are newer than the journal and win; otherwise the journal does. Must
+*                be called with the mutex held.
+* @param : const QVector<entry> &records, int corrupt, bool replaced, const QVector<entry> &writing
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumDatabase::merge(const QVector<entry> &records, int corrupt, bool replaced,
+                             const QVector<entry> &writing)
+{
+    QSet<QString> unwritten;
+    for (const entry &record : writing) unwritten.insert(record.identity.path);
+    for (const entry &record : qAsConst(pending)) unwritten.insert(record.identity.path);
+
+    // A replaced journal is counted from scratch
+    QSet<QString> seen;
+    if (replaced) deadRecords = 0;
+    deadRecords += corrupt;
+
+    for (const entry &record : records) {
+        const QString &filePath = record.identity.path;
+        if (replaced) {
+            if (seen.contains(filePath)) ++deadRecords;
+            seen.insert(filePath);
+        } else if (entries.contains(filePath)) {
+            ++deadRecords;
+        }
+
+        auto it = entries.find(filePath);
+        if (it == entries.end()) {
+            entries.insert(filePath, record);
+        } else if (it->identity == record.identity) {
+            for (auto checksum = record.checksums.constBegin(); checksum != record.checksums.constEnd(); ++checksum) {
+                if (!it->checksums.contains(checksum.key())) it->checksums.insert(checksum.key(), checksum.value());
+            }
+        } else if (!unwritten.contains(filePath)) {
+            *it = record;
+        }
+    }
+}
+
+/***************************************************************************************************
+* @description : This function parses one record: crc32, size, mtime, inode, digests and the
+*                percent encoded path, separated by tabs. The crc covers everything after the
+*                first tab.
+* @param : const QByteArray &line, entry *record
+* @return : bool - false if the line is damaged
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumDatabase::parseRecord(const QByteArray &line, entry *record) const
+{
+    int bodyStart = line.indexOf('\t');
+    if (bodyStart != 8) return false;
+
+    QByteArray body = line.mid(bodyStart + 1, line.size() - bodyStart - 2);
+    bool ok = false;
+    quint32 expectedCrc = line.left(8).toUInt(&ok, 16);
+    if (!ok) return false;
+    quint32 crc = crc32Engine::update(0, reinterpret_cast<const unsigned char *>(body.constData()), body.size());
+    if (crc != expectedCrc) return false;
+
+    QList<QByteArray> fields = body.split('\t');
+    if (fields.size() != 5) return false;
+
+    bool sizeOk = false, modifiedOk = false, inodeOk = false;
+    record->identity.size = fields.at(0).toLongLong(&sizeOk);
+    record->identity.modified = fields.at(1).toLongLong(&modifiedOk);
+    record->identity.inode = fields.at(2).toULongLong(&inodeOk);
+    if (!sizeOk || !modifiedOk || !inodeOk) return false;
+
+    const QList<QByteArray> digests = fields.at(3).split(',');
+    for (const QByteArray &digest : digests) {
+        int separator = digest.indexOf('=');
+        checksumEngine::ChecksumType type;
+        if (separator < 0 || !checksumEngine::typeFromName(QString::fromLatin1(digest.left(separator)), &type)) {
+            return false;
+        }
+        record->checksums.insert(type, QString::fromLatin1(digest.mid(separator + 1)));
+    }
+
+    record->identity.path = QString::fromUtf8(QByteArray::fromPercentEncoding(fields.at(4)));
+    return !record->identity.path.isEmpty();
+}
+
+/***************************************************************************************************
+* @description : This function formats one record line, see parseRecord for the layout.
+* @param : const entry &record
+* @return : QByteArray
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QByteArray checksumDatabase::formatRecord(const entry &record) const
+{
+    QByteArray digests;
+    for (auto it = record.checksums.constBegin(); it != record.checksums.constEnd(); ++it) {
+        if (!digests.isEmpty()) digests += ',';
+        digests += checksumEngine::typeName(static_cast<checksumEngine::ChecksumType>(it.key())).toLatin1();
+        digests += '=';
+        digests += it.value().toLatin1();
+    }
+
+    QByteArray body = QByteArray::number(record.identity.size) + '\t'
+                    + QByteArray::number(record.identity.modified) + '\t'
+                    + QByteArray::number(record.identity.inode) + '\t'
+                    + digests + '\t'
+                    + record.identity.path.toUtf8().toPercentEncoding("/\\:. ");
+
+    quint32 crc = crc32Engine::update(0, reinterpret_cast<const unsigned char *>(body.constData()), body.size());
+    return QByteArray::number(crc, 16).rightJustified(8, '0') + '\t' + body + '\n';
+}
+
+/***************************************************************************************************
+* @description : This function rewrites the journal with one record per live entry under a new
+*                header, so other processes notice and reload. The entries are a snapshot taken
+*                under the mutex, records stored since then are still pending. Must be called
+*                with journalMutex and the lock file held.
+* @param : const QHash<QString, entry> &live
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumDatabase::compact(const QHash<QString, entry> &live)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return;
+
+    QByteArray newJournalHeader = newHeader();
+    file.write(newJournalHeader);
+    for (auto it = live.constBegin(); it != live.constEnd(); ++it) {
+        file.write(formatRecord(it.value()));
+    }
+    if (!file.commit()) return;
+
+    header = newJournalHeader;
+    loadedOffset = QFileInfo(path).size();
+
+    QMutexLocker locker(&mutex);
+    deadRecords = 0;
+}
+
+/***************************************************************************************************
+* @description : This function appends records to the journal while holding the lock file. Records
+*                of other processes are read first so loadedOffset stays in step with the file. A
+*                missing or damaged journal, or one mostly made of dead records, is compacted
+*                instead, which also writes these records. Waiting for the lock file and the
+*                file I/O happen without the mutex, so lookups and stores go on meanwhile. The
+*                cache is best effort: if the lock cannot be taken the records are dropped. Must
+*                be called without the mutex held.
+* @param : const QVector<entry> &records
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumDatabase::appendRecords(const QVector<entry> &records)
+{
+    QByteArray data;
+    for (const entry &record : records) data += formatRecord(record);
+
+    QMutexLocker writer(&journalMutex);
+    QLockFile lock(path + ".lock");
+    if (!lock.tryLock(LockTimeoutMs)) return;
+
+    QVector<entry> loaded;
+    int corrupt = 0;
+    const bool replaced = readJournal(&loaded, &corrupt);
+
+    bool compactJournal;
+    QHash<QString, entry> live;
+    {
+        QMutexLocker locker(&mutex);
+        merge(loaded, corrupt, replaced, records);
+        compactJournal = header.isEmpty() || (deadRecords > CompactThreshold && deadRecords > entries.size());
+        if (compactJournal) live = entries;
+    }
+    if (compactJournal) {
+        compact(live);
+        return;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) return;
+    if (file.write(data) == data.size()) {
+        loadedOffset = file.size();
+    }
+}
@@ -0,0 +1,879 @@
+#include "checksumEngine.h"
+#include "crc16Engine.h"
+#include "crc32Engine.h"
+#include "crc32cEngine.h"
+#include "crc64Engine.h"
+#include "hashStatistics.h"
+#include "readAheadReader.h"
+#include "systemTopology.h"
+
+#include <QFileInfo>
+#include <QMutex>
+#include <QStorageInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QAtomicInt>
+
+#include <functional>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <csetjmp>
+#include <csignal>
+#include <cstring>
+#endif
+
+namespace {
+
+#ifdef Q_OS_UNIX
+
+// Where a thread's mapped loop continues when a page of its mapping is gone, nullptr while the
+// thread is not reading a mapping. Volatile so the stores around the kernels are not dropped.
+thread_local sigjmp_buf *volatile mappedFaultTarget = nullptr;
+// SIGBUS handler that was installed before ours
+struct sigaction previousBusAction;
+
+// A file that shrinks while it is mapped raises SIGBUS when the missing pages are touched.
+// Faults of a mapped loop return to it, every other SIGBUS goes where it went before.
+void onBusError(int signalNumber, siginfo_t *info, void *context)
+{
+    if (mappedFaultTarget) siglongjmp(*mappedFaultTarget, 1);
+
+    if (previousBusAction.sa_flags & SA_SIGINFO) {
+        previousBusAction.sa_sigaction(signalNumber, info, context);
+    } else if (previousBusAction.sa_handler != SIG_IGN && previousBusAction.sa_handler != SIG_DFL) {
+        previousBusAction.sa_handler(signalNumber);
+    } else {
+        signal(SIGBUS, SIG_DFL);
+        raise(SIGBUS);
+    }
+}
+
+// Installs onBusError once per process, false if that failed
+bool installBusHandler()
+{
+    static const bool installed = []() {
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_sigaction = onBusError;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        return sigaction(SIGBUS, &action, &previousBusAction) == 0;
+    }();
+    return installed;
+}
+
+#endif // Q_OS_UNIX
+
+// Threads that hash the ranges of one large file. Separate from the pools that hash whole
+// files, whose threads block while their ranges are running.
+class rangePoolHolder
+{
+public:
+    rangePoolHolder()
+    {
+        pool.setMaxThreadCount(QThread::idealThreadCount());
+    }
+    QThreadPool pool;
+};
+Q_GLOBAL_STATIC(rangePoolHolder, rangePool)
+
+// Runs one range and signals its completion
+class rangeJob : public QRunnable
+{
+public:
+    rangeJob(const std::function<void()> &work, QSemaphore *done)
+        : work(work)
+        , done(done)
+        , node(systemTopology::threadNode())
+    {
+    }
+
+    void run() override
+    {
+        // Ranges run on the node of the thread that split the file
+        systemTopology::pinThread(node);
+        work();
+        done->release();
+    }
+
+private:
+    std::function<void()> work;
+    QSemaphore *done;
+    int node;
+};
+
+// Measures consecutive blocks of one thread for hashStatistics, a disabled timer reads no clocks
+class blockTimer
+{
+public:
+    explicit blockTimer(bool enabled = true)
+        : enabled(enabled)
+        , wallStart(enabled ? hashStatistics::wallNs() : 0)
+        , cpuStart(enabled ? hashStatistics::threadCpuNs() : 0)
+    {
+    }
+
+    // Reports the block that ended now and starts the next one
+    void finish(const QString &filePath, qint64 bytes)
+    {
+        if (!enabled) return;
+        const qint64 wall = hashStatistics::wallNs();
+        const qint64 cpu = hashStatistics::threadCpuNs();
+        hashStatistics::instance().addBlock(filePath, bytes, wall - wallStart, cpu - cpuStart);
+        wallStart = wall;
+        cpuStart = cpu;
+    }
+
+private:
+    bool enabled;
+    qint64 wallStart;
+    qint64 cpuStart;
+};
+
+// Registers a file with hashStatistics while it is being hashed, an empty path registers nothing
+class fileRecording
+{
+public:
+    fileRecording(const QString &filePath, qint64 size)
+        : filePath(filePath)
+    {
+        if (!filePath.isEmpty()) hashStatistics::instance().fileStarted(filePath, size);
+    }
+
+    ~fileRecording()
+    {
+        if (!filePath.isEmpty()) hashStatistics::instance().fileFinished(filePath, ok);
+    }
+
+    bool ok = false;
+
+private:
+    QString filePath;
+};
+
+} // namespace
+
+/***************************************************************************************************
+ *	@description	:   This function will calculate CRC checksum for given file. Regular files on
+ *	                    local disk are hashed straight from a memory mapped view when the MappedIo
+ *	                    backend is selected; pipes, special files, network shares and mapping
+ *	                    failures fall back to reads that run ahead of the hashing in a small ring
+ *	                    of reusable buffers. Either way memory use does not grow with file size.
+ *	@param			:   const QString &filePath, ChecksumType type, IoBackend backend
+ *	@return			:   QString
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+QString checksumEngine::CalculateChecksum(const QString &filePath, ChecksumType type, IoBackend backend)
+{
+    return CalculateChecksums(filePath, QVector<ChecksumType>() << type, backend).value(type);
+}
+
+/***************************************************************************************************
+ *	@description	:   This function will calculate several checksums for given file in a single
+ *	                    pass over its contents. Every requested type maps to "ERROR" when the
+ *	                    file cannot be read.
+ *	@param			:   const QString &filePath, const QVector<ChecksumType> &types, IoBackend backend
+ *	@return			:   QHash<int, QString>
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+QHash<int, QString> checksumEngine::CalculateChecksums(const QString &filePath, const QVector<ChecksumType> &types,
+                                                     IoBackend backend)
+{
+    QHash<int, QString> errors;
+    for (ChecksumType type : types) {
+        errors.insert(type, "ERROR");
+    }
+
+    // Unbuffered: every read goes straight into our buffer, QIODevice would copy small reads
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) return errors;
+
+    // Only files worth watching take the statistics lock, small ones just add to the totals
+    const qint64 size = file.size();
+    const bool smallFile = size <= SmallFileSize && !file.isSequential();
+    fileRecording recording(!smallFile || hashStatistics::instance().logsFiles() ? filePath : QString(), size);
+
+    if (smallFile) {
+        QHash<int, QString> checksums = hashSmallFile(file, types, &recording.ok);
+        return recording.ok ? checksums : errors;
+    }
+
+    checksumState state(types);
+
+    if (size >= ParallelMinimumSize && canHashInParallel(types) && isLocalFile(file)) {
+        file.close();
+        if (!hashParallel(filePath, size, types, backend, state)) return errors;
+        recording.ok = true;
+        return state.results();
+    }
+
+    qint64 consumed = 0;
+    if (backend == MappedIo && canMapFile(file)) {
+        consumed = hashMapped(file, 0, size, state);
+        if (consumed < 0) return errors;
+    }
+    if (!hashBuffered(file, consumed, -1, state)) return errors;
+
+    file.close();
+
+    recording.ok = true;
+    return state.results();
+}
+
+/***************************************************************************************************
+ *	@description	:   This function hashes the first and last sampleSize bytes of a file into
+ *	                    the thread's small file buffer with two reads. Files up to twice that
+ *	                    size are hashed completely.
+ *	@param			:   const QString &filePath, qint64 sampleSize
+ *	@return			:   QString - 16 hex digits, or "ERROR"
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+QString checksumEngine::CalculateSampleChecksum(const QString &filePath, qint64 sampleSize)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered) || file.isSequential()) return "ERROR";
+
+    sampleSize = qMin(sampleSize, SmallFileSize / 2);
+    const qint64 size = file.size();
+    const qint64 headLength = qMin(size, sampleSize);
+    const qint64 tailOffset = qMax(headLength, size - sampleSize);
+
+    QByteArray &buffer = threadBuffer();
+    auto readFully = [&file, &buffer](qint64 bufferOffset, qint64 length) {
+        while (length > 0) {
+            qint64 bytesRead = file.read(buffer.data() + bufferOffset, length);
+            if (bytesRead <= 0) return false;
+            bufferOffset += bytesRead;
+            length -= bytesRead;
+        }
+        return true;
+    };
+
+    if (!readFully(0, headLength)) return "ERROR";
+    if (tailOffset < size && (!file.seek(tailOffset) || !readFully(headLength, size - tailOffset))) return "ERROR";
+
+    const quint64 sample = xxh3Engine::hash64(reinterpret_cast<const unsigned char *>(buffer.constData()),
+                                              headLength + size - tailOffset);
+    return QString("%1").arg(sample, 16, 16, QChar('0')).toUpper();
+}
+
+/***************************************************************************************************
+ *	@description	:   This function returns every supported checksum type.
+ *	@param			:   None
+ *	@return			:   QVector<ChecksumType>
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+QVector<checksumEngine::ChecksumType> checksumEngine::allChecksumTypes()
+{
+    return QVector<ChecksumType>() << CRC16 << CRC32 << MD5 << SHA1 << SHA256 << CRC32C << CRC64
+                                   << XXH3_64 << XXH3_128 << BLAKE3;
+}
+
+/***************************************************************************************************
+ *	@description	:   This function returns the small file buffer of the calling thread,
+ *	                    SmallFileSize bytes allocated once per thread. Allocating a fresh buffer
+ *	                    per file costs an allocation and page faults on every small file.
+ *	@param			:   None
+ *	@return			:   QByteArray &
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+QByteArray &checksumEngine::threadBuffer()
+{
+    thread_local QByteArray buffer(static_cast<int>(SmallFileSize), Qt::Uninitialized);
+    return buffer;
+}
+
+/***************************************************************************************************
+ *	@description	:   This function hashes a small file with state kept per thread: the file is
+ *	                    read with as few calls as possible into the thread's buffer and fed to
+ *	                    contexts that are reset instead of created. A file that grew past
+ *	                    SmallFileSize since it was opened is streamed to its end. Unless the per
+ *	                    file log is open the file is only added to the statistics totals, without
+ *	                    reading the thread CPU clock.
+ *	@param			:   QFile &file, const QVector<ChecksumType> &types, bool *ok
+ *	@return			:   QHash<int, QString>
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+QHash<int, QString> checksumEngine::hashSmallFile(QFile &file, const QVector<ChecksumType> &types, bool *ok)
+{
+    thread_local checksumState state(types);
+    state.reset(types);
+
+    const bool logged = hashStatistics::instance().logsFiles();
+    blockTimer timer(logged);
+    QByteArray &buffer = threadBuffer();
+    qint64 total = 0;
+    while (total < SmallFileSize) {
+        qint64 bytesRead = file.read(buffer.data() + total, SmallFileSize - total);
+        if (bytesRead < 0) {
+            *ok = false;
+            return QHash<int, QString>();
+        }
+        if (bytesRead == 0) break;
+        total += bytesRead;
+    }
+    state.addData(reinterpret_cast<const unsigned char *>(buffer.constData()), total);
+    if (logged) {
+        timer.finish(file.fileName(), total);
+    } else {
+        hashStatistics::instance().addSmallFile(total);
+    }
+
+    *ok = total < SmallFileSize || hashBuffered(file, total, -1, state);
+    return *ok ? state.results() : QHash<int, QString>();
+}
+
+/***************************************************************************************************
+ *	@description	:   This function checks whether a file is a plain file on a local disk. Pipes
+ *	                    and special files cannot be mapped or read at random offsets, network
+ *	                    shares may change under a mapping and gain nothing from parallel reads. The
+ *	                    answer is looked up once per device.
+ *	@param			:   QFile &file
+ *	@return			:   bool
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+bool checksumEngine::isLocalFile(QFile &file)
+{
+    if (file.isSequential()) return false;
+
+    // QStorageInfo reads the whole mount table, so its answer is kept per device, or per
+    // directory where there are no device numbers
+    QString key;
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (fstat(file.handle(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    key = QString::number(quint64(st.st_dev));
+#else
+    QFileInfo fi(file);
+    if (!fi.isFile()) return false;
+    key = fi.absolutePath();
+#endif
+
+    static QMutex cacheMutex;
+    static QHash<QString, bool> localDevices;
+    {
+        QMutexLocker locker(&cacheMutex);
+        const auto known = localDevices.constFind(key);
+        if (known != localDevices.constEnd()) return known.value();
+    }
+
+    static const QList<QByteArray> remoteFileSystems = {
+        "nfs", "nfs4", "cifs", "smbfs", "smb3", "fuse.sshfs", "9p", "afs"
+    };
+    const bool local = !remoteFileSystems.contains(QStorageInfo(QFileInfo(file).absolutePath()).fileSystemType());
+
+    QMutexLocker locker(&cacheMutex);
+    localDevices.insert(key, local);
+    return local;
+}
+
+/***************************************************************************************************
+ *	@description	:   This function decides whether a file may be hashed through a mapping. Small
+ *	                    files are cheaper to read.
+ *	@param			:   QFile &file
+ *	@return			:   bool
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+bool checksumEngine::canMapFile(QFile &file)
+{
+    return file.size() >= MapMinimumSize && isLocalFile(file);
+}
+
+/***************************************************************************************************
+ *	@description	:   This function checks whether every requested type is a CRC or BLAKE3.
+ *	                    CRCs of adjacent ranges can be combined and BLAKE3 is a tree of chunks,
+ *	                    MD5, SHA and XXH3 run strictly front to back.
+ *	@param			:   const QVector<ChecksumType> &types
+ *	@return			:   bool
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+bool checksumEngine::canHashInParallel(const QVector<ChecksumType> &types)
+{
+    for (ChecksumType type : types) {
+        if (type != CRC16 && type != CRC32 && type != CRC32C && type != CRC64 && type != BLAKE3) return false;
+    }
+    return !types.isEmpty();
+}
+
+/***************************************************************************************************
+ *	@description	:   This function splits a file into one range per thread, at least
+ *	                    ParallelRangeSize each, and hashes them concurrently through separate file
+ *	                    handles. The calling thread takes the first range. The range states are
+ *	                    then combined in file order, so the result equals a front to back pass.
+ *	                    BLAKE3 ranges must be whole subtrees, so their length is rounded down to a
+ *	                    power of two; there may be more ranges than threads then.
+ *	@param			:   const QString &filePath, qint64 size, const QVector<ChecksumType> &types,
+ *	                    IoBackend backend, checksumState &state
+ *	@return			:   bool - false if any range could not be read
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+bool checksumEngine::hashParallel(const QString &filePath, qint64 size, const QVector<ChecksumType> &types,
+                                  IoBackend backend, checksumState &state)
+{
+    QThreadPool *pool = &rangePool()->pool;
+
+    qint64 rangeCount = size / ParallelRangeSize;
+    if (rangeCount > pool->maxThreadCount()) rangeCount = pool->maxThreadCount();
+    if (rangeCount < 2) {
+        return hashRange(filePath, 0, size, backend, state);
+    }
+
+    // 64 KiB aligned range boundaries keep every mapping window on a page (and Windows
+    // allocation granularity) boundary
+    qint64 rangeLength = (size / rangeCount + 0xFFFF) & ~qint64(0xFFFF);
+    if (types.contains(BLAKE3)) {
+        qint64 power = blake3Engine::ChunkLength;
+        while (power * 2 <= rangeLength) power *= 2;
+        rangeLength = power;
+    }
+
+    QVector<QSharedPointer<checksumState>> ranges;
+    QVector<qint64> lengths;
+    for (qint64 offset = 0; offset < size; offset += rangeLength) {
+        ranges.append(QSharedPointer<checksumState>::create(types));
+        ranges.last()->startAt(offset);
+        lengths.append(qMin(rangeLength, size - offset));
+    }
+
+    QSemaphore done;
+    QAtomicInt failed(0);
+    for (int i = 1; i < ranges.size(); ++i) {
+        checksumState *range = ranges.at(i).data();
+        qint64 offset = i * rangeLength;
+        qint64 length = lengths.at(i);
+        pool->start(new rangeJob([=, &failed]() {
+            if (!hashRange(filePath, offset, length, backend, *range)) failed.fetchAndStoreOrdered(1);
+        }, &done));
+    }
+
+    if (!hashRange(filePath, 0, lengths.first(), backend, *ranges.first())) failed.fetchAndStoreOrdered(1);
+    done.acquire(ranges.size() - 1);
+
+    if (failed.loadAcquire()) return false;
+
+    for (int i = 0; i < ranges.size(); ++i) {
+        state.combine(*ranges.at(i), lengths.at(i));
+    }
+    return true;
+}
+
+/***************************************************************************************************
+ *	@description	:   This function hashes one range of a file through its own handle, mapped
+ *	                    when the backend and the range size allow it.
+ *	@param			:   const QString &filePath, qint64 offset, qint64 length, IoBackend backend,
+ *	                    checksumState &state
+ *	@return			:   bool - false if the range could not be read completely
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+bool checksumEngine::hashRange(const QString &filePath, qint64 offset, qint64 length, IoBackend backend,
+                               checksumState &state)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) return false;
+
+    const qint64 end = offset + length;
+    if (backend == MappedIo && length >= MapMinimumSize) {
+        offset = hashMapped(file, offset, end, state);
+        if (offset < 0) return false;
+    }
+    return hashBuffered(file, offset, end, state);
+}
+
+/***************************************************************************************************
+ *	@description	:   This function hashes the bytes [offset, end) through MapWindowSize mappings
+ *	                    with a sequential access hint. It stops early when a window cannot be
+ *	                    mapped so the caller can read the rest. On Unix a file that shrinks while
+ *	                    mapped raises SIGBUS on the missing pages; that is caught and the file fails,
+ *	                    the partly fed state cannot be continued by reads.
+ *	@param			:   QFile &file, qint64 offset, qint64 end, checksumState &state
+ *	@return			:   qint64 - offset reached, -1 if the file shrank under the mapping
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+qint64 checksumEngine::hashMapped(QFile &file, qint64 offset, qint64 end, checksumState &state)
+{
+    const QString filePath = file.fileName();
+    blockTimer timer;
+#ifdef Q_OS_UNIX
+    // Without the handler a truncated file would take the process down
+    if (!installBusHandler()) return offset;
+#endif
+
+    while (offset < end) {
+        qint64 length = end - offset;
+        if (length > MapWindowSize) length = MapWindowSize;
+        uchar *view = file.map(offset, length);
+        if (!view) break;
+
+#ifdef Q_OS_UNIX
+        static const quintptr pageSize = static_cast<quintptr>(sysconf(_SC_PAGESIZE));
+        quintptr pageStart = reinterpret_cast<quintptr>(view) & ~(pageSize - 1);
+        madvise(reinterpret_cast<void *>(pageStart),
+                static_cast<size_t>(reinterpret_cast<quintptr>(view) + length - pageStart),
+                MADV_SEQUENTIAL);
+#endif
+
+#ifdef Q_OS_UNIX
+        sigjmp_buf faultTarget;
+        if (sigsetjmp(faultTarget, 1) != 0) {
+            mappedFaultTarget = nullptr;
+            file.unmap(view);
+            return -1;
+        }
+#endif
+
+        // Hashed in ChunkSize blocks so progress and I/O wait are sampled as finely as for reads
+        for (qint64 done = 0; done < length; done += ChunkSize) {
+            const qint64 block = qMin<qint64>(ChunkSize, length - done);
+#ifdef Q_OS_UNIX
+            // Only the kernels touch the mapping, the timer takes locks and must not be left
+            // by a jump
+            mappedFaultTarget = &faultTarget;
+            state.addData(view + done, block);
+            mappedFaultTarget = nullptr;
+#else
+            state.addData(view + done, block);
+#endif
+            timer.finish(filePath, block);
+        }
+        file.unmap(view);
+        offset += length;
+    }
+
+    return offset;
+}
+
+/***************************************************************************************************
+ *	@description	:   This function hashes the bytes [offset, end) with reads kept in flight by
+ *	                    a readAheadReader, so the next blocks arrive while the current one is
+ *	                    hashed. Blocks are hashed in place in the reader's buffers. A negative end
+ *	                    reads to the end of the file, a bounded range fails if the file ends early.
+ *	@param			:   QFile &file, qint64 offset, qint64 end, checksumState &state
+ *	@return			:   bool - false on read errors
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+bool checksumEngine::hashBuffered(QFile &file, qint64 offset, qint64 end, checksumState &state)
+{
+    if (end >= 0 && offset >= end) return true;
+    if (offset > 0 && !file.seek(offset)) return false;
+
+#ifdef Q_OS_LINUX
+    if (!file.isSequential()) {
+        posix_fadvise(file.handle(), offset, end >= 0 ? end - offset : 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    const QString filePath = file.fileName();
+    blockTimer timer;
+    readAheadReader reader(file, offset, end);
+
+    // The wait inside next() is what the timer reports as I/O wait
+    const unsigned char *block = nullptr;
+    qint64 length = 0;
+    while (reader.next(&block, &length)) {
+        state.addData(block, length);
+        timer.finish(filePath, length);
+    }
+    return !reader.failed();
+}
+
+/***************************************************************************************************
+* @description : Constructor for the running state of the requested checksums.
+* @param : const QVector<ChecksumType> &types
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+checksumEngine::checksumState::checksumState(const QVector<ChecksumType> &types)
+    : types(types)
+    , crc16(0)
+    , crc32(0)
+    , crc32c(0)
+    , crc64(0)
+    , md5(QCryptographicHash::Md5)
+    , sha1(QCryptographicHash::Sha1)
+    , sha256(QCryptographicHash::Sha256)
+{
+}
+
+/***************************************************************************************************
+* @description : This function clears the running checksums for another file. The hash contexts
+*                are reset in place rather than created again.
+* @param : const QVector<ChecksumType> &types
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumEngine::checksumState::reset(const QVector<ChecksumType> &types)
+{
+    this->types = types;
+    crc16 = 0;
+    crc32 = 0;
+    crc32c = 0;
+    crc64 = 0;
+    md5.reset();
+    sha1.reset();
+    sha256.reset();
+    xxh3.reset();
+    blake3.reset();
+}
+
+/***************************************************************************************************
+* @description : This function sets the file offset of the data fed next. Only BLAKE3 depends on
+*                it, its chunks are numbered by position in the file.
+* @param : qint64 offset
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumEngine::checksumState::startAt(qint64 offset)
+{
+    blake3.reset(static_cast<quint64>(offset));
+}
+
+/***************************************************************************************************
+* @description : This function feeds one block of the file into every requested checksum. With
+*                more than one checksum the block is handed out in multiDigestSliceSize() slices
+*                so each algorithm finds the data still in cache.
+* @param : const unsigned char *data, qint64 len
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumEngine::checksumState::addData(const unsigned char *data, qint64 len)
+{
+    if (types.size() == 1) {
+        addData(types.first(), data, len);
+        return;
+    }
+
+    const qint64 sliceSize = multiDigestSliceSize();
+    while (len > 0) {
+        qint64 slice = len < sliceSize ? len : sliceSize;
+        for (ChecksumType type : qAsConst(types)) {
+            addData(type, data, slice);
+        }
+        data += slice;
+        len -= slice;
+    }
+}
+
+/***************************************************************************************************
+* @description : This function feeds one block of the file into a single checksum.
+* @param : ChecksumType type, const unsigned char *data, qint64 len
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumEngine::checksumState::addData(ChecksumType type, const unsigned char *data, qint64 len)
+{
+    switch(type) {
+        case CRC16:
+            crc16 = computeCrc(crc16, data, len);
+            break;
+        case CRC32:
+            crc32 = computeCrc32(crc32, data, len);
+            break;
+        case MD5:
+            md5.addData(reinterpret_cast<const char *>(data), static_cast<int>(len));
+            break;
+        case SHA1:
+            sha1.addData(reinterpret_cast<const char *>(data), static_cast<int>(len));
+            break;
+        case SHA256:
+            sha256.addData(reinterpret_cast<const char *>(data), static_cast<int>(len));
+            break;
+        case CRC32C:
+            crc32c = crc32cEngine::update(crc32c, data, len);
+            break;
+        case CRC64:
+            crc64 = crc64Engine::update(crc64, data, len);
+            break;
+        case XXH3_64:
+            xxh3.update(data, len);
+            break;
+        case XXH3_128:
+            if (!types.contains(XXH3_64)) xxh3.update(data, len);
+            break;
+        case BLAKE3:
+            blake3.update(data, len);
+            break;
+    }
+}
+
+/***************************************************************************************************
+* @description : This function formats the finished checksums as upper case hex.
+* @param : None
+* @return : QHash<int, QString>
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QHash<int, QString> checksumEngine::checksumState::results() const
+{
+    QHash<int, QString> checksums;
+    for (ChecksumType type : types) {
+        switch(type) {
+            case CRC16:
+                checksums.insert(type, QString("%1").arg(crc16, 4, 16, QChar('0')).toUpper());
+                break;
+            case CRC32:
+                checksums.insert(type, QString("%1").arg(crc32, 8, 16, QChar('0')).toUpper());
+                break;
+            case MD5:
+                checksums.insert(type, md5.result().toHex().toUpper());
+                break;
+            case SHA1:
+                checksums.insert(type, sha1.result().toHex().toUpper());
+                break;
+            case SHA256:
+                checksums.insert(type, sha256.result().toHex().toUpper());
+                break;
+            case CRC32C:
+                checksums.insert(type, QString("%1").arg(crc32c, 8, 16, QChar('0')).toUpper());
+                break;
+            case CRC64:
+                checksums.insert(type, QString("%1").arg(crc64, 16, 16, QChar('0')).toUpper());
+                break;
+            case XXH3_64:
+                checksums.insert(type, QString("%1").arg(xxh3.digest64(), 16, 16, QChar('0')).toUpper());
+                break;
+            case XXH3_128: {
+                xxh3Engine::value128 value = xxh3.digest128();
+                checksums.insert(type, QString("%1%2").arg(value.high, 16, 16, QChar('0'))
+                                                      .arg(value.low, 16, 16, QChar('0')).toUpper());
+                break;
+            }
+            case BLAKE3: {
+                QByteArray digest(blake3Engine::OutLength, Qt::Uninitialized);
+                blake3.finalize(reinterpret_cast<unsigned char *>(digest.data()));
+                checksums.insert(type, digest.toHex().toUpper());
+                break;
+            }
+        }
+    }
+    return checksums;
+}
+
+/***************************************************************************************************
+* @description : This function appends the state of the len bytes that directly follow the ones
+*                hashed so far. Only CRC types and BLAKE3 can be combined, see canHashInParallel().
+* @param : const checksumState &next, qint64 len
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumEngine::checksumState::combine(const checksumState &next, qint64 len)
+{
+    crc16 = crc16Engine::combine(crc16, next.crc16, len);
+    crc32 = crc32Engine::combine(crc32, next.crc32, len);
+    crc32c = crc32cEngine::combine(crc32c, next.crc32c, len);
+    crc64 = crc64Engine::combine(crc64, next.crc64, len);
+    blake3.append(next.blake3);
+}
+
+/***************************************************************************************************
+ *	@description	:   This function returns the lower case name of a checksum type as used on the
+ *	                    command line, e.g. "sha256".
+ *	@param			:   ChecksumType type
+ *	@return			:   QString
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+QString checksumEngine::typeName(ChecksumType type)
+{
+    switch(type) {
+        case CRC16:  return "crc16";
+        case CRC32:  return "crc32";
+        case MD5:    return "md5";
+        case SHA1:   return "sha1";
+        case SHA256: return "sha256";
+        case CRC32C: return "crc32c";
+        case CRC64:  return "crc64";
+        case XXH3_64:  return "xxh3";
+        case XXH3_128: return "xxh128";
+        case BLAKE3: return "blake3";
+    }
+    return QString();
+}
+
+/***************************************************************************************************
+ *	@description	:   This function returns the number of hex digits of a checksum type's result.
+ *	@param			:   ChecksumType type
+ *	@return			:   int
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+int checksumEngine::digestLength(ChecksumType type)
+{
+    switch(type) {
+        case CRC16:    return 4;
+        case CRC32:    return 8;
+        case CRC32C:   return 8;
+        case CRC64:    return 16;
+        case XXH3_64:  return 16;
+        case MD5:      return 32;
+        case XXH3_128: return 32;
+        case SHA1:     return 40;
+        case SHA256:   return 64;
+        case BLAKE3:   return 2 * blake3Engine::OutLength;
+    }
+    return 0;
+}
+
+/***************************************************************************************************
+ *	@description	:   This function returns the slice each algorithm gets in turn when several
+ *	                    run at once. Half of the core's L2 cache leaves room for the algorithms'
+ *	                    own state, rounded down to 64 KiB.
+ *	@param			:   None
+ *	@return			:   qint64
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+qint64 checksumEngine::multiDigestSliceSize()
+{
+    static const qint64 sliceSize = qBound(qint64(64 * 1024), (systemTopology::l2CacheSize() / 2) & ~qint64(0xFFFF),
+                                           qint64(1024 * 1024));
+    return sliceSize;
+}
+
+/***************************************************************************************************
+ *	@description	:   This function parses a checksum type name, case insensitive. "crc-32" and
+ *	                    "sha-256" style names are accepted too, as are the xxhsum tags "xxh3"
+ *	                    and "xxh128".
+ *	@param			:   const QString &name, ChecksumType *type
+ *	@return			:   bool - false if the name is unknown
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+bool checksumEngine::typeFromName(const QString &name, ChecksumType *type)
+{
+    QString normalized = name.toLower().remove('-');
+    for (ChecksumType candidate : allChecksumTypes()) {
+        if (typeName(candidate) == normalized) {
+            *type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/***************************************************************************************************
+* @description : This function will compute CRC32 value. Pass 0 as crc for the first block and
+*                the previous return value for every following block.
+* @param : unsigned int crc, const unsigned char *data, qint64 len
+* @return : unsigned int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+unsigned int checksumEngine::computeCrc32(unsigned int crc, const unsigned char *data, qint64 len)
+{
+    // Standard CRC-32 polynomial 0xEDB88320, PCLMULQDQ or slicing-by-16 depending on the CPU
+    return crc32Engine::update(crc, data, len);
+}
+
+/***************************************************************************************************
+ *	@description	:   This function will compute CRC value. Pass 0 as crc for the first block
+ *	                    and the previous return value for every following block.
+ *	@param			:   unsigned short crc, const unsigned char *message, qint64 blk_len
+ *	@return			:   unsigned short
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+unsigned short checksumEngine::computeCrc(unsigned short crc, const unsigned char *message, qint64 blk_len)
+{
+    // Polynomial 0x8005, slicing-by-8 tables generated at compile time
+    return crc16Engine::update(crc, message, blk_len);
+}
@@ -0,0 +1,101 @@
+#include "checksumHasher.h"
+
+/***************************************************************************************************
+* @description : Constructor for checksumHasher class.
+* @param : ChecksumType type
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+checksumHasher::checksumHasher(checksumEngine::ChecksumType type)
+    : hashType(type)
+    , state(QVector<checksumEngine::ChecksumType>() << type)
+{
+}
+
+/***************************************************************************************************
+* @description : This function returns the checksum type of the hasher.
+* @param : None
+* @return : ChecksumType
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+checksumEngine::ChecksumType checksumHasher::type() const
+{
+    return hashType;
+}
+
+/***************************************************************************************************
+* @description : This function starts a new message. The contexts are reset in place, so a
+*                hasher reused for many messages allocates nothing.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasher::init()
+{
+    state.reset(QVector<checksumEngine::ChecksumType>() << hashType);
+}
+
+/***************************************************************************************************
+* @description : This function feeds bytes straight from the caller's buffer. Large buffers are
+*                passed on in ChunkSize pieces, the QCryptographicHash contexts take int lengths.
+* @param : byteSpan data
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasher::update(byteSpan data)
+{
+    const unsigned char *bytes = data.data();
+    qint64 remaining = data.size();
+    while (remaining > 0) {
+        const qint64 length = qMin(remaining, qint64(checksumEngine::ChunkSize));
+        state.addData(bytes, length);
+        bytes += length;
+        remaining -= length;
+    }
+}
+
+/***************************************************************************************************
+* @description : This function returns the digest of the message fed so far.
+* @param : None
+* @return : QByteArray
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QByteArray checksumHasher::final() const
+{
+    return QByteArray::fromHex(finalHex().toLatin1());
+}
+
+/***************************************************************************************************
+* @description : This function returns the digest of the message fed so far as upper case hex.
+* @param : None
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString checksumHasher::finalHex() const
+{
+    return state.results().value(hashType);
+}
+
+/***************************************************************************************************
+* @description : This function hashes one buffer.
+* @param : ChecksumType type, byteSpan data
+* @return : QByteArray
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QByteArray checksumHasher::hash(checksumEngine::ChecksumType type, byteSpan data)
+{
+    checksumHasher hasher(type);
+    hasher.update(data);
+    return hasher.final();
+}
+
+/***************************************************************************************************
+* @description : This function returns the digest size of a checksum type in bytes.
+* @param : ChecksumType type
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int checksumHasher::digestSize(checksumEngine::ChecksumType type)
+{
+    return checksumEngine::digestLength(type) / 2;
+}
@@ -0,0 +1,260 @@
+#include "checksumManifest.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QRegularExpression>
+
+/***************************************************************************************************
+* @description : This function reads a checksum list file. The checksum type comes from the file
+*                extension, the BSD tag of a line or, failing both, the digest length. Blank
+*                lines, comments and lines that do not parse are skipped and counted.
+* @param : const QString &manifestPath, QVector<entry> *entries, QString *error, int *skippedLines
+* @return : bool - false if the file cannot be read or holds no checksum line
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumManifest::load(const QString &manifestPath, QVector<entry> *entries, QString *error,
+                            int *skippedLines)
+{
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *error = QString("%1: %2").arg(manifestPath, file.errorString());
+        return false;
+    }
+
+    checksumEngine::ChecksumType defaultType = checksumEngine::SHA256;
+    Format format = SumFormat;
+    bool typeKnown = typeFromFileName(manifestPath, &defaultType, &format);
+
+    const QDir base = QFileInfo(manifestPath).absoluteDir();
+    int skipped = 0;
+    int found = 0;
+
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.trimmed().isEmpty() || line.startsWith(';') || line.startsWith('#')) continue;
+
+        entry parsed;
+        if (!parseLine(line, format, defaultType, typeKnown, &parsed)) {
+            ++skipped;
+            continue;
+        }
+        parsed.filePath = QDir::cleanPath(base.absoluteFilePath(parsed.name));
+        entries->append(parsed);
+        ++found;
+    }
+
+    if (skippedLines) *skippedLines = skipped;
+    if (found == 0) {
+        *error = QString("%1: no checksum lines found").arg(manifestPath);
+        return false;
+    }
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function writes a checksum list. Sum files get lower case digests and two
+*                spaces like sha256sum; SFV files get "name CRC" lines under a comment header.
+*                The file is replaced atomically.
+* @param : const QString &manifestPath, Format format, const QVector<entry> &entries, QString *error
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumManifest::save(const QString &manifestPath, Format format, const QVector<entry> &entries,
+                            QString *error)
+{
+    QSaveFile file(manifestPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        *error = QString("%1: %2").arg(manifestPath, file.errorString());
+        return false;
+    }
+
+    const QDir base = QFileInfo(manifestPath).absoluteDir();
+
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    if (format == SfvFormat) {
+        out << "; Generated by CrcChecksumCalculator\n";
+    }
+
+    for (const entry &item : entries) {
+        QString name = base.relativeFilePath(item.filePath);
+        if (format == SfvFormat) {
+            out << name << ' ' << item.expected.toUpper() << '\n';
+        } else {
+            bool escaped = false;
+            QString written = escapeName(name, &escaped);
+            out << (escaped ? "\\" : "") << item.expected.toLower() << "  " << written << '\n';
+        }
+    }
+
+    out.flush();
+    if (!file.commit()) {
+        *error = QString("%1: %2").arg(manifestPath, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function derives format and type from the list file's extension, e.g.
+*                ".sha256", ".md5sum", ".sfv" or ".crc32".
+* @param : const QString &manifestPath, ChecksumType *type, Format *format
+* @return : bool - false if the extension says nothing
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumManifest::typeFromFileName(const QString &manifestPath, checksumEngine::ChecksumType *type,
+                                        Format *format)
+{
+    QString suffix = QFileInfo(manifestPath).suffix().toLower();
+    if (suffix.endsWith("sum")) suffix.chop(3);
+
+    *format = SumFormat;
+    if (suffix == "sfv") {
+        *format = SfvFormat;
+        *type = checksumEngine::CRC32;
+        return true;
+    }
+    if (suffix == "crc") {
+        *type = checksumEngine::CRC32;
+        return true;
+    }
+    return checksumEngine::typeFromName(suffix, type);
+}
+
+/***************************************************************************************************
+* @description : This function maps a digest length in hex digits to its checksum type. Several
+*                types share a length, the older and more common one is taken: CRC-32 over
+*                CRC-32C, MD5 over XXH3-128, SHA-256 over BLAKE3 and XXH3-64 over CRC-64.
+* @param : int length, ChecksumType *type
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumManifest::typeFromDigestLength(int length, checksumEngine::ChecksumType *type)
+{
+    switch (length) {
+        case 4:  *type = checksumEngine::CRC16;  return true;
+        case 8:  *type = checksumEngine::CRC32;  return true;
+        case 16: *type = checksumEngine::XXH3_64; return true;
+        case 32: *type = checksumEngine::MD5;    return true;
+        case 40: *type = checksumEngine::SHA1;   return true;
+        case 64: *type = checksumEngine::SHA256; return true;
+    }
+    return false;
+}
+
+/***************************************************************************************************
+* @description : This function parses one line. Lines of .sfv files are read as SFV only, other
+*                files accept every style. A digest whose length does not fit the type named by
+*                the tag or implied by the file name is rejected.
+* @param : const QString &line, Format format, ChecksumType defaultType, bool typeKnown, entry *parsed
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumManifest::parseLine(const QString &line, Format format, checksumEngine::ChecksumType defaultType,
+                                 bool typeKnown, entry *parsed)
+{
+    // BSD tagged: "SHA256 (name) = digest"
+    static const QRegularExpression tagged("^([A-Za-z0-9-]+) \\((.*)\\) = ([0-9A-Fa-f]+)$");
+    // sha256sum: "digest  name" or "digest *name", optional leading '\' for escaped names
+    static const QRegularExpression sum("^(\\\\?)([0-9A-Fa-f]+) [ *](.+)$");
+    // SFV: "name digest"
+    static const QRegularExpression sfv("^(.+?)\\s+([0-9A-Fa-f]{8})$");
+
+    QString text = line;
+    if (text.endsWith('\r')) text.chop(1);
+
+    QRegularExpressionMatch match;
+
+    if (format == SfvFormat) {
+        match = sfv.match(text);
+        if (!match.hasMatch()) return false;
+        parsed->name = match.captured(1).trimmed();
+        parsed->expected = match.captured(2).toUpper();
+        parsed->type = checksumEngine::CRC32;
+        return true;
+    }
+
+    match = tagged.match(text);
+    if (match.hasMatch()) {
+        if (!checksumEngine::typeFromName(match.captured(1), &parsed->type)) return false;
+        parsed->name = match.captured(2);
+        parsed->expected = match.captured(3).toUpper();
+        return checksumEngine::digestLength(parsed->type) == parsed->expected.size();
+    }
+
+    match = sum.match(text);
+    if (match.hasMatch() && isDigest(match.captured(2))) {
+        parsed->expected = match.captured(2).toUpper();
+        parsed->name = match.captured(1).isEmpty() ? match.captured(3) : unescapeName(match.captured(3));
+        if (typeKnown) {
+            parsed->type = defaultType;
+            return checksumEngine::digestLength(parsed->type) == parsed->expected.size();
+        }
+        return typeFromDigestLength(parsed->expected.size(), &parsed->type);
+    }
+
+    match = sfv.match(text);
+    if (match.hasMatch()) {
+        parsed->name = match.captured(1).trimmed();
+        parsed->expected = match.captured(2).toUpper();
+        parsed->type = checksumEngine::CRC32;
+        return !typeKnown || defaultType == checksumEngine::CRC32;
+    }
+    return false;
+}
+
+/***************************************************************************************************
+* @description : This function checks whether text is a hex digest of a supported length.
+* @param : const QString &text
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool checksumManifest::isDigest(const QString &text)
+{
+    checksumEngine::ChecksumType type;
+    return typeFromDigestLength(text.size(), &type);
+}
+
+/***************************************************************************************************
+* @description : This function undoes the escaping coreutils applies to names with '\' or a
+*                newline.
+* @param : const QString &name
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString checksumManifest::unescapeName(const QString &name)
+{
+    QString result;
+    result.reserve(name.size());
+    for (int i = 0; i < name.size(); ++i) {
+        if (name.at(i) == '\\' && i + 1 < name.size()) {
+            QChar next = name.at(++i);
+            result += (next == 'n') ? QChar('\n') : next;
+        } else {
+            result += name.at(i);
+        }
+    }
+    return result;
+}
+
+/***************************************************************************************************
+* @description : This function escapes '\' and newlines the way coreutils does.
+* @param : const QString &name, bool *escaped
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString checksumManifest::escapeName(const QString &name, bool *escaped)
+{
+    *escaped = name.contains('\\') || name.contains('\n');
+    if (!*escaped) return name;
+
+    QString result = name;
+    result.replace("\\", "\\\\");
+    result.replace("\n", "\\n");
+    return result;
+}
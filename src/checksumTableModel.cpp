@@ -0,0 +1,348 @@
+#include "checksumTableModel.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QDir>
+#include <QSet>
+#include <QFont>
+
+/***************************************************************************************************
+* @description : Constructor for checksumTableModel class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+checksumTableModel::checksumTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+/***************************************************************************************************
+* @description : This function returns the number of listed files.
+* @param : const QModelIndex &parent
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int checksumTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : records.size();
+}
+
+/***************************************************************************************************
+* @description : This function returns the number of columns.
+* @param : const QModelIndex &parent
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int checksumTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+/***************************************************************************************************
+* @description : This function returns the text and styling of a cell. Fonts and colours are
+*                shared by all rows instead of being stored per item.
+* @param : const QModelIndex &index, int role
+* @return : QVariant
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QVariant checksumTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= records.size()) return QVariant();
+
+    const fileRecord &record = records.at(index.row());
+
+    if (role == FilePathRole) return record.filePath;
+    if (role == StatusRole) return int(record.status);
+    if (role == ProgressRole) return int(record.progress);
+    if (role == ThroughputRole) return double(record.mbPerSecond);
+
+    switch (index.column()) {
+        case NameColumn:
+            if (role == Qt::DisplayRole) return record.filePath.mid(record.nameStart);
+            if (role == Qt::TextAlignmentRole) return int(Qt::AlignLeft | Qt::AlignVCenter);
+            break;
+        case ChecksumColumn:
+            if (role == Qt::DisplayRole) return record.checksum;
+            if (role == Qt::TextAlignmentRole) return int(Qt::AlignCenter);
+            if (role == Qt::ToolTipRole) return QString("Click to copy Checksum");
+            if (role == Qt::ForegroundRole) {
+                static const QBrush checksumBrush(QColor("#0067c0"));
+                return checksumBrush;
+            }
+            if (role == Qt::FontRole) {
+                static const QFont checksumFont = [](){
+                    QFont font("Segoe UI", 16, QFont::Bold);
+                    font.setLetterSpacing(QFont::AbsoluteSpacing, 1.5);
+                    return font;
+                }();
+                return checksumFont;
+            }
+            break;
+        case StatusColumn:
+            if (role == Qt::DisplayRole) return manifestVerifier::statusText(record.status);
+            if (role == Qt::TextAlignmentRole) return int(Qt::AlignCenter);
+            if (role == Qt::ToolTipRole && record.status == manifestVerifier::Failed) {
+                return QString("Expected %1").arg(record.expected);
+            }
+            if (role == Qt::ForegroundRole) {
+                static const QBrush passedBrush(QColor("#107c10"));
+                static const QBrush failedBrush(QColor("#c42b1c"));
+                static const QBrush missingBrush(QColor("#9d5d00"));
+                switch (record.status) {
+                    case manifestVerifier::Passed:  return passedBrush;
+                    case manifestVerifier::Failed:  return failedBrush;
+                    case manifestVerifier::Pending: break;
+                    default:                        return missingBrush;
+                }
+            }
+            if (role == Qt::FontRole && record.status != manifestVerifier::Pending) {
+                static const QFont statusFont("Segoe UI", 11, QFont::Bold);
+                return statusFont;
+            }
+            break;
+        case PathColumn:
+            if (role == Qt::DisplayRole) return folderPath(index.row());
+            if (role == Qt::TextAlignmentRole) return int(Qt::AlignLeft | Qt::AlignVCenter);
+            if (role == Qt::ForegroundRole) {
+                static const QBrush pathBrush(QColor("#666666"));
+                return pathBrush;
+            }
+            break;
+        case OpenFolderColumn:
+            if (role == Qt::ToolTipRole) return QString("Open File Location");
+            break;
+    }
+    return QVariant();
+}
+
+/***************************************************************************************************
+* @description : This function returns the column titles.
+* @param : int section, Qt::Orientation orientation, int role
+* @return : QVariant
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QVariant checksumTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+        case NameColumn:     return QString("Filename");
+        case ChecksumColumn: return QString("Checksum");
+        case StatusColumn:   return QString("Status");
+        case PathColumn:     return QString("Source Path");
+    }
+    return QString();
+}
+
+/***************************************************************************************************
+* @description : This function appends every file that is not listed yet with the given checksum
+*                text. All new rows are announced in a single insertion so the view lays out
+*                once per drop instead of once per file.
+* @param : const QStringList &filePaths, const QString &checksum
+* @return : QStringList - the paths that were added
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QStringList checksumTableModel::addFiles(const QStringList &filePaths, const QString &checksum)
+{
+    QStringList added;
+    QSet<QString> seen;
+    for (const QString &path : filePaths) {
+        QString filePath = QDir::fromNativeSeparators(path);
+        if (rowIndex.contains(filePath) || seen.contains(filePath)) continue;
+        seen.insert(filePath);
+        added.append(filePath);
+    }
+    if (added.isEmpty()) return added;
+
+    const int first = records.size();
+    beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+    records.reserve(first + added.size());
+    rowIndex.reserve(first + added.size());
+    for (const QString &filePath : qAsConst(added)) {
+        rowIndex.insert(filePath, records.size());
+        records.append(fileRecord{ filePath, filePath.lastIndexOf('/') + 1, checksum,
+                                   manifestVerifier::Pending, QString(), -1, 0 });
+    }
+    endInsertRows();
+
+    return added;
+}
+
+/***************************************************************************************************
+* @description : This function finds the row of a file.
+* @param : const QString &filePath
+* @return : int - -1 if the file is not listed
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int checksumTableModel::rowOf(const QString &filePath) const
+{
+    return rowIndex.value(QDir::fromNativeSeparators(filePath), -1);
+}
+
+/***************************************************************************************************
+* @description : This function returns the full path of the file in a row.
+* @param : int row
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString checksumTableModel::filePath(int row) const
+{
+    return records.value(row).filePath;
+}
+
+/***************************************************************************************************
+* @description : This function returns the folder containing the file in a row.
+* @param : int row
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString checksumTableModel::folderPath(int row) const
+{
+    if (row < 0 || row >= records.size()) return QString();
+
+    const fileRecord &record = records.at(row);
+    // Keep the slash of a file in the root directory, "/" or "C:/"
+    int length = record.nameStart > 1 ? record.nameStart - 1 : record.nameStart;
+    if (length == 2 && record.filePath.at(1) == ':') length = 3;
+    return record.filePath.left(length);
+}
+
+/***************************************************************************************************
+* @description : This function returns the checksum text of a row.
+* @param : int row
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString checksumTableModel::checksum(int row) const
+{
+    return records.value(row).checksum;
+}
+
+/***************************************************************************************************
+* @description : This function replaces the checksum text of a row.
+* @param : int row, const QString &checksum
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumTableModel::setChecksum(int row, const QString &checksum)
+{
+    if (row < 0 || row >= records.size()) return;
+
+    fileRecord &record = records[row];
+    if (record.checksum == checksum && record.progress < 0) return;
+
+    record.checksum = checksum;
+    record.progress = -1;
+    QModelIndex cell = index(row, ChecksumColumn);
+    emit dataChanged(cell, cell, QVector<int>() << Qt::DisplayRole << ProgressRole);
+}
+
+/***************************************************************************************************
+* @description : This function replaces the checksum text of many rows. Views are told once
+*                about the range of rows that changed instead of once per row.
+* @param : const QVector<QPair<int, QString>> &checksums
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumTableModel::setChecksums(const QVector<QPair<int, QString>> &checksums)
+{
+    int first = records.size();
+    int last = -1;
+    for (const QPair<int, QString> &item : checksums) {
+        if (item.first < 0 || item.first >= records.size()) continue;
+
+        fileRecord &record = records[item.first];
+        if (record.checksum == item.second && record.progress < 0) continue;
+
+        record.checksum = item.second;
+        record.progress = -1;
+        first = qMin(first, item.first);
+        last = qMax(last, item.first);
+    }
+    if (last < 0) return;
+
+    emit dataChanged(index(first, ChecksumColumn), index(last, ChecksumColumn),
+                     QVector<int>() << Qt::DisplayRole << ProgressRole);
+}
+
+/***************************************************************************************************
+* @description : This function sets the hashing progress of a row. The bar is painted by
+*                progressDelegate over the checksum cell.
+* @param : int row, int permille, double mbPerSecond
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumTableModel::setProgress(int row, int permille, double mbPerSecond)
+{
+    if (row < 0 || row >= records.size()) return;
+
+    fileRecord &record = records[row];
+    if (record.progress == permille && qFuzzyCompare(record.mbPerSecond + 1, float(mbPerSecond) + 1)) return;
+
+    record.progress = qint16(permille);
+    record.mbPerSecond = float(mbPerSecond);
+    QModelIndex cell = index(row, ChecksumColumn);
+    emit dataChanged(cell, cell, QVector<int>() << ProgressRole << ThroughputRole);
+}
+
+/***************************************************************************************************
+* @description : This function returns the verification status of a row.
+* @param : int row
+* @return : manifestVerifier::Status
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+manifestVerifier::Status checksumTableModel::status(int row) const
+{
+    if (row < 0 || row >= records.size()) return manifestVerifier::Pending;
+    return records.at(row).status;
+}
+
+/***************************************************************************************************
+* @description : This function sets the verification status of a row. The expected checksum is
+*                only kept for rows that failed, where it is shown as tooltip.
+* @param : int row, manifestVerifier::Status status, const QString &expected
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumTableModel::setStatus(int row, manifestVerifier::Status status, const QString &expected)
+{
+    if (row < 0 || row >= records.size()) return;
+
+    fileRecord &record = records[row];
+    record.status = status;
+    record.expected = status == manifestVerifier::Failed ? expected : QString();
+    QModelIndex cell = index(row, StatusColumn);
+    emit dataChanged(cell, cell);
+}
+
+/***************************************************************************************************
+* @description : This function sets every row back to Pending before a new list is verified.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumTableModel::clearStatus()
+{
+    if (records.isEmpty()) return;
+
+    for (fileRecord &record : records) {
+        record.status = manifestVerifier::Pending;
+        record.expected.clear();
+    }
+    emit dataChanged(index(0, StatusColumn), index(records.size() - 1, StatusColumn));
+}
+
+/***************************************************************************************************
+* @description : This function removes every row.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumTableModel::clear()
+{
+    beginResetModel();
+    records.clear();
+    rowIndex.clear();
+    endResetModel();
+}
@@ -0,0 +1,676 @@
+#include "commandLine.h"
+#include "checksumDatabase.h"
+#include "directoryWalker.h"
+#include "duplicateFinder.h"
+#include "fileIdentity.h"
+#include "hashStatistics.h"
+#include "manifestVerifier.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+
+// Files found so far and their results, shared between the walking, hashing and printing threads
+struct batchState
+{
+    QStringList files;
+    QVector<QString> checksums;
+    QVector<bool> done;
+    int next = 0;
+    bool walkFinished = false;
+    QMutex mutex;
+    // Signalled when files are found or the walk ends
+    QWaitCondition queued;
+    // Signalled when a result is stored, files are found or the walk ends
+    QWaitCondition ready;
+
+    void append(const QStringList &found)
+    {
+        hashStatistics::instance().addQueued(found.size());
+
+        QMutexLocker locker(&mutex);
+        files.append(found);
+        checksums.resize(files.size());
+        done.resize(files.size());
+        queued.wakeAll();
+        ready.wakeAll();
+    }
+
+    void finishWalk()
+    {
+        QMutexLocker locker(&mutex);
+        walkFinished = true;
+        queued.wakeAll();
+        ready.wakeAll();
+    }
+};
+
+// Worker that keeps taking unhashed files until the list is exhausted. Small files are claimed
+// a few at a time and read in inode order, which saves lock round trips and disk seeks.
+class batchWorker : public QRunnable
+{
+public:
+    batchWorker(batchState *state, int jobs, checksumEngine::ChecksumType type, checksumEngine::IoBackend backend,
+                commandLine::CacheMode cacheMode)
+        : state(state), jobs(jobs), type(type), backend(backend), cacheMode(cacheMode)
+    {
+    }
+
+    // Most files taken at once
+    static const int ClaimSize = 16;
+
+    void run() override
+    {
+        const QVector<checksumEngine::ChecksumType> types = QVector<checksumEngine::ChecksumType>() << type;
+        QVector<QPair<fileIdentity, int>> claimed;
+        QVector<QPair<int, QString>> checksums;
+
+        while (true) {
+            claimed.clear();
+            {
+                QMutexLocker locker(&state->mutex);
+                while (state->next >= state->files.size() && !state->walkFinished) {
+                    state->queued.wait(&state->mutex);
+                }
+                const int available = state->files.size() - state->next;
+                if (available <= 0) break;
+
+                // Leave work for the other threads when only a few (possibly large) files are left
+                const int count = qBound(1, available / (2 * jobs), int(ClaimSize));
+                for (int i = 0; i < count; ++i) {
+                    fileIdentity identity;
+                    identity.path = state->files.at(state->next);
+                    claimed.append(qMakePair(identity, state->next++));
+                }
+            }
+
+            for (QPair<fileIdentity, int> &file : claimed) {
+                QString path = file.first.path;
+                if (!fileIdentity::read(path, &file.first)) file.first.size = -1;
+            }
+            if (claimed.size() > 1) {
+                std::sort(claimed.begin(), claimed.end(), [](const QPair<fileIdentity, int> &a,
+                                                             const QPair<fileIdentity, int> &b) {
+                    return a.first.device != b.first.device ? a.first.device < b.first.device
+                                                            : a.first.inode < b.first.inode;
+                });
+            }
+
+            checksums.clear();
+            for (const QPair<fileIdentity, int> &file : qAsConst(claimed)) {
+                QString checksum;
+                if (cacheMode == commandLine::NoCache) {
+                    checksum = checksumEngine::CalculateChecksum(file.first.path, type, backend);
+                } else {
+                    checksum = checksumDatabase::instance().checksums(file.first, types, backend,
+                                                                      cacheMode == commandLine::ForceRehash).value(type);
+                }
+                checksums.append(qMakePair(file.second, checksum));
+            }
+
+            hashStatistics::instance().addCompleted(checksums.size());
+
+            QMutexLocker locker(&state->mutex);
+            for (const QPair<int, QString> &result : qAsConst(checksums)) {
+                state->checksums[result.first] = result.second;
+                state->done[result.first] = true;
+            }
+            state->ready.wakeAll();
+        }
+    }
+
+private:
+    batchState *state;
+    int jobs;
+    checksumEngine::ChecksumType type;
+    checksumEngine::IoBackend backend;
+    commandLine::CacheMode cacheMode;
+};
+
+// Bytes of output collected before they are written
+const int OutputBlockSize = 64 * 1024;
+
+// Rewrites a status line on stderr every IntervalMs until it is interrupted
+class progressPrinter : public QThread
+{
+public:
+    static const int IntervalMs = 500;
+
+protected:
+    void run() override
+    {
+        int lastLength = 0;
+        while (!isInterruptionRequested()) {
+            msleep(IntervalMs);
+            QByteArray line = hashStatistics::instance().current().statusText().toLocal8Bit();
+            const int length = line.size();
+            // Blank out what is left of a longer previous line
+            if (length < lastLength) line += QByteArray(lastLength - length, ' ');
+            lastLength = length;
+            line.prepend('\r');
+            fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stderr);
+            fflush(stderr);
+        }
+        if (lastLength > 0) fputc('\n', stderr);
+    }
+};
+
+// Long options run() defines, naming one of them selects the headless mode
+const char *const LongOptions[] = {
+    "algo", "jobs", "io", "force", "no-cache", "include", "exclude", "follow-symlinks", "sort",
+    "check", "fail-fast", "progress", "stats-log", "duplicates", "cli", "help", "help-all"
+};
+// Short options run() defines, the value ones may be followed by their value, e.g. "-j8"
+const char ShortOptions[] = "ajcdh?";
+const char ShortValueOptions[] = "aj";
+
+void printError(const QString &message)
+{
+    QByteArray line = QCoreApplication::applicationName().toLocal8Bit() + ": " + message.toLocal8Bit() + '\n';
+    fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stderr);
+}
+
+} // namespace
+
+/***************************************************************************************************
+* @description : This function decides between GUI and headless mode. Only an option of the
+*                headless mode, or --cli, selects it. Plain paths from "Open with" or files
+*                dropped on the executable and Qt's own options such as -style keep the GUI.
+* @param : int argc, char *argv[]
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool commandLine::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray argument(argv[i]);
+        if (argument == "--") break;
+
+        if (argument.startsWith("--")) {
+            const QByteArray name = argument.mid(2).split('=').first();
+            for (const char *option : LongOptions) {
+                if (name == option) return true;
+            }
+        } else if (argument.size() >= 2 && argument.at(0) == '-') {
+            const char *options = argument.size() == 2 ? ShortOptions : ShortValueOptions;
+            if (std::strchr(options, argument.at(1))) return true;
+        }
+    }
+    return false;
+}
+
+/***************************************************************************************************
+* @description : This function returns the paths the GUI was started with as absolute paths.
+*                Options, which QApplication has not taken itself, and the process serial number
+*                macOS passes to bundles are skipped.
+* @param : const QStringList &arguments
+* @return : QStringList
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QStringList commandLine::pathArguments(const QStringList &arguments)
+{
+    QStringList paths;
+    bool optionsEnded = false;
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString &argument = arguments.at(i);
+        if (!optionsEnded && argument == "--") {
+            optionsEnded = true;
+            continue;
+        }
+        if (!optionsEnded && argument.startsWith('-')) continue;
+        paths.append(QFileInfo(argument).absoluteFilePath());
+    }
+    return paths;
+}
+
+/***************************************************************************************************
+* @description : This function runs the headless mode. Must be called after a QCoreApplication was
+*                created.
+* @param : const QStringList &arguments
+* @return : int - 0 on success, 1 if any file could not be read
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int commandLine::run(const QStringList &arguments)
+{
+#ifdef Q_OS_WIN
+    // Release builds are GUI subsystem binaries, reuse the console of the calling shell
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        freopen("CONOUT$", "w", stdout);
+        freopen("CONOUT$", "w", stderr);
+    }
+#endif
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Prints a checksum for every file, directories are hashed recursively.");
+    parser.addHelpOption();
+
+    QCommandLineOption algoOption(QStringList() << "a" << "algo",
+                                  "Checksum algorithm: crc16, crc32, crc32c, crc64, md5, sha1, sha256 (default), "
+                                  "xxh3, xxh128 or blake3.",
+                                  "algorithm", "sha256");
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+                                  "Number of files hashed in parallel (default: number of cores).",
+                                  "N", QString::number(qMax(1, QThread::idealThreadCount())));
+    QCommandLineOption ioOption("io",
+                                "I/O backend: read (default, reads ahead of the hashing) or mmap (falls back to read).",
+                                "backend", "read");
+    QCommandLineOption forceOption("force",
+                                   "Re-hash every file even if the checksum cache has it, and update the cache.");
+    QCommandLineOption noCacheOption("no-cache",
+                                     "Neither read nor write the checksum cache.");
+    QCommandLineOption includeOption("include",
+                                     "Only hash files matching these globs when walking directories, e.g. \"*.bin;*.hex\".",
+                                     "globs");
+    QCommandLineOption excludeOption("exclude",
+                                     "Skip files and directories matching these globs, e.g. \".git;*.o\".",
+                                     "globs");
+    QCommandLineOption followOption("follow-symlinks",
+                                    "Enter symbolic links to directories, loops are skipped.");
+    QCommandLineOption sortOption("sort",
+                                  "Finish walking each directory before hashing and print its files sorted.");
+    QCommandLineOption checkOption(QStringList() << "c" << "check",
+                                   "Read checksum lists (sha256sum, md5sum, SFV) and check the files they name.");
+    QCommandLineOption failFastOption("fail-fast",
+                                      "With --check, stop at the first file that is missing or does not match.");
+    QCommandLineOption progressOption("progress",
+                                      "Show files done, MB/s, I/O wait and ETA on stderr while hashing.");
+    QCommandLineOption statsLogOption("stats-log",
+                                      "Write size, time, CPU time, I/O wait and MB/s of every file read to a CSV "
+                                      "file, or JSON lines if it ends in .json.",
+                                      "file");
+    QCommandLineOption cliOption("cli",
+                                 "Run headless even when only paths are given, which otherwise open the window.");
+    QCommandLineOption duplicatesOption(QStringList() << "d" << "duplicates",
+                                        "List files with identical contents instead of their checksums, confirmed "
+                                        "with --algo when it has at least 128 bits, otherwise with sha256.");
+    parser.addOption(algoOption);
+    parser.addOption(jobsOption);
+    parser.addOption(ioOption);
+    parser.addOption(forceOption);
+    parser.addOption(noCacheOption);
+    parser.addOption(includeOption);
+    parser.addOption(excludeOption);
+    parser.addOption(followOption);
+    parser.addOption(sortOption);
+    parser.addOption(checkOption);
+    parser.addOption(failFastOption);
+    parser.addOption(progressOption);
+    parser.addOption(statsLogOption);
+    parser.addOption(duplicatesOption);
+    parser.addOption(cliOption);
+    parser.addPositionalArgument("paths", "Files or directories to hash, checksum lists with --check.", "<paths...>");
+
+    parser.process(arguments);
+
+    checksumEngine::ChecksumType type;
+    if (!checksumEngine::typeFromName(parser.value(algoOption), &type)) {
+        printError(QString("unknown algorithm '%1'").arg(parser.value(algoOption)));
+        return 2;
+    }
+
+    bool jobsValid = false;
+    int jobs = parser.value(jobsOption).toInt(&jobsValid);
+    if (!jobsValid || jobs < 1) {
+        printError(QString("invalid job count '%1'").arg(parser.value(jobsOption)));
+        return 2;
+    }
+
+    checksumEngine::IoBackend backend = checksumEngine::BufferedIo;
+    if (parser.value(ioOption) == "mmap") {
+        backend = checksumEngine::MappedIo;
+    } else if (parser.value(ioOption) != "read") {
+        printError(QString("unknown I/O backend '%1'").arg(parser.value(ioOption)));
+        return 2;
+    }
+
+    const QStringList paths = parser.positionalArguments();
+    if (paths.isEmpty()) {
+        printError("no input files");
+        return 2;
+    }
+
+    CacheMode cacheMode = UseCache;
+    if (parser.isSet(noCacheOption)) {
+        cacheMode = NoCache;
+    } else if (parser.isSet(forceOption)) {
+        cacheMode = ForceRehash;
+    }
+
+    if (parser.isSet(statsLogOption)) {
+        QString error;
+        if (!hashStatistics::instance().openLog(parser.value(statsLogOption), &error)) {
+            printError(error);
+            return 2;
+        }
+    }
+
+    progressPrinter progress;
+    if (parser.isSet(progressOption)) progress.start();
+    auto finishStatistics = [&progress]() {
+        progress.requestInterruption();
+        progress.wait();
+        hashStatistics::instance().closeLog();
+    };
+
+    if (parser.isSet(checkOption)) {
+        bool ok = checkLists(paths, backend, cacheMode, jobs, parser.isSet(failFastOption));
+        if (cacheMode != NoCache) {
+            checksumDatabase::instance().flush();
+        }
+        finishStatistics();
+        return ok ? 0 : 1;
+    }
+
+    bool missing = false;
+    QStringList roots;
+    for (const QString &path : paths) {
+        if (!QFileInfo::exists(path)) {
+            printError(QString("%1: No such file or directory").arg(path));
+            missing = true;
+            continue;
+        }
+        roots << path;
+    }
+
+    directoryWalker walker;
+    walker.setFilters(parser.values(includeOption).join(';'), parser.values(excludeOption).join(';'));
+    walker.setFollowSymlinks(parser.isSet(followOption));
+
+    bool ok;
+    if (parser.isSet(duplicatesOption)) {
+        ok = findDuplicates(walker, roots, type, backend, cacheMode, jobs);
+    } else {
+        ok = hashFiles(walker, roots, parser.isSet(sortOption), type, backend, cacheMode, jobs);
+    }
+    if (cacheMode != NoCache) {
+        checksumDatabase::instance().flush();
+    }
+    finishStatistics();
+    return (ok && !missing) ? 0 : 1;
+}
+
+/***************************************************************************************************
+* @description : This function walks the given paths and hashes the files on a pool of jobs
+*                threads. Hashing starts with the first batch the walker reports, so deep trees
+*                are listed and hashed at the same time. Lines are printed as soon as every
+*                earlier file is done, in the order the files were found. With sorted set every
+*                tree is walked completely first and its files sorted, which makes the output
+*                identical between runs.
+* @param : directoryWalker &walker, const QStringList &paths, bool sorted, ChecksumType type,
+*          IoBackend backend, CacheMode cacheMode, int jobs
+* @return : bool - false if any file could not be read
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool commandLine::hashFiles(directoryWalker &walker, const QStringList &paths, bool sorted,
+                            checksumEngine::ChecksumType type, checksumEngine::IoBackend backend,
+                            CacheMode cacheMode, int jobs)
+{
+    batchState state;
+
+    // Called on the walking threads
+    QObject::connect(&walker, &directoryWalker::filesFound, [&state](const QStringList &found, int) {
+        state.append(found);
+    });
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+
+    if (sorted) {
+        for (const QString &path : paths) {
+            int first = state.files.size();
+            walker.add(QStringList() << path);
+            walker.waitForFinished();
+            std::sort(state.files.begin() + first, state.files.end());
+        }
+        state.finishWalk();
+    } else {
+        QObject::connect(&walker, &directoryWalker::finished, [&state]() {
+            state.finishWalk();
+        });
+        walker.add(paths);
+        if (!walker.isRunning()) state.finishWalk();
+    }
+
+    for (int i = 0; i < jobs; ++i) {
+        pool.start(new batchWorker(&state, jobs, type, backend, cacheMode));
+    }
+
+    // Lines are collected and written in blocks, and whenever the printer has to wait
+    QByteArray output;
+    auto writeOutput = [&output]() {
+        if (output.isEmpty()) return;
+        fwrite(output.constData(), 1, static_cast<size_t>(output.size()), stdout);
+        fflush(stdout);
+        output.clear();
+    };
+
+    bool ok = true;
+    for (int index = 0; ; ++index) {
+        QString checksum;
+        QString filePath;
+        {
+            QMutexLocker locker(&state.mutex);
+            auto isReady = [&state, index]() {
+                return (index < state.files.size() && state.done.at(index))
+                    || (state.walkFinished && index >= state.files.size());
+            };
+            if (!isReady()) {
+                locker.unlock();
+                writeOutput();
+                locker.relock();
+                while (!isReady()) {
+                    state.ready.wait(&state.mutex);
+                }
+            }
+            if (index >= state.files.size()) break;
+
+            checksum = state.checksums.at(index);
+            state.checksums[index].clear();
+            filePath = state.files.at(index);
+        }
+
+        if (checksum == "ERROR") {
+            writeOutput();
+            printError(QString("%1: read error").arg(filePath));
+            ok = false;
+            continue;
+        }
+
+        output += checksum.toLower().toLatin1() + "  " + QDir::toNativeSeparators(filePath).toLocal8Bit() + '\n';
+        if (output.size() >= OutputBlockSize) writeOutput();
+    }
+    writeOutput();
+
+    pool.waitForDone();
+    // The finished() handler may still be running on a walking thread
+    walker.waitForFinished();
+    walker.disconnect();
+    return ok;
+}
+
+/***************************************************************************************************
+* @description : This function checks the files named in checksum lists. The largest files are
+*                read first, lines are printed in list order as soon as every earlier entry is
+*                done. Output follows sha256sum -c: "name: OK", "name: FAILED" and "name: FAILED
+*                open or read", with a summary of problems on stderr.
+* @param : const QStringList &manifestPaths, IoBackend backend, CacheMode cacheMode, int jobs,
+*          bool failFast
+* @return : bool - false if any list could not be read or any entry did not pass
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool commandLine::checkLists(const QStringList &manifestPaths, checksumEngine::IoBackend backend,
+                             CacheMode cacheMode, int jobs, bool failFast)
+{
+    bool ok = true;
+    int badLines = 0;
+    QVector<checksumManifest::entry> entries;
+    for (const QString &manifestPath : manifestPaths) {
+        QString error;
+        int skipped = 0;
+        if (!checksumManifest::load(manifestPath, &entries, &error, &skipped)) {
+            printError(error);
+            ok = false;
+        }
+        badLines += skipped;
+    }
+    if (entries.isEmpty()) return false;
+
+    struct checkState
+    {
+        QMutex mutex;
+        QWaitCondition ready;
+        QVector<manifestVerifier::Status> statuses;
+        bool finished = false;
+    } state;
+    state.statuses.fill(manifestVerifier::Pending, entries.size());
+
+    manifestVerifier verifier;
+    verifier.setThreadCount(jobs);
+    verifier.setBackend(backend);
+    verifier.setUpdateDatabase(cacheMode != NoCache);
+    verifier.setStopOnFailure(failFast);
+
+    // Both are called on the verifying threads
+    QObject::connect(&verifier, &manifestVerifier::entriesVerified,
+                     [&state](const QVector<manifestVerifier::result> &results, int) {
+        QMutexLocker locker(&state.mutex);
+        for (const manifestVerifier::result &result : results) {
+            state.statuses[result.index] = result.status;
+        }
+        state.ready.wakeAll();
+    });
+    QObject::connect(&verifier, &manifestVerifier::finished, [&state](int, int, int, int) {
+        QMutexLocker locker(&state.mutex);
+        state.finished = true;
+        state.ready.wakeAll();
+    });
+
+    verifier.start(entries);
+
+    int failed = 0;
+    int unreadable = 0;
+    for (int index = 0; index < entries.size(); ++index) {
+        manifestVerifier::Status status;
+        {
+            QMutexLocker locker(&state.mutex);
+            while (state.statuses.at(index) == manifestVerifier::Pending && !state.finished) {
+                fflush(stdout);
+                state.ready.wait(&state.mutex);
+            }
+            status = state.statuses.at(index);
+        }
+
+        const QByteArray name = QDir::toNativeSeparators(entries.at(index).name).toLocal8Bit();
+        switch (status) {
+            case manifestVerifier::Pending:
+                // Not checked, the run stopped at a failure
+                continue;
+            case manifestVerifier::Passed:
+                printf("%s: OK\n", name.constData());
+                break;
+            case manifestVerifier::Failed:
+                printf("%s: FAILED\n", name.constData());
+                ++failed;
+                break;
+            case manifestVerifier::Missing:
+            case manifestVerifier::Unreadable:
+                fflush(stdout);
+                printError(QString("%1: %2").arg(entries.at(index).name,
+                                                 status == manifestVerifier::Missing ? "No such file or directory"
+                                                                                     : "read error"));
+                printf("%s: FAILED open or read\n", name.constData());
+                ++unreadable;
+                break;
+        }
+    }
+    fflush(stdout);
+
+    verifier.waitForFinished();
+    verifier.disconnect();
+
+    if (badLines > 0) printError(QString("WARNING: %1 lines are improperly formatted").arg(badLines));
+    if (unreadable > 0) printError(QString("WARNING: %1 listed files could not be read").arg(unreadable));
+    if (failed > 0) printError(QString("WARNING: %1 computed checksums did NOT match").arg(failed));
+
+    return ok && failed == 0 && unreadable == 0;
+}
+
+/***************************************************************************************************
+* @description : This function walks the given paths and reports files with identical contents.
+*                Groups are printed like fdupes, one path per line and a blank line after each
+*                group, each group preceded by its size and checksum. A summary goes to stderr.
+* @param : directoryWalker &walker, const QStringList &paths, ChecksumType type,
+*          IoBackend backend, CacheMode cacheMode, int jobs
+* @return : bool - false if any file could not be read
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool commandLine::findDuplicates(directoryWalker &walker, const QStringList &paths,
+                                 checksumEngine::ChecksumType type, checksumEngine::IoBackend backend,
+                                 CacheMode cacheMode, int jobs)
+{
+    QStringList files;
+    QMutex filesMutex;
+
+    // Called on the walking threads
+    QObject::connect(&walker, &directoryWalker::filesFound, [&files, &filesMutex](const QStringList &found, int) {
+        QMutexLocker locker(&filesMutex);
+        files.append(found);
+    });
+    walker.add(paths);
+    walker.waitForFinished();
+    walker.disconnect();
+
+    QVector<duplicateFinder::group> groups;
+    duplicateFinder::summary counters;
+
+    duplicateFinder finder;
+    finder.setChecksumType(type);
+    finder.setBackend(backend);
+    finder.setUseDatabase(cacheMode == UseCache);
+    finder.setThreadCount(jobs);
+
+    // Called on a finding thread, before waitForFinished() returns
+    QObject::connect(&finder, &duplicateFinder::finished,
+                     [&groups, &counters](const QVector<duplicateFinder::group> &found,
+                                          const duplicateFinder::summary &foundCounters, int) {
+        groups = found;
+        counters = foundCounters;
+    });
+    finder.start(files);
+    finder.waitForFinished();
+    finder.disconnect();
+
+    QByteArray output;
+    for (const duplicateFinder::group &duplicates : qAsConst(groups)) {
+        output += QByteArray::number(duplicates.size) + " bytes, " + duplicates.checksum.toLower().toLatin1() + '\n';
+        for (const QString &filePath : duplicates.filePaths) {
+            output += QDir::toNativeSeparators(filePath).toLocal8Bit() + '\n';
+        }
+        output += '\n';
+        if (output.size() >= OutputBlockSize) {
+            fwrite(output.constData(), 1, static_cast<size_t>(output.size()), stdout);
+            output.clear();
+        }
+    }
+    fwrite(output.constData(), 1, static_cast<size_t>(output.size()), stdout);
+    fflush(stdout);
+
+    printError(counters.text());
+    return counters.unreadable == 0;
+}
@@ -0,0 +1,178 @@
+#include "crc16Engine.h"
+
+#include <QByteArray>
+
+namespace {
+
+const quint16 Polynomial = 0x8005;
+
+// Table k maps a byte to its crc contribution when followed by k zero bytes
+struct crc16Tables
+{
+    quint16 t[8][256];
+};
+
+constexpr crc16Tables makeTables()
+{
+    crc16Tables tables {};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ Polynomial : (crc << 1);
+        }
+        tables.t[0][i] = static_cast<quint16>(crc);
+    }
+    for (quint32 i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            quint16 prev = tables.t[k - 1][i];
+            tables.t[k][i] = static_cast<quint16>((prev << 8) ^ tables.t[0][prev >> 8]);
+        }
+    }
+    return tables;
+}
+
+constexpr crc16Tables Tables = makeTables();
+
+static_assert(Tables.t[0][1] == 0x8005, "CRC-16 table generation is broken");
+static_assert(Tables.t[0][255] == 0x0202, "CRC-16 table generation is broken");
+
+// Multiplies two polynomials modulo P, bit 15 is x^15
+constexpr quint16 multModP(quint16 a, quint16 b)
+{
+    quint32 product = 0;
+    for (int bit = 15; bit >= 0; --bit) {
+        product = (product & 0x8000) ? (product << 1) ^ Polynomial : (product << 1);
+        if ((a >> bit) & 1) product ^= b;
+    }
+    return static_cast<quint16>(product);
+}
+
+// Entry n is x^(2^n) mod P
+struct crc16Powers
+{
+    quint16 x2n[64];
+};
+
+constexpr crc16Powers makePowers()
+{
+    crc16Powers powers {};
+    quint16 p = 0x0002;    // x^1
+    powers.x2n[0] = p;
+    for (int n = 1; n < 64; ++n) {
+        p = multModP(p, p);
+        powers.x2n[n] = p;
+    }
+    return powers;
+}
+
+constexpr crc16Powers Powers = makePowers();
+
+inline quint16 bytewise(quint16 crc, const unsigned char *p, qint64 len)
+{
+    const quint16 *t0 = Tables.t[0];
+    while (len-- > 0) {
+        crc = static_cast<quint16>(t0[(crc >> 8) ^ *p++] ^ (crc << 8));
+    }
+    return crc;
+}
+
+} // namespace
+
+/***************************************************************************************************
+* @description : This function computes CRC16 with the fastest kernel.
+* @param : quint16 crc, const unsigned char *data, qint64 len
+* @return : quint16
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint16 crc16Engine::update(quint16 crc, const unsigned char *data, qint64 len)
+{
+    return updateSlicing8(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function returns the crc of two concatenated blocks from the crc of each
+*                block and the length of the second one. With initial value 0 and no final xor
+*                the crc is linear, so crc1 only has to be advanced over len2 zero bytes, i.e.
+*                multiplied by x^(8 * len2) mod P.
+* @param : quint16 crc1, quint16 crc2, qint64 len2
+* @return : quint16
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint16 crc16Engine::combine(quint16 crc1, quint16 crc2, qint64 len2)
+{
+    if (len2 <= 0) return crc1;
+
+    quint64 bits = static_cast<quint64>(len2) * 8;
+    quint16 shift = 0x0001;    // x^0
+    for (int n = 0; bits != 0; ++n, bits >>= 1) {
+        if (bits & 1) shift = multModP(Powers.x2n[n], shift);
+    }
+    return static_cast<quint16>(multModP(shift, crc1) ^ crc2);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC16 one byte at a time.
+* @param : quint16 crc, const unsigned char *data, qint64 len
+* @return : quint16
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint16 crc16Engine::updateBytewise(quint16 crc, const unsigned char *data, qint64 len)
+{
+    return bytewise(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC16 eight bytes at a time (slicing-by-8). The running
+*                crc is folded into the first two bytes of each block.
+* @param : quint16 crc, const unsigned char *data, qint64 len
+* @return : quint16
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint16 crc16Engine::updateSlicing8(quint16 crc, const unsigned char *data, qint64 len)
+{
+    const quint16 (*t)[256] = Tables.t;
+
+    while (len >= 8) {
+        crc = t[7][data[0] ^ (crc >> 8)] ^ t[6][data[1] ^ (crc & 0xFF)]
+            ^ t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]]
+            ^ t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        len -= 8;
+    }
+
+    return bytewise(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function checks the slicing kernel against the bytewise reference.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool crc16Engine::selfTest()
+{
+    const int maxAlignment = 8;
+    const int maxLength = 4096 + 7;
+
+    QByteArray buffer(maxLength + maxAlignment, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < buffer.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = static_cast<char>(seed >> 24);
+    }
+    const unsigned char *base = reinterpret_cast<const unsigned char *>(buffer.constData());
+
+    for (int offset = 0; offset < maxAlignment; ++offset) {
+        const unsigned char *data = base + offset;
+        for (qint64 len = 0; len <= maxLength; len += (len < 300 ? 1 : 97)) {
+            quint16 expected = updateBytewise(0, data, len);
+            if (updateSlicing8(0, data, len) != expected) return false;
+
+            qint64 split = len / 3;
+            if (updateSlicing8(updateSlicing8(0, data, split), data + split, len - split) != expected) return false;
+            if (combine(updateSlicing8(0, data, split), updateSlicing8(0, data + split, len - split),
+                        len - split) != expected) return false;
+        }
+    }
+    return update(0, reinterpret_cast<const unsigned char *>("123456789"), 9) == 0xFEE8;
+}
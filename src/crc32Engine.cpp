@@ -0,0 +1,489 @@
+#include "crc32Engine.h"
+
+#include <QtEndian>
+#include <QByteArray>
+
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_MSVC))
+#  define CRC32_HAVE_PCLMUL
+#  include <immintrin.h>
+#  if defined(Q_CC_MSVC)
+#    include <intrin.h>
+#    define CRC32_TARGET_PCLMUL
+#  else
+#    define CRC32_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+#  endif
+#endif
+
+namespace {
+
+const quint32 Polynomial = 0xEDB88320;
+
+// Table k maps a byte to its crc contribution when followed by k zero bytes
+struct crc32Tables
+{
+    quint32 t[16][256];
+};
+
+constexpr crc32Tables makeTables()
+{
+    crc32Tables tables {};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ Polynomial : (crc >> 1);
+        }
+        tables.t[0][i] = crc;
+    }
+    for (quint32 i = 0; i < 256; ++i) {
+        for (int k = 1; k < 16; ++k) {
+            quint32 prev = tables.t[k - 1][i];
+            tables.t[k][i] = (prev >> 8) ^ tables.t[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr crc32Tables Tables = makeTables();
+
+static_assert(Tables.t[0][1] == 0x77073096, "CRC-32 table generation is broken");
+static_assert(Tables.t[0][255] == 0x2D02EF8D, "CRC-32 table generation is broken");
+
+// Multiplies two polynomials modulo P, both bit-reflected (bit 31 is x^0)
+constexpr quint32 multModP(quint32 a, quint32 b)
+{
+    quint32 m = quint32(1) << 31;
+    quint32 product = 0;
+    while (m != 0) {
+        if (a & m) {
+            product ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ Polynomial : (b >> 1);
+    }
+    return product;
+}
+
+// Entry n is x^(2^n) mod P
+struct crc32Powers
+{
+    quint32 x2n[32];
+};
+
+constexpr crc32Powers makePowers()
+{
+    crc32Powers powers {};
+    quint32 p = quint32(1) << 30;    // x^1
+    powers.x2n[0] = p;
+    for (int n = 1; n < 32; ++n) {
+        p = multModP(p, p);
+        powers.x2n[n] = p;
+    }
+    return powers;
+}
+
+constexpr crc32Powers Powers = makePowers();
+
+// Returns x^(n * 2^k) mod P
+inline quint32 x2nModP(quint64 n, int k)
+{
+    quint32 p = quint32(1) << 31;    // x^0
+    while (n) {
+        if (n & 1) p = multModP(Powers.x2n[k & 31], p);
+        n >>= 1;
+        ++k;
+    }
+    return p;
+}
+
+inline quint32 bytewise(quint32 crc, const unsigned char *p, qint64 len)
+{
+    const quint32 *t0 = Tables.t[0];
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ t0[(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CRC32_HAVE_PCLMUL
+// Inputs shorter than this are cheaper on the table kernels
+const qint64 PclmulMinimumLength = 64;
+
+/***************************************************************************************************
+* @description : This function folds 16 byte blocks with carry-less multiplication and reduces
+*                the result with Barrett reduction ("Fast CRC Computation for Generic Polynomials
+*                Using PCLMULQDQ Instruction", Intel 2009). Constants are x^n mod P for the
+*                bit-reflected polynomial. Works on the inverted crc state, len must be a
+*                multiple of 16 and at least 64.
+* @param : const unsigned char *buf, qint64 len, quint32 crc
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+CRC32_TARGET_PCLMUL quint32 foldPclmul(const unsigned char *buf, qint64 len, quint32 crc)
+{
+    alignas(16) static const quint64 k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+    alignas(16) static const quint64 k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+    alignas(16) static const quint64 k5k0[] = { 0x0163cd6124, 0x0000000000 };
+    alignas(16) static const quint64 poly[] = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x30));
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+
+    buf += 64;
+    len -= 64;
+
+    // Fold four 128 bit lanes in parallel
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x30));
+
+        x1 = _mm_xor_si128(x1, x5);
+        x2 = _mm_xor_si128(x2, x6);
+        x3 = _mm_xor_si128(x3, x7);
+        x4 = _mm_xor_si128(x4, x8);
+
+        x1 = _mm_xor_si128(x1, y5);
+        x2 = _mm_xor_si128(x2, y6);
+        x3 = _mm_xor_si128(x3, y7);
+        x4 = _mm_xor_si128(x4, y8);
+
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the four lanes into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(x1, x2);
+    x1 = _mm_xor_si128(x1, x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(x1, x3);
+    x1 = _mm_xor_si128(x1, x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(x1, x4);
+    x1 = _mm_xor_si128(x1, x5);
+
+    // Remaining 16 byte blocks
+    while (len >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf));
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(x1, x2);
+        x1 = _mm_xor_si128(x1, x5);
+
+        buf += 16;
+        len -= 16;
+    }
+
+    // Fold 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<quint32>(_mm_extract_epi32(x1, 1));
+}
+
+bool cpuHasPclmul()
+{
+#if defined(Q_CC_MSVC)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 1)) && (regs[2] & (1 << 19));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#endif
+}
+#endif // CRC32_HAVE_PCLMUL
+
+typedef quint32 (*kernelFunction)(quint32 crc, const unsigned char *data, qint64 len);
+
+kernelFunction functionFor(crc32Engine::Kernel kernel)
+{
+    switch (kernel) {
+        case crc32Engine::Bytewise:  return crc32Engine::updateBytewise;
+        case crc32Engine::Slicing8:  return crc32Engine::updateSlicing8;
+        case crc32Engine::Slicing16: return crc32Engine::updateSlicing16;
+        case crc32Engine::Pclmul:    return crc32Engine::updatePclmul;
+    }
+    return crc32Engine::updateBytewise;
+}
+
+/***************************************************************************************************
+* @description : This function compares one kernel with the bytewise reference for every length
+*                up to a few cache lines, several larger sizes, all 16 alignments and split calls.
+* @param : crc32Engine::Kernel kernel
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool verifyKernel(crc32Engine::Kernel kernel)
+{
+    static const qint64 LargeLengths[] = { 1023, 4096, 4096 + 15, 65536 + 7 };
+    const int maxAlignment = 16;
+
+    QByteArray buffer(65536 + 7 + maxAlignment, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < buffer.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = static_cast<char>(seed >> 24);
+    }
+    const unsigned char *base = reinterpret_cast<const unsigned char *>(buffer.constData());
+
+    kernelFunction function = functionFor(kernel);
+
+    for (int offset = 0; offset < maxAlignment; ++offset) {
+        const unsigned char *data = base + offset;
+
+        for (qint64 len = 0; len <= 300; ++len) {
+            if (function(0, data, len) != crc32Engine::updateBytewise(0, data, len)) return false;
+        }
+
+        for (qint64 len : LargeLengths) {
+            quint32 expected = crc32Engine::updateBytewise(0, data, len);
+            if (function(0, data, len) != expected) return false;
+
+            qint64 split = len / 3 + offset;
+            if (function(function(0, data, split), data + split, len - split) != expected) return false;
+            if (crc32Engine::combine(function(0, data, split), function(0, data + split, len - split),
+                                     len - split) != expected) return false;
+        }
+    }
+    return true;
+}
+
+crc32Engine::Kernel selectKernel()
+{
+    if (crc32Engine::isKernelSupported(crc32Engine::Pclmul) && verifyKernel(crc32Engine::Pclmul)) {
+        return crc32Engine::Pclmul;
+    }
+    return crc32Engine::Slicing16;
+}
+
+} // namespace
+
+/***************************************************************************************************
+* @description : This function computes CRC32 with the fastest kernel this CPU supports.
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32Engine::update(quint32 crc, const unsigned char *data, qint64 len)
+{
+    static const kernelFunction function = functionFor(activeKernel());
+    return function(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32 with the given kernel.
+* @param : Kernel kernel, quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32Engine::updateWith(Kernel kernel, quint32 crc, const unsigned char *data, qint64 len)
+{
+    return functionFor(kernel)(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function returns the kernel used by update(). The hardware kernel is only
+*                picked when the CPU supports it and it agrees with the reference.
+* @param : None
+* @return : Kernel
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+crc32Engine::Kernel crc32Engine::activeKernel()
+{
+    static const Kernel kernel = selectKernel();
+    return kernel;
+}
+
+/***************************************************************************************************
+* @description : This function tells whether a kernel can run on this machine.
+* @param : Kernel kernel
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool crc32Engine::isKernelSupported(Kernel kernel)
+{
+    if (kernel != Pclmul) return true;
+
+#ifdef CRC32_HAVE_PCLMUL
+    static const bool supported = cpuHasPclmul();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function returns a printable kernel name.
+* @param : Kernel kernel
+* @return : const char *
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+const char *crc32Engine::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Bytewise:  return "bytewise";
+        case Slicing8:  return "slicing-by-8";
+        case Slicing16: return "slicing-by-16";
+        case Pclmul:    return "pclmulqdq";
+    }
+    return "unknown";
+}
+
+/***************************************************************************************************
+* @description : This function returns the crc of two concatenated blocks from the crc of each
+*                block and the length of the second one, without touching the data. The first
+*                crc is advanced over len2 zero bytes with x^(8 * len2) mod P, computed from the
+*                x^(2^n) table in O(log len2) (the method of zlib's crc32_combine).
+* @param : quint32 crc1, quint32 crc2, qint64 len2
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32Engine::combine(quint32 crc1, quint32 crc2, qint64 len2)
+{
+    if (len2 <= 0) return crc1;
+    return multModP(x2nModP(static_cast<quint64>(len2), 3), crc1) ^ crc2;
+}
+
+/***************************************************************************************************
+* @description : This function checks every supported kernel against the bytewise reference.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool crc32Engine::selfTest()
+{
+    static const Kernel Kernels[] = { Slicing8, Slicing16, Pclmul };
+
+    for (Kernel kernel : Kernels) {
+        if (isKernelSupported(kernel) && !verifyKernel(kernel)) return false;
+    }
+    return update(0, reinterpret_cast<const unsigned char *>("123456789"), 9) == 0xCBF43926;
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32 one byte at a time.
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32Engine::updateBytewise(quint32 crc, const unsigned char *data, qint64 len)
+{
+    return ~bytewise(~crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32 eight bytes at a time (slicing-by-8).
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32Engine::updateSlicing8(quint32 crc, const unsigned char *data, qint64 len)
+{
+    const quint32 (*t)[256] = Tables.t;
+    crc = ~crc;
+
+    while (len >= 8) {
+        quint32 one = qFromLittleEndian<quint32>(data) ^ crc;
+        quint32 two = qFromLittleEndian<quint32>(data + 4);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+            ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        data += 8;
+        len -= 8;
+    }
+
+    return ~bytewise(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32 sixteen bytes at a time (slicing-by-16).
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32Engine::updateSlicing16(quint32 crc, const unsigned char *data, qint64 len)
+{
+    const quint32 (*t)[256] = Tables.t;
+    crc = ~crc;
+
+    while (len >= 16) {
+        quint32 one = qFromLittleEndian<quint32>(data) ^ crc;
+        quint32 two = qFromLittleEndian<quint32>(data + 4);
+        quint32 three = qFromLittleEndian<quint32>(data + 8);
+        quint32 four = qFromLittleEndian<quint32>(data + 12);
+        crc = t[15][one & 0xFF] ^ t[14][(one >> 8) & 0xFF] ^ t[13][(one >> 16) & 0xFF] ^ t[12][one >> 24]
+            ^ t[11][two & 0xFF] ^ t[10][(two >> 8) & 0xFF] ^ t[9][(two >> 16) & 0xFF] ^ t[8][two >> 24]
+            ^ t[7][three & 0xFF] ^ t[6][(three >> 8) & 0xFF] ^ t[5][(three >> 16) & 0xFF] ^ t[4][three >> 24]
+            ^ t[3][four & 0xFF] ^ t[2][(four >> 8) & 0xFF] ^ t[1][(four >> 16) & 0xFF] ^ t[0][four >> 24];
+        data += 16;
+        len -= 16;
+    }
+
+    return ~bytewise(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32 with PCLMULQDQ folding. Short inputs and the tail
+*                that does not fill a 16 byte block go through the slicing-by-16 kernel.
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32Engine::updatePclmul(quint32 crc, const unsigned char *data, qint64 len)
+{
+#ifdef CRC32_HAVE_PCLMUL
+    if (len >= PclmulMinimumLength) {
+        qint64 blocks = len & ~qint64(15);
+        crc = ~foldPclmul(data, blocks, ~crc);
+        data += blocks;
+        len -= blocks;
+    }
+#endif
+    return updateSlicing16(crc, data, len);
+}
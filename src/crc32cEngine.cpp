@@ -0,0 +1,386 @@
+#include "crc32cEngine.h"
+
+#include <QtEndian>
+#include <QByteArray>
+
+#if defined(Q_PROCESSOR_X86_64) && (defined(Q_CC_GNU) || defined(Q_CC_MSVC))
+#  define CRC32C_HAVE_SSE42
+#  include <immintrin.h>
+#  if defined(Q_CC_MSVC)
+#    include <intrin.h>
+#    define CRC32C_TARGET_SSE42
+#  else
+#    define CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#  endif
+#endif
+
+namespace {
+
+const quint32 Polynomial = 0x82F63B78;
+
+// Table k maps a byte to its crc contribution when followed by k zero bytes
+struct crc32cTables
+{
+    quint32 t[8][256];
+};
+
+constexpr crc32cTables makeTables()
+{
+    crc32cTables tables {};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ Polynomial : (crc >> 1);
+        }
+        tables.t[0][i] = crc;
+    }
+    for (quint32 i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            quint32 prev = tables.t[k - 1][i];
+            tables.t[k][i] = (prev >> 8) ^ tables.t[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr crc32cTables Tables = makeTables();
+
+static_assert(Tables.t[0][1] == 0xF26B8303, "CRC-32C table generation is broken");
+static_assert(Tables.t[0][255] == 0xAD7D5351, "CRC-32C table generation is broken");
+
+// Multiplies two polynomials modulo P, both bit-reflected (bit 31 is x^0)
+constexpr quint32 multModP(quint32 a, quint32 b)
+{
+    quint32 m = quint32(1) << 31;
+    quint32 product = 0;
+    while (m != 0) {
+        if (a & m) {
+            product ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ Polynomial : (b >> 1);
+    }
+    return product;
+}
+
+// Entry n is x^(2^n) mod P
+struct crc32cPowers
+{
+    quint32 x2n[32];
+};
+
+constexpr crc32cPowers makePowers()
+{
+    crc32cPowers powers {};
+    quint32 p = quint32(1) << 30;    // x^1
+    powers.x2n[0] = p;
+    for (int n = 1; n < 32; ++n) {
+        p = multModP(p, p);
+        powers.x2n[n] = p;
+    }
+    return powers;
+}
+
+constexpr crc32cPowers Powers = makePowers();
+
+// Returns x^(n * 2^k) mod P
+inline quint32 x2nModP(quint64 n, int k)
+{
+    quint32 p = quint32(1) << 31;    // x^0
+    while (n) {
+        if (n & 1) p = multModP(Powers.x2n[k & 31], p);
+        n >>= 1;
+        ++k;
+    }
+    return p;
+}
+
+inline quint32 bytewise(quint32 crc, const unsigned char *p, qint64 len)
+{
+    const quint32 *t0 = Tables.t[0];
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ t0[(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CRC32C_HAVE_SSE42
+// Bytes per stream and round in the interleaved kernel. The crc32 instruction has a latency of
+// three cycles and a throughput of one, so three independent streams keep it busy.
+const qint64 StreamLength = 4096;
+// x^(8 * StreamLength) and x^(16 * StreamLength) mod P, shift a stream's crc past the following ones
+const quint32 ShiftOne = multModP(x2nModP(StreamLength, 3), quint32(1) << 31);
+const quint32 ShiftTwo = multModP(x2nModP(2 * StreamLength, 3), quint32(1) << 31);
+
+/***************************************************************************************************
+* @description : This function runs the crc32 instruction over the inverted crc state. Rounds of
+*                3 * StreamLength bytes are split into three streams whose crcs are computed side
+*                by side and joined with the precomputed shifts, the rest is done in one stream.
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+CRC32C_TARGET_SSE42 quint32 hardware(quint32 crc, const unsigned char *data, qint64 len)
+{
+    quint64 crc0 = crc;
+
+    // Reach 8 byte alignment
+    while (len > 0 && (reinterpret_cast<quintptr>(data) & 7) != 0) {
+        crc0 = _mm_crc32_u8(static_cast<quint32>(crc0), *data++);
+        --len;
+    }
+
+    while (len >= 3 * StreamLength) {
+        quint64 crc1 = 0;
+        quint64 crc2 = 0;
+        const unsigned char *end = data + StreamLength;
+        while (data < end) {
+            crc0 = _mm_crc32_u64(crc0, qFromLittleEndian<quint64>(data));
+            crc1 = _mm_crc32_u64(crc1, qFromLittleEndian<quint64>(data + StreamLength));
+            crc2 = _mm_crc32_u64(crc2, qFromLittleEndian<quint64>(data + 2 * StreamLength));
+            data += 8;
+        }
+        crc0 = multModP(ShiftTwo, static_cast<quint32>(crc0)) ^ multModP(ShiftOne, static_cast<quint32>(crc1))
+             ^ static_cast<quint32>(crc2);
+        data += 2 * StreamLength;
+        len -= 3 * StreamLength;
+    }
+
+    while (len >= 8) {
+        crc0 = _mm_crc32_u64(crc0, qFromLittleEndian<quint64>(data));
+        data += 8;
+        len -= 8;
+    }
+    while (len-- > 0) {
+        crc0 = _mm_crc32_u8(static_cast<quint32>(crc0), *data++);
+    }
+    return static_cast<quint32>(crc0);
+}
+
+bool cpuHasSse42()
+{
+#if defined(Q_CC_MSVC)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 20)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#endif // CRC32C_HAVE_SSE42
+
+typedef quint32 (*kernelFunction)(quint32 crc, const unsigned char *data, qint64 len);
+
+kernelFunction functionFor(crc32cEngine::Kernel kernel)
+{
+    switch (kernel) {
+        case crc32cEngine::Bytewise: return crc32cEngine::updateBytewise;
+        case crc32cEngine::Slicing8: return crc32cEngine::updateSlicing8;
+        case crc32cEngine::Sse42:    return crc32cEngine::updateSse42;
+    }
+    return crc32cEngine::updateBytewise;
+}
+
+/***************************************************************************************************
+* @description : This function compares one kernel with the bytewise reference for every length
+*                up to a few cache lines, lengths around the interleaved round size, all 8
+*                alignments, split calls and combine.
+* @param : crc32cEngine::Kernel kernel
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool verifyKernel(crc32cEngine::Kernel kernel)
+{
+    static const qint64 LargeLengths[] = { 1023, 4096, 12288 - 1, 12288, 12288 + 9, 3 * 12288 + 5 };
+    const int maxAlignment = 8;
+
+    QByteArray buffer(3 * 12288 + 5 + maxAlignment, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < buffer.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = static_cast<char>(seed >> 24);
+    }
+    const unsigned char *base = reinterpret_cast<const unsigned char *>(buffer.constData());
+
+    kernelFunction function = functionFor(kernel);
+
+    for (int offset = 0; offset < maxAlignment; ++offset) {
+        const unsigned char *data = base + offset;
+
+        for (qint64 len = 0; len <= 300; ++len) {
+            if (function(0, data, len) != crc32cEngine::updateBytewise(0, data, len)) return false;
+        }
+
+        for (qint64 len : LargeLengths) {
+            quint32 expected = crc32cEngine::updateBytewise(0, data, len);
+            if (function(0, data, len) != expected) return false;
+
+            qint64 split = len / 3 + offset;
+            if (function(function(0, data, split), data + split, len - split) != expected) return false;
+            if (crc32cEngine::combine(function(0, data, split), function(0, data + split, len - split),
+                                      len - split) != expected) return false;
+        }
+    }
+    return true;
+}
+
+crc32cEngine::Kernel selectKernel()
+{
+    if (crc32cEngine::isKernelSupported(crc32cEngine::Sse42) && verifyKernel(crc32cEngine::Sse42)) {
+        return crc32cEngine::Sse42;
+    }
+    return crc32cEngine::Slicing8;
+}
+
+} // namespace
+
+/***************************************************************************************************
+* @description : This function computes CRC32C with the fastest kernel this CPU supports.
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32cEngine::update(quint32 crc, const unsigned char *data, qint64 len)
+{
+    static const kernelFunction function = functionFor(activeKernel());
+    return function(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32C with the given kernel.
+* @param : Kernel kernel, quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32cEngine::updateWith(Kernel kernel, quint32 crc, const unsigned char *data, qint64 len)
+{
+    return functionFor(kernel)(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function returns the kernel used by update(). The hardware kernel is only
+*                picked when the CPU supports it and it agrees with the reference.
+* @param : None
+* @return : Kernel
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+crc32cEngine::Kernel crc32cEngine::activeKernel()
+{
+    static const Kernel kernel = selectKernel();
+    return kernel;
+}
+
+/***************************************************************************************************
+* @description : This function tells whether a kernel can run on this machine.
+* @param : Kernel kernel
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool crc32cEngine::isKernelSupported(Kernel kernel)
+{
+    if (kernel != Sse42) return true;
+
+#ifdef CRC32C_HAVE_SSE42
+    static const bool supported = cpuHasSse42();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function returns a printable kernel name.
+* @param : Kernel kernel
+* @return : const char *
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+const char *crc32cEngine::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Bytewise: return "bytewise";
+        case Slicing8: return "slicing-by-8";
+        case Sse42:    return "sse4.2";
+    }
+    return "unknown";
+}
+
+/***************************************************************************************************
+* @description : This function returns the crc of two concatenated blocks from the crc of each
+*                block and the length of the second one, like crc32Engine::combine.
+* @param : quint32 crc1, quint32 crc2, qint64 len2
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32cEngine::combine(quint32 crc1, quint32 crc2, qint64 len2)
+{
+    if (len2 <= 0) return crc1;
+    return multModP(x2nModP(static_cast<quint64>(len2), 3), crc1) ^ crc2;
+}
+
+/***************************************************************************************************
+* @description : This function checks every supported kernel against the bytewise reference.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool crc32cEngine::selfTest()
+{
+    static const Kernel Kernels[] = { Slicing8, Sse42 };
+
+    for (Kernel kernel : Kernels) {
+        if (isKernelSupported(kernel) && !verifyKernel(kernel)) return false;
+    }
+    return update(0, reinterpret_cast<const unsigned char *>("123456789"), 9) == 0xE3069283;
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32C one byte at a time.
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32cEngine::updateBytewise(quint32 crc, const unsigned char *data, qint64 len)
+{
+    return ~bytewise(~crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32C eight bytes at a time (slicing-by-8).
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32cEngine::updateSlicing8(quint32 crc, const unsigned char *data, qint64 len)
+{
+    const quint32 (*t)[256] = Tables.t;
+    crc = ~crc;
+
+    while (len >= 8) {
+        quint32 one = qFromLittleEndian<quint32>(data) ^ crc;
+        quint32 two = qFromLittleEndian<quint32>(data + 4);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+            ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        data += 8;
+        len -= 8;
+    }
+
+    return ~bytewise(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC32C with the SSE4.2 crc32 instruction, or slicing-by-8
+*                where it is not available.
+* @param : quint32 crc, const unsigned char *data, qint64 len
+* @return : quint32
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint32 crc32cEngine::updateSse42(quint32 crc, const unsigned char *data, qint64 len)
+{
+#ifdef CRC32C_HAVE_SSE42
+    return ~hardware(~crc, data, len);
+#else
+    return updateSlicing8(crc, data, len);
+#endif
+}
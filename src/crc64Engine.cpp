@@ -0,0 +1,187 @@
+#include "crc64Engine.h"
+
+#include <QtEndian>
+#include <QByteArray>
+
+namespace {
+
+const quint64 Polynomial = Q_UINT64_C(0xC96C5795D7870F42);
+
+// Table k maps a byte to its crc contribution when followed by k zero bytes
+struct crc64Tables
+{
+    quint64 t[8][256];
+};
+
+constexpr crc64Tables makeTables()
+{
+    crc64Tables tables {};
+    for (quint64 i = 0; i < 256; ++i) {
+        quint64 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ Polynomial : (crc >> 1);
+        }
+        tables.t[0][i] = crc;
+    }
+    for (quint32 i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            quint64 prev = tables.t[k - 1][i];
+            tables.t[k][i] = (prev >> 8) ^ tables.t[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr crc64Tables Tables = makeTables();
+
+static_assert(Tables.t[0][1] == Q_UINT64_C(0xB32E4CBE03A75F6F), "CRC-64 table generation is broken");
+static_assert(Tables.t[0][255] == Q_UINT64_C(0xE0ADA17364673F59), "CRC-64 table generation is broken");
+
+// Multiplies two polynomials modulo P, both bit-reflected (bit 63 is x^0)
+constexpr quint64 multModP(quint64 a, quint64 b)
+{
+    quint64 m = quint64(1) << 63;
+    quint64 product = 0;
+    while (m != 0) {
+        if (a & m) {
+            product ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ Polynomial : (b >> 1);
+    }
+    return product;
+}
+
+// Entry n is x^(2^n) mod P
+struct crc64Powers
+{
+    quint64 x2n[64];
+};
+
+constexpr crc64Powers makePowers()
+{
+    crc64Powers powers {};
+    quint64 p = quint64(1) << 62;    // x^1
+    powers.x2n[0] = p;
+    for (int n = 1; n < 64; ++n) {
+        p = multModP(p, p);
+        powers.x2n[n] = p;
+    }
+    return powers;
+}
+
+constexpr crc64Powers Powers = makePowers();
+
+inline quint64 bytewise(quint64 crc, const unsigned char *p, qint64 len)
+{
+    const quint64 *t0 = Tables.t[0];
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ t0[(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+} // namespace
+
+/***************************************************************************************************
+* @description : This function computes CRC64 with the fastest kernel.
+* @param : quint64 crc, const unsigned char *data, qint64 len
+* @return : quint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint64 crc64Engine::update(quint64 crc, const unsigned char *data, qint64 len)
+{
+    return updateSlicing8(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function returns the crc of two concatenated blocks from the crc of each
+*                block and the length of the second one, like crc32Engine::combine. crc1 is
+*                advanced over len2 zero bytes, i.e. multiplied by x^(8 * len2) mod P; the
+*                initial and final inversions cancel out.
+* @param : quint64 crc1, quint64 crc2, qint64 len2
+* @return : quint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint64 crc64Engine::combine(quint64 crc1, quint64 crc2, qint64 len2)
+{
+    if (len2 <= 0) return crc1;
+
+    quint64 bits = static_cast<quint64>(len2) * 8;
+    quint64 shift = quint64(1) << 63;    // x^0
+    for (int n = 0; bits != 0; ++n, bits >>= 1) {
+        if (bits & 1) shift = multModP(Powers.x2n[n], shift);
+    }
+    return multModP(shift, crc1) ^ crc2;
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC64 one byte at a time.
+* @param : quint64 crc, const unsigned char *data, qint64 len
+* @return : quint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint64 crc64Engine::updateBytewise(quint64 crc, const unsigned char *data, qint64 len)
+{
+    return ~bytewise(~crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function computes CRC64 eight bytes at a time (slicing-by-8). The whole
+*                running crc is folded into each block.
+* @param : quint64 crc, const unsigned char *data, qint64 len
+* @return : quint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint64 crc64Engine::updateSlicing8(quint64 crc, const unsigned char *data, qint64 len)
+{
+    const quint64 (*t)[256] = Tables.t;
+    crc = ~crc;
+
+    while (len >= 8) {
+        quint64 block = qFromLittleEndian<quint64>(data) ^ crc;
+        crc = t[7][block & 0xFF] ^ t[6][(block >> 8) & 0xFF] ^ t[5][(block >> 16) & 0xFF]
+            ^ t[4][(block >> 24) & 0xFF] ^ t[3][(block >> 32) & 0xFF] ^ t[2][(block >> 40) & 0xFF]
+            ^ t[1][(block >> 48) & 0xFF] ^ t[0][block >> 56];
+        data += 8;
+        len -= 8;
+    }
+
+    return ~bytewise(crc, data, len);
+}
+
+/***************************************************************************************************
+* @description : This function checks the slicing kernel and combine against the bytewise
+*                reference.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool crc64Engine::selfTest()
+{
+    const int maxAlignment = 8;
+    const int maxLength = 4096 + 7;
+
+    QByteArray buffer(maxLength + maxAlignment, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < buffer.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = static_cast<char>(seed >> 24);
+    }
+    const unsigned char *base = reinterpret_cast<const unsigned char *>(buffer.constData());
+
+    for (int offset = 0; offset < maxAlignment; ++offset) {
+        const unsigned char *data = base + offset;
+        for (qint64 len = 0; len <= maxLength; len += (len < 300 ? 1 : 97)) {
+            quint64 expected = updateBytewise(0, data, len);
+            if (updateSlicing8(0, data, len) != expected) return false;
+
+            qint64 split = len / 3;
+            if (updateSlicing8(updateSlicing8(0, data, split), data + split, len - split) != expected) return false;
+            if (combine(updateSlicing8(0, data, split), updateSlicing8(0, data + split, len - split),
+                        len - split) != expected) return false;
+        }
+    }
+    return update(0, reinterpret_cast<const unsigned char *>("123456789"), 9) == Q_UINT64_C(0x995DC9BBDF1939FA);
+}
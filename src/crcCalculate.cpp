@@ -1,6 +1,16 @@
 #include "crcCalculate.h"
 #include "ui_crccalculate.h"
-
+#include "hashScheduler.h"
+#include "checksumDatabase.h"
+#include "openFolderDelegate.h"
+#include "directoryWalker.h"
+#include "hashStatistics.h"
+#include "progressDelegate.h"
+
+// Text shown in the checksum column until the worker pool reports the result
+static const char *PendingChecksumText = "Calculating...";
+// Refresh interval of the progress bars and the status line
+static const int StatisticsIntervalMs = 250;
 
 /***************************************************************************************************
 * @description : Constructor for crcCalculate class.
@@ -11,6 +21,13 @@
 crcCalculate::crcCalculate(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::crcCalculate)
+    , scheduler(new hashScheduler(this))
+    , tableModel(new checksumTableModel(this))
+    , walker(new directoryWalker(this))
+    , verifier(new manifestVerifier(this))
+    , finder(new duplicateFinder(this))
+    , watcher(new folderWatcher(this))
+    , statusIdle(true)
 {
     ui->setupUi(this);
 
@@ -18,7 +35,7 @@ crcCalculate::crcCalculate(QWidget *parent)
 
     setupTable();
 
-    connect(ui->tableWidget, &QTableWidget::cellClicked,
+    connect(ui->tableView, &QTableView::clicked,
             this, &crcCalculate::onTableItemClicked);
 
     QFile qss(":/styleSheet.qss");
@@ -32,8 +49,39 @@ crcCalculate::crcCalculate(QWidget *parent)
     connect(ui->checksumCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &crcCalculate::onChecksumTypeChanged);
 
+    connect(scheduler, &hashScheduler::filesHashed,
+            this, &crcCalculate::onFilesHashed, Qt::QueuedConnection);
+
+    connect(ui->chkAllAlgorithms, &QCheckBox::toggled, this, [this](bool checked){
+        if (checked) updateChecksums();
+    });
+
+    connect(ui->chkForceRehash, &QCheckBox::toggled, scheduler, &hashScheduler::setForceRehash);
+
+    connect(walker, &directoryWalker::filesFound,
+            this, &crcCalculate::onFilesFound, Qt::QueuedConnection);
+
+    connect(verifier, &manifestVerifier::entriesVerified,
+            this, &crcCalculate::onEntriesVerified, Qt::QueuedConnection);
+    connect(verifier, &manifestVerifier::finished,
+            this, &crcCalculate::onVerifyFinished, Qt::QueuedConnection);
+
+    connect(finder, &duplicateFinder::finished,
+            this, &crcCalculate::onDuplicatesFound, Qt::QueuedConnection);
 
-    currentType = CRC16; // Default
+    connect(watcher, &folderWatcher::filesChanged, this, &crcCalculate::onWatchedFilesChanged);
+    connect(ui->chkWatchFolders, &QCheckBox::toggled, this, [this](bool checked){
+        if (checked) {
+            watchFolders(importedFolders);
+        } else {
+            watcher->clear();
+        }
+    });
+
+    connect(&statisticsTimer, &QTimer::timeout, this, &crcCalculate::onStatisticsTimer);
+    statisticsTimer.start(StatisticsIntervalMs);
+
+    currentType = checksumEngine::CRC16; // Default
 }
 
 /***************************************************************************************************
@@ -44,39 +92,54 @@ crcCalculate::crcCalculate(QWidget *parent)
 ***************************************************************************************************/
 crcCalculate::~crcCalculate()
 {
+    delete walker;
+    delete verifier;
+    delete finder;
+    delete watcher;
+    delete scheduler;
     delete ui;
 }
 
 /***************************************************************************************************
-* @description : This function will setup the table widget.
+* @description : This function will setup the table view. Rows have a fixed height so the view
+*                never measures its contents, which keeps scrolling cheap with any number of rows.
 * @param : None
 * @return : void
 * @Author : Ritesh Pandit
 ***************************************************************************************************/
 void crcCalculate::setupTable()
 {
-    ui->tableWidget->setColumnCount(4);
+    ui->tableView->setModel(tableModel);
+    ui->tableView->setItemDelegateForColumn(checksumTableModel::ChecksumColumn, new progressDelegate(this));
+    ui->tableView->setItemDelegateForColumn(checksumTableModel::OpenFolderColumn, new openFolderDelegate(this));
+    ui->tableView->setMouseTracking(true);
+
+    ui->tableView->setColumnWidth(checksumTableModel::NameColumn, 250);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(checksumTableModel::NameColumn, QHeaderView::Interactive);
 
-    QStringList headers;
-    headers << "Filename" << "Checksum" << "Source Path" << "";
-    ui->tableWidget->setHorizontalHeaderLabels(headers);
+    ui->tableView->setColumnWidth(checksumTableModel::ChecksumColumn, 200);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(checksumTableModel::ChecksumColumn, QHeaderView::Fixed);
 
-    ui->tableWidget->setColumnWidth(0, 250);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Interactive);
+    ui->tableView->setColumnWidth(checksumTableModel::StatusColumn, 110);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(checksumTableModel::StatusColumn, QHeaderView::Fixed);
 
-    ui->tableWidget->setColumnWidth(1, 200);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Fixed);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(checksumTableModel::PathColumn, QHeaderView::Stretch);
 
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    ui->tableView->setColumnWidth(checksumTableModel::OpenFolderColumn, 90);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(checksumTableModel::OpenFolderColumn, QHeaderView::Fixed);
 
-    ui->tableWidget->setColumnWidth(3, 90);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Fixed);
+    ui->tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->tableView->verticalHeader()->setDefaultSectionSize(60);
+    ui->tableView->verticalHeader()->setVisible(false);
+    ui->tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->tableView->setFrameShape(QFrame::NoFrame);
+    ui->tableView->setShowGrid(false);
 
-    ui->tableWidget->verticalHeader()->setDefaultSectionSize(60);
-    ui->tableWidget->verticalHeader()->setVisible(false);
-    ui->tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
-    ui->tableWidget->setFrameShape(QFrame::NoFrame);
-    ui->tableWidget->setShowGrid(false);
+    // Pointing hand over the folder buttons only
+    connect(ui->tableView, &QTableView::entered, this, [this](const QModelIndex &index){
+        bool overButton = index.column() == checksumTableModel::OpenFolderColumn;
+        ui->tableView->viewport()->setCursor(overButton ? Qt::PointingHandCursor : Qt::ArrowCursor);
+    });
 }
 
 /***************************************************************************************************
@@ -89,22 +152,37 @@ void crcCalculate::onChecksumTypeChanged(int index)
 {
     switch(index) {
         case 0:
-            currentType = CRC16;
+            currentType = checksumEngine::CRC16;
             break;
         case 1:
-            currentType = CRC32;
+            currentType = checksumEngine::CRC32;
             break;
         case 2:
-            currentType = MD5;
+            currentType = checksumEngine::MD5;
             break;
         case 3:
-            currentType = SHA1;
+            currentType = checksumEngine::SHA1;
             break;
         case 4:
-            currentType = SHA256;
+            currentType = checksumEngine::SHA256;
+            break;
+        case 5:
+            currentType = checksumEngine::CRC32C;
+            break;
+        case 6:
+            currentType = checksumEngine::CRC64;
+            break;
+        case 7:
+            currentType = checksumEngine::XXH3_64;
+            break;
+        case 8:
+            currentType = checksumEngine::XXH3_128;
+            break;
+        case 9:
+            currentType = checksumEngine::BLAKE3;
             break;
         default:
-            currentType = CRC16;
+            currentType = checksumEngine::CRC16;
             break;
     }
 
@@ -112,25 +190,144 @@ void crcCalculate::onChecksumTypeChanged(int index)
 }
 
 /***************************************************************************************************
-* @description : This function updates checksums for all files in the table.
+* @description : This function shows the current checksum type for all files in the table. Cached
+*                results are shown as they are, only files without one are queued. Changed files
+*                are caught by the folder watcher. Jobs already queued for another type keep
+*                running: they fill the cache, and their files are queued again if the result
+*                lacks the current type.
 * @param : None
 * @return : void
 * @Author : Ritesh Pandit
 ***************************************************************************************************/
 void crcCalculate::updateChecksums()
 {
-    for(int row = 0; row < ui->tableWidget->rowCount(); ++row) {
-        QTableWidgetItem *item = ui->tableWidget->item(row, 0);
-        if (item) {
-            QString filePath = item->data(Qt::UserRole).toString();
-            QString newChecksum = CalculateChecksum(filePath);
-
-            QTableWidgetItem *checksumItem = ui->tableWidget->item(row, 1);
-            if (checksumItem) {
-                checksumItem->setText(newChecksum);
+    QVector<QPair<int, QString>> checksums;
+    checksums.reserve(tableModel->rowCount());
+    QStringList missing;
+    for(int row = 0; row < tableModel->rowCount(); ++row) {
+        QString filePath = tableModel->filePath(row);
+        QString checksum = cachedChecksum(filePath);
+        if (checksum.isEmpty()) {
+            checksum = PendingChecksumText;
+            missing.append(filePath);
+        }
+        checksums.append(qMakePair(row, checksum));
+    }
+    tableModel->setChecksums(checksums);
+    queueFiles(missing);
+}
+
+/***************************************************************************************************
+* @description : This function returns the checksum types computed for each file: every type in
+*                all algorithms mode, otherwise only the selected one.
+* @param : None
+* @return : QVector<ChecksumType>
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QVector<checksumEngine::ChecksumType> crcCalculate::requestedTypes() const
+{
+    if (ui->chkAllAlgorithms->isChecked()) return checksumEngine::allChecksumTypes();
+    return QVector<checksumEngine::ChecksumType>() << currentType;
+}
+
+/***************************************************************************************************
+* @description : This function looks up the cached checksum of the current type. The file is not
+*                checked here, changes are reported by the folder watcher.
+* @param : const QString &filePath
+* @return : QString - empty if nothing is cached or Force Re-hash is checked
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString crcCalculate::cachedChecksum(const QString &filePath) const
+{
+    if (ui->chkForceRehash->isChecked()) return QString();
+
+    auto cached = checksumCache.constFind(filePath);
+    if (cached == checksumCache.constEnd()) return QString();
+    return cached->checksums.value(currentType);
+}
+
+/***************************************************************************************************
+* @description : This function queues files for hashing unless a job for them is already pending.
+*                The scheduler groups them into batch jobs.
+* @param : const QStringList &filePaths
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::queueFiles(const QStringList &filePaths)
+{
+    QStringList queued;
+    for (const QString &filePath : filePaths) {
+        if (pendingFiles.contains(filePath)) continue;
+
+        pendingFiles.insert(filePath);
+        queued.append(filePath);
+    }
+    if (!queued.isEmpty()) scheduler->enqueue(queued, requestedTypes());
+}
+
+/***************************************************************************************************
+* @description : This function handles a batch of results from the worker pool.
+* @param : const QVector<hashResult> &results
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::onFilesHashed(const QVector<hashResult> &results)
+{
+    QStringList again;
+    for (const hashResult &result : results) {
+        if (applyResult(result)) again.append(result.filePath);
+    }
+    queueFiles(again);
+}
+
+/***************************************************************************************************
+* @description : This function stores checksums reported by the worker pool in the cache and
+*                writes the current type into the file's row. A result computed without the
+*                current type, e.g. queued before the type changed, asks for the file to be
+*                queued again.
+* @param : const hashResult &result
+* @return : bool - true if the file must be hashed again
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool crcCalculate::applyResult(const hashResult &result)
+{
+    pendingFiles.remove(result.filePath);
+    if (staleFiles.remove(result.filePath)) return true;
+
+    // Read errors are not cached so the next attempt tries the file again
+    bool failed = result.checksums.key("ERROR", -1) != -1;
+    if (!failed) {
+        hashResult &cached = checksumCache[result.filePath];
+        if (!cached.matches(result.size, result.modified)) {
+            cached = result;
+        } else {
+            for (auto it = result.checksums.constBegin(); it != result.checksums.constEnd(); ++it) {
+                cached.checksums.insert(it.key(), it.value());
             }
         }
     }
+
+    int row = tableModel->rowOf(result.filePath);
+    if (row == -1) return false;
+
+    if (!result.checksums.contains(currentType)) return true;
+
+    tableModel->setChecksum(row, result.checksums.value(currentType));
+    return false;
+}
+
+/***************************************************************************************************
+* @description : This function adds a batch of files found by the directory walker, unless the
+*                walk was cancelled by Clear All after the batch was sent.
+* @param : const QStringList &filePaths, int walkGeneration
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::onFilesFound(const QStringList &filePaths, int walkGeneration)
+{
+    if (walkGeneration != walker->generation()) return;
+
+    processFiles(filePaths);
 }
 
 /***************************************************************************************************
@@ -154,13 +351,17 @@ void crcCalculate::dragEnterEvent(QDragEnterEvent *event)
 ***************************************************************************************************/
 void crcCalculate::dropEvent(QDropEvent *event)
 {
+    checksumDatabase::instance().refresh();
+
+    QStringList localPaths;
     const QList<QUrl> urls = event->mimeData()->urls();
     for (const QUrl &url : urls) {
         QString localPath = url.toLocalFile();
         if (!localPath.isEmpty()) {
-            processFile(localPath);
+            localPaths.append(localPath);
         }
     }
+    importPaths(localPaths);
     event->acceptProposedAction();
 }
 
@@ -182,26 +383,112 @@ void crcCalculate::on_btnAddFiles_clicked()
 
     if (fileNames.isEmpty()) return;
 
-    for (const QString &fileName : qAsConst(fileNames)) {
-        processFile(fileName);
+    checksumDatabase::instance().refresh();
+
+    processFiles(fileNames);
+}
+
+/***************************************************************************************************
+* @description : This function handles add folder button click event.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::on_btnAddFolder_clicked()
+{
+    QString folder = QFileDialog::getExistingDirectory(this, tr("Select Folder"));
+    if (folder.isEmpty()) return;
+
+    checksumDatabase::instance().refresh();
+
+    importPaths(QStringList() << folder);
+}
+
+/***************************************************************************************************
+* @description : This function hands files and folders to the directory walker with the filters
+*                and symlink setting from the UI. Files of a folder show up and start hashing in
+*                batches while the rest of the tree is still being listed.
+* @param : const QStringList &paths
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::importPaths(const QStringList &paths)
+{
+    walker->setFilters(ui->txtInclude->text(), ui->txtExclude->text());
+    walker->setFollowSymlinks(ui->chkFollowSymlinks->isChecked());
+    walker->add(paths);
+
+    QStringList folders;
+    for (const QString &path : paths) {
+        if (QFileInfo(path).isDir()) folders.append(path);
     }
+    importedFolders.append(folders);
+    if (ui->chkWatchFolders->isChecked()) watchFolders(folders);
 }
 
 /***************************************************************************************************
-* @description : This function handles table item click event.
-* @param : int row, int column
+* @description : This function starts watching folders with the filters and symlink setting from
+*                the UI, the same ones their import walk used.
+* @param : const QStringList &folders
 * @return : void
 * @Author : Ritesh Pandit
 ***************************************************************************************************/
-void crcCalculate::onTableItemClicked(int row, int column)
+void crcCalculate::watchFolders(const QStringList &folders)
 {
-    if (column == 1) {
-        QTableWidgetItem *item = ui->tableWidget->item(row, column);
-        if (item) {
+    if (folders.isEmpty()) return;
+
+    watcher->setFilters(ui->txtInclude->text(), ui->txtExclude->text());
+    watcher->setFollowSymlinks(ui->chkFollowSymlinks->isChecked());
+    watcher->watch(folders);
+}
+
+/***************************************************************************************************
+* @description : This function brings the table up to date with a watched folder. New files are
+*                added, changed files are hashed again in their rows and lose a verification
+*                status that no longer applies, removed files are marked Missing. A file that
+*                changes while it is being hashed is hashed again once that result arrives.
+* @param : const QStringList &changedPaths, const QStringList &removedPaths
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::onWatchedFilesChanged(const QStringList &changedPaths, const QStringList &removedPaths)
+{
+    for (const QString &filePath : removedPaths) {
+        int row = tableModel->rowOf(filePath);
+        if (row != -1) tableModel->setStatus(row, manifestVerifier::Missing);
+    }
+
+    if (changedPaths.isEmpty()) return;
+
+    for (const QString &filePath : changedPaths) {
+        if (pendingFiles.contains(filePath)) staleFiles.insert(filePath);
+
+        int row = tableModel->rowOf(filePath);
+        if (row != -1 && tableModel->status(row) != manifestVerifier::Pending) {
+            tableModel->setStatus(row, manifestVerifier::Pending);
+        }
+    }
+    processFiles(changedPaths);
+}
+
+/***************************************************************************************************
+* @description : This function handles table cell click event: the checksum column copies the
+*                checksum, the button column opens the file's folder.
+* @param : const QModelIndex &index
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::onTableItemClicked(const QModelIndex &index)
+{
+    if (index.column() == checksumTableModel::ChecksumColumn) {
+        QString checksum = tableModel->checksum(index.row());
+        if (!checksum.isEmpty() && checksum != PendingChecksumText) {
             QClipboard *clipboard = QApplication::clipboard();
-            clipboard->setText(item->text().prepend ("0x"));
+            clipboard->setText(checksum.prepend ("0x"));
             QToolTip::showText(QCursor::pos(), "Copied to Clipboard!", this);
         }
+    } else if (index.column() == checksumTableModel::OpenFolderColumn) {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(tableModel->folderPath(index.row())));
     }
 }
 
@@ -214,211 +501,335 @@ void crcCalculate::onTableItemClicked(int row, int column)
 ***************************************************************************************************/
 void crcCalculate::on_btnClear_clicked()
 {
-    ui->tableWidget->setRowCount(0);
+    walker->cancel();
+    verifier->cancel();
+    finder->cancel();
+    watcher->clear();
+    ui->btnDuplicates->setEnabled(true);
+    scheduler->cancelAll();
+    pendingFiles.clear();
+    staleFiles.clear();
+    importedFolders.clear();
+    verifyEntries.clear();
+    progressFiles.clear();
+    tableModel->clear();
 }
 
-
 /***************************************************************************************************
-* @description : This function finds row index by file path.
-* @param : const QString &fullFilePath
-* @return : int
+* @description : This function shows the progress of files being read in their rows and the
+*                overall progress in the status line. Once everything is done the line keeps the
+*                summary of the run until new files are queued.
+* @param : None
+* @return : void
 * @Author : Ritesh Pandit
 ***************************************************************************************************/
-int crcCalculate::findRowByPath(const QString &fullFilePath)
+void crcCalculate::onStatisticsTimer()
 {
-    for(int row = 0; row < ui->tableWidget->rowCount(); ++row) {
-        QTableWidgetItem *item = ui->tableWidget->item(row, 0);
-        if (item && item->data(Qt::UserRole).toString() == fullFilePath) {
-            return row;
-        }
+    const hashStatistics::snapshot statistics = hashStatistics::instance().current();
+
+    QSet<QString> active;
+    for (const hashStatistics::fileProgress &file : statistics.activeFiles) {
+        // Small files finish between two refreshes, a bar would only flicker
+        if (file.size <= checksumEngine::SmallFileSize) continue;
+
+        int row = tableModel->rowOf(file.filePath);
+        if (row == -1) continue;
+
+        QString filePath = tableModel->filePath(row);
+        active.insert(filePath);
+        tableModel->setProgress(row, int(file.bytesDone * 1000 / file.size), file.mbPerSecond);
     }
-    return -1;
-}
+    for (const QString &filePath : qAsConst(progressFiles)) {
+        if (!active.contains(filePath)) tableModel->setProgress(tableModel->rowOf(filePath), -1, 0);
+    }
+    progressFiles = active;
+
+    const bool idle = statistics.queueDepth == 0 && statistics.activeFiles.isEmpty();
+    if (idle && statusIdle) return;
 
+    statusIdle = idle;
+    ui->lblStatus->setText(statistics.filesQueued > 0 ? statistics.statusText() : tr("Ready"));
+}
 
 /***************************************************************************************************
- *	@description	:   This function will process file and update table widget.
- *	@param			:   const QString &fileName
- *	@return			:   void
- *	@Author      	:   Ritesh Pandit
- ***************************************************************************************************/
-void crcCalculate::processFile(const QString &fileName)
+* @description : This function handles verify list button click event. The listed files are added
+*                to the table and checked on the verifier's pool. Each file is read once for the
+*                listed checksum and the displayed ones, so they are not queued for hashing too.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::on_btnVerify_clicked()
 {
-    QFileInfo fi(fileName);
-
-    if (fi.isDir()) return;
+    QString manifestPath = QFileDialog::getOpenFileName(
+        this,
+        tr("Select Checksum List"),
+        "",
+        tr("Checksum Lists (*.sha256 *.sha256sum *.sha1 *.sha1sum *.md5 *.md5sum *.sfv *.crc *.crc32 *.crc16);;"
+           "All Files (*)")
+        );
+    if (manifestPath.isEmpty()) return;
 
-    QString resultHex = CalculateChecksum(fileName);
+    QVector<checksumManifest::entry> entries;
+    QString error;
+    if (!checksumManifest::load(manifestPath, &entries, &error)) {
+        QMessageBox::warning(this, tr("Verify List"), error);
+        return;
+    }
 
-    int row = findRowByPath(fileName);
+    checksumDatabase::instance().refresh();
 
-    if (row == -1) {
-        row = ui->tableWidget->rowCount();
-        ui->tableWidget->insertRow(row);
+    QStringList filePaths;
+    filePaths.reserve(entries.size());
+    for (const checksumManifest::entry &item : qAsConst(entries)) {
+        filePaths.append(item.filePath);
     }
 
+    tableModel->clearStatus();
+    tableModel->addFiles(filePaths, PendingChecksumText);
+    for (const checksumManifest::entry &item : qAsConst(entries)) {
+        int row = tableModel->rowOf(item.filePath);
+        tableModel->setChecksum(row, PendingChecksumText);
+        pendingFiles.insert(tableModel->filePath(row));
+    }
 
+    verifyEntries = entries;
+    verifier->setExtraTypes(requestedTypes());
+    verifier->setStopOnFailure(ui->chkStopOnFailure->isChecked());
+    verifier->start(entries);
+}
 
-    QTableWidgetItem *nameItem = new QTableWidgetItem(fi.fileName());
-    nameItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-    nameItem->setData(Qt::UserRole, fileName);
-    ui->tableWidget->setItem(row, 0, nameItem);
+/***************************************************************************************************
+* @description : This function shows the outcome of checked entries and the checksums computed
+*                along the way.
+* @param : const QVector<manifestVerifier::result> &results, int runGeneration
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::onEntriesVerified(const QVector<manifestVerifier::result> &results, int runGeneration)
+{
+    if (runGeneration != verifier->generation()) return;
+
+    QStringList again;
+    for (const manifestVerifier::result &result : results) {
+        const checksumManifest::entry &item = verifyEntries.at(result.index);
+        int row = tableModel->rowOf(item.filePath);
+        tableModel->setStatus(row, result.status, item.expected);
+
+        if (result.status == manifestVerifier::Missing) {
+            pendingFiles.remove(tableModel->filePath(row));
+            tableModel->setChecksum(row, "ERROR");
+        } else if (applyResult(result.hashed)) {
+            again.append(result.hashed.filePath);
+        }
+    }
+    queueFiles(again);
+}
 
-    QTableWidgetItem *crcItem = new QTableWidgetItem(resultHex);
-    crcItem->setForeground(QBrush(QColor("#0067c0")));
-    QFont largeFont("Segoe UI", 16, QFont::Bold);
-    largeFont.setLetterSpacing(QFont::AbsoluteSpacing, 1.5);
-    crcItem->setFont(largeFont);
-    crcItem->setTextAlignment(Qt::AlignCenter);
-    crcItem->setToolTip("Click to copy Checksum");
-    ui->tableWidget->setItem(row, 1, crcItem);
+/***************************************************************************************************
+* @description : This function reports the end of a check. Files skipped after a failure are
+*                queued for hashing like any other file.
+* @param : int passed, int failed, int missing, int runGeneration
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::onVerifyFinished(int passed, int failed, int missing, int runGeneration)
+{
+    if (runGeneration != verifier->generation()) return;
 
-    QTableWidgetItem *pathItem = new QTableWidgetItem(fi.absolutePath());
-    pathItem->setForeground(QBrush(QColor("#666666")));
-    pathItem->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-    ui->tableWidget->setItem(row, 2, pathItem);
+    QStringList skipped;
+    for (const checksumManifest::entry &item : qAsConst(verifyEntries)) {
+        int row = tableModel->rowOf(item.filePath);
+        if (tableModel->status(row) != manifestVerifier::Pending) continue;
 
-    QPushButton *openBtn = new QPushButton();
-    openBtn->setIcon(style()->standardIcon(QStyle::SP_DirIcon));
-    openBtn->setToolTip("Open File Location");
-    openBtn->setObjectName("btnOpenFolder");
-    openBtn->setCursor(Qt::PointingHandCursor);
+        QString filePath = tableModel->filePath(row);
+        pendingFiles.remove(filePath);
+        skipped.append(filePath);
+    }
+    queueFiles(skipped);
 
-    QString folderPath = fi.absolutePath();
-    connect(openBtn, &QPushButton::clicked, [folderPath](){
-        QDesktopServices::openUrl(QUrl::fromLocalFile(folderPath));
-    });
+    QString summary = tr("%1 OK, %2 mismatched, %3 missing or unreadable").arg(passed).arg(failed).arg(missing);
+    if (!skipped.isEmpty()) summary += tr(", %1 not checked").arg(skipped.size());
 
-    ui->tableWidget->setCellWidget(row, 3, openBtn);
+    if (failed == 0 && missing == 0) {
+        QMessageBox::information(this, tr("Verify List"), summary);
+    } else {
+        QMessageBox::warning(this, tr("Verify List"), summary);
+    }
 }
 
 /***************************************************************************************************
- *	@description	:   This function will calculate CRC checksum for given file.
- *	@param			:   const QString &filePath
- *	@return			:   QString
- *	@Author      	:   Ritesh Pandit
- ***************************************************************************************************/
-QString crcCalculate::CalculateChecksum(const QString &filePath)
+* @description : This function handles export list button click event. The list type follows the
+*                chosen file extension, files without a calculated checksum of that type are
+*                left out.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::on_btnExport_clicked()
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) return "ERROR";
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    unsigned char* memblock = reinterpret_cast<unsigned char*>(data.data());
-    qint64 size = data.size();
+    if (tableModel->rowCount() == 0) return;
+
+    static const QStringList filters = QStringList()
+        << "CRC-16 (*.crc16)" << "CRC-32 (*.crc32)" << "MD5 (*.md5)" << "SHA-1 (*.sha1)"
+        << "SHA-256 (*.sha256)" << "CRC-32C (*.crc32c)" << "CRC-64 (*.crc64)" << "XXH3-64 (*.xxh3)"
+        << "XXH3-128 (*.xxh128)" << "BLAKE3 (*.blake3)" << "SFV (*.sfv)";
+    static const QStringList suffixes = QStringList()
+        << "crc16" << "crc32" << "md5" << "sha1" << "sha256" << "crc32c" << "crc64" << "xxh3" << "xxh128"
+        << "blake3" << "sfv";
+
+    QString selectedFilter = filters.value(ui->checksumCombo->currentIndex(), filters.last());
+    QString manifestPath = QFileDialog::getSaveFileName(this, tr("Export Checksum List"), "",
+                                                        filters.join(";;"), &selectedFilter);
+    if (manifestPath.isEmpty()) return;
+
+    checksumEngine::ChecksumType type;
+    checksumManifest::Format format;
+    if (!checksumManifest::typeFromFileName(manifestPath, &type, &format)) {
+        manifestPath += "." + suffixes.value(filters.indexOf(selectedFilter), "sha256");
+        checksumManifest::typeFromFileName(manifestPath, &type, &format);
+    }
 
-    QString result;
-    switch(currentType) {
-        case CRC16: {
-            unsigned short checkSumVal = computeCrc(memblock, size);
-            result = QString("%1").arg(checkSumVal, 4, 16, QChar('0')).toUpper();
-            break;
+    QVector<checksumManifest::entry> entries;
+    int skipped = 0;
+    for (int row = 0; row < tableModel->rowCount(); ++row) {
+        QString filePath = tableModel->filePath(row);
+        QString checksum = checksumCache.value(filePath).checksums.value(type);
+        if (checksum.isEmpty()) {
+            ++skipped;
+            continue;
         }
-        case CRC32: {
-            unsigned int checkSumVal = computeCrc32(data);
-            result = QString("%1").arg(checkSumVal, 8, 16, QChar('0')).toUpper();
-            break;
-        }
-        case MD5: {
-            QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Md5);
-            result = hash.toHex().toUpper();
-            break;
-        }
-        case SHA1: {
-            QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
-            result = hash.toHex().toUpper();
-            break;
-        }
-        case SHA256: {
-            QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
-            result = hash.toHex().toUpper();
-            break;
-        }
-        default:
-            result = "UNKNOWN";
+        entries.append(checksumManifest::entry{ QString(), filePath, checksum, type });
     }
 
-    return result;
+    QString error;
+    if (!checksumManifest::save(manifestPath, format, entries, &error)) {
+        QMessageBox::warning(this, tr("Export List"), error);
+    } else if (skipped > 0) {
+        QMessageBox::information(this, tr("Export List"),
+                                 tr("%1 files were left out because their %2 checksum is not calculated yet.")
+                                     .arg(skipped).arg(checksumEngine::typeName(type).toUpper()));
+    }
 }
 
 /***************************************************************************************************
-* @description : This function will compute CRC32 value.
-* @param : const QByteArray &data
-* @return : unsigned int
+* @description : This function handles find duplicates button click event. Every listed file
+*                takes part, confirmed with the selected checksum when it is long enough.
+* @param : None
+* @return : void
 * @Author : Ritesh Pandit
 ***************************************************************************************************/
-unsigned int crcCalculate::computeCrc32(const QByteArray &data)
+void crcCalculate::on_btnDuplicates_clicked()
 {
-    // Standard CRC-32 polynomial 0xEDB88320
-    static const unsigned int crc32Table[256] = {
-        0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
-        0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
-        0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-        0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
-        0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
-        0x35B530AC, 0x42B2003A, 0xDBBBC180, 0xACBCF116, 0x32D8F4B5, 0x45DFC423, 0xDDD69599, 0xAAD1A50F,
-        0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
-        0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
-        0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-        0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
-        0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
-        0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-        0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
-        0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
-        0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-        0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
-        0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
-        0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-        0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
-        0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
-        0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-        0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
-        0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
-        0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-        0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
-        0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
-        0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-        0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
-        0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
-        0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-        0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
-        0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
-    };
-
-    unsigned int crc = 0xFFFFFFFF;
-    const unsigned char *p = (const unsigned char *)data.constData();
-    for (int i = 0; i < data.size(); ++i) {
-        crc = (crc >> 8) ^ crc32Table[(crc ^ p[i]) & 0xFF];
+    if (tableModel->rowCount() == 0) return;
+
+    QStringList filePaths;
+    filePaths.reserve(tableModel->rowCount());
+    for (int row = 0; row < tableModel->rowCount(); ++row) {
+        filePaths.append(tableModel->filePath(row));
     }
-    return crc ^ 0xFFFFFFFF;
+
+    checksumDatabase::instance().refresh();
+
+    ui->btnDuplicates->setEnabled(false);
+    finder->setChecksumType(currentType);
+    finder->start(filePaths);
 }
 
 /***************************************************************************************************
- *	@description	:   This function will compute CRC value.
- *	@param			:   unsigned char *message, qint64 blk_len
- *	@return			:   unsigned short
- *	@Author      	:   Ritesh Pandit
- ***************************************************************************************************/
-unsigned short crcCalculate::computeCrc(unsigned char *message, qint64 blk_len)
+* @description : This function shows the outcome of a duplicate search.
+* @param : const QVector<duplicateFinder::group> &groups, const duplicateFinder::summary &counters,
+*          int runGeneration
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::onDuplicatesFound(const QVector<duplicateFinder::group> &groups,
+                                     const duplicateFinder::summary &counters, int runGeneration)
 {
+    if (runGeneration != finder->generation()) return;
 
-    unsigned short crctable[256] = {0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022,0x8063, 0x0066, 0x006C, 0x8069, 0x0078, 0x807D, 0x8077, 0x0072,0x0050, 0x8055, 0x805F, 0x005A, 0x804B, 0x004E, 0x0044, 0x8041,0x80C3, 0x00C6, 0x00CC, 0x80C9, 0x00D8, 0x80DD, 0x80D7, 0x00D2,0x00F0, 0x80F5, 0x80FF, 0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1,0x00A0, 0x80A5, 0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1,0x8093, 0x0096, 0x009C, 0x8099, 0x0088, 0x808D, 0x8087, 0x0082,0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197, 0x0192,0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE, 0x01A4, 0x81A1,0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB, 0x01FE, 0x01F4, 0x81F1,0x81D3, 0x01D6, 0x01DC, 0x81D9, 0x01C8, 0x81CD, 0x81C7, 0x01C2,0x0140, 0x8145, 0x814F, 0x014A, 0x815B, 0x015E, 0x0154, 0x8151,0x8173, 0x0176, 0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162,0x8123, 0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104, 0x8101,0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D, 0x8317, 0x0312,0x0330, 0x8335, 0x833F, 0x033A, 0x832B, 0x032E, 0x0324, 0x8321,0x0360, 0x8365, 0x836F, 0x036A, 0x837B, 0x037E, 0x0374, 0x8371,0x8353, 0x0356, 0x035C, 0x8359, 0x0348, 0x834D, 0x8347, 0x0342,0x03C0, 0x83C5, 0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1, 0x83F3, 0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2,0x83A3, 0x03A6, 0x03AC, 0x83A9, 0x03B8, 0x83BD, 0x83B7, 0x03B2,0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E, 0x0384, 0x8381,0x0280, 0x8285, 0x828F, 0x028A, 0x829B, 0x029E, 0x0294, 0x8291,0x82B3, 0x02B6, 0x02BC, 0x82B9, 0x02A8, 0x82AD, 0x82A7, 0x02A2,0x82E3, 0x02E6, 0x02EC, 0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2,0x02D0, 0x82D5, 0x82DF, 0x02DA, 0x82CB, 0x02CE, 0x02C4, 0x82C1,0x8243, 0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252,0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264, 0x8261,0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231,0x8213, 0x0216, 0x021C, 0x8219, 0x0208, 0x820D, 0x8207, 0x0202};
+    ui->btnDuplicates->setEnabled(true);
+    if (groups.isEmpty()) {
+        QMessageBox::information(this, tr("Find Duplicates"), tr("No duplicates found.\n\n%1").arg(counters.text()));
+        return;
+    }
+    showDuplicateGroups(groups, counters);
+}
 
-    unsigned char index;
-    unsigned long crc = 0L;
-    unsigned char *blk_adr;
+/***************************************************************************************************
+* @description : This function lists duplicate groups in a dialog, one expandable item per group
+*                with its size and checksum, the copies below it.
+* @param : const QVector<duplicateFinder::group> &groups, const duplicateFinder::summary &counters
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void crcCalculate::showDuplicateGroups(const QVector<duplicateFinder::group> &groups,
+                                       const duplicateFinder::summary &counters)
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Duplicate Files"));
+    dialog.resize(900, 500);
+
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QLabel *summaryLabel = new QLabel(counters.text(), &dialog);
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    QTreeWidget *tree = new QTreeWidget(&dialog);
+    tree->setHeaderLabels(QStringList() << tr("File") << tr("Size") << tr("Checksum"));
+    tree->setUniformRowHeights(true);
+    for (const duplicateFinder::group &duplicates : groups) {
+        QTreeWidgetItem *groupItem = new QTreeWidgetItem(tree);
+        groupItem->setText(0, tr("%1 copies").arg(duplicates.filePaths.size()));
+        groupItem->setText(1, QLocale().toString(duplicates.size));
+        groupItem->setText(2, duplicates.checksum);
+        for (const QString &filePath : duplicates.filePaths) {
+            QTreeWidgetItem *fileItem = new QTreeWidgetItem(groupItem);
+            fileItem->setText(0, QDir::toNativeSeparators(filePath));
+            fileItem->setData(0, Qt::UserRole, filePath);
+        }
+        groupItem->setExpanded(true);
+    }
+    tree->resizeColumnToContents(1);
+    layout->addWidget(tree);
 
-    blk_adr = message;
+    connect(tree, &QTreeWidget::itemDoubleClicked, &dialog, [](QTreeWidgetItem *item, int) {
+        const QString filePath = item->data(0, Qt::UserRole).toString();
+        if (filePath.isEmpty()) return;
+        QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(filePath).absolutePath()));
+    });
 
-    while(blk_len != 0)
-    {
-        index = ((crc >> 8) ^ *blk_adr++) & 0xFFL;
-        crc = crctable[index] ^ (crc << 8);
-        blk_len--;
-    }
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close, &dialog);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addWidget(buttons);
 
-    return (static_cast<unsigned short>(crc));
+    dialog.exec();
 }
 
+
+/***************************************************************************************************
+ *	@description	:   This function will add rows for new files and queue those without a
+ *	                    cached checksum. Adding a listed file again refreshes it: a worker checks
+ *	                    it against the database and hashes it again if it changed.
+ *	@param			:   const QStringList &filePaths
+ *	@return			:   void
+ *	@Author      	:   Ritesh Pandit
+ ***************************************************************************************************/
+void crcCalculate::processFiles(const QStringList &filePaths)
+{
+    const QStringList added = tableModel->addFiles(filePaths, PendingChecksumText);
+    const QSet<QString> newFiles(added.constBegin(), added.constEnd());
+
+    QVector<QPair<int, QString>> checksums;
+    checksums.reserve(filePaths.size());
+    QStringList queued;
+    for (const QString &filePath : filePaths) {
+        int row = tableModel->rowOf(filePath);
+        QString listedPath = tableModel->filePath(row);
+        QString checksum = cachedChecksum(listedPath);
+        if (checksum.isEmpty() || !newFiles.contains(listedPath)) queued.append(listedPath);
+        checksums.append(qMakePair(row, checksum.isEmpty() ? PendingChecksumText : checksum));
+    }
+    tableModel->setChecksums(checksums);
+    queueFiles(queued);
+}
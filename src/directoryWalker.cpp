@@ -0,0 +1,474 @@
+#include "directoryWalker.h"
+#include "fileIdentity.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+
+#include <algorithm>
+
+// Runs directoryWalker::work on a pool thread
+class directoryWalker::walkJob : public QRunnable
+{
+public:
+    explicit walkJob(directoryWalker *walker) : walker(walker) {}
+    void run() override { walker->work(); }
+
+private:
+    directoryWalker *walker;
+};
+
+/***************************************************************************************************
+* @description : Constructor for directoryWalker class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+directoryWalker::directoryWalker(QObject *parent)
+    : QObject(parent)
+    , activeWorkers(0)
+    , busyWorkers(0)
+    , threadCount(qMax(2, QThread::idealThreadCount()))
+    , currentGeneration(0)
+    , cancelled(false)
+    , followSymlinks(false)
+{
+    pool.setMaxThreadCount(threadCount);
+}
+
+/***************************************************************************************************
+* @description : Destructor for directoryWalker class.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+directoryWalker::~directoryWalker()
+{
+    cancel();
+    pool.waitForDone();
+}
+
+/***************************************************************************************************
+* @description : This function sets the include and exclude glob lists used by walks started
+*                from now on.
+* @param : const QString &include, const QString &exclude
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::setFilters(const QString &include, const QString &exclude)
+{
+    pathFilter compiled(include, exclude);
+
+    QMutexLocker locker(&mutex);
+    nextFilter = compiled;
+}
+
+/***************************************************************************************************
+* @description : This function sets whether symbolic links to directories are entered.
+* @param : bool follow
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::setFollowSymlinks(bool follow)
+{
+    QMutexLocker locker(&mutex);
+    followSymlinks = follow;
+}
+
+/***************************************************************************************************
+* @description : This function sets the number of walking threads.
+* @param : int count
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::setThreadCount(int count)
+{
+    QMutexLocker locker(&mutex);
+    threadCount = qMax(1, count);
+    pool.setMaxThreadCount(threadCount);
+}
+
+/***************************************************************************************************
+* @description : This function reports the given files right away and queues the directories.
+*                A new walk starts with fresh loop detection and the latest filters; adding to a
+*                running walk just wakes its threads. While threads of a cancelled walk finish
+*                the directory they are listing, which may take long on a network share, the
+*                directories are held back and the last of those threads starts them, so the
+*                caller on the GUI thread never waits.
+* @param : const QStringList &paths
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::add(const QStringList &paths)
+{
+    QStringList files;
+    QVector<pendingDirectory> directories;
+    for (const QString &path : paths) {
+        QFileInfo fi(path);
+        if (fi.isDir()) {
+            QString root = QDir::cleanPath(QDir::fromNativeSeparators(path));
+            directories.append(makeDirectory(root, root.endsWith('/') ? root.size() : root.size() + 1));
+        } else if (fi.exists()) {
+            files.append(path);
+        }
+    }
+
+    if (!files.isEmpty()) emit filesFound(files, generation());
+    if (directories.isEmpty()) return;
+
+    QMutexLocker locker(&mutex);
+    if (cancelled && activeWorkers > 0) {
+        deferred += directories;
+        return;
+    }
+    startLocked(directories);
+}
+
+/***************************************************************************************************
+* @description : This function queues root directories and fills the pool with walking threads.
+*                When no thread is running a new walk starts with fresh loop detection and the
+*                latest filters. Must be called with the mutex held.
+* @param : const QVector<pendingDirectory> &directories
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::startLocked(const QVector<pendingDirectory> &directories)
+{
+    if (activeWorkers == 0) {
+        cancelled = false;
+        visited.clear();
+        visitedPaths.clear();
+        filter = nextFilter;
+    }
+
+    for (const pendingDirectory &directory : directories) {
+        if (markVisited(directory)) queue.append(directory);
+    }
+
+    while (activeWorkers < threadCount) {
+        ++activeWorkers;
+        pool.start(new walkJob(this));
+    }
+    workAvailable.wakeAll();
+}
+
+/***************************************************************************************************
+* @description : This function stops the walk. Threads finish the directory they are listing
+*                and leave without reporting it.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::cancel()
+{
+    QMutexLocker locker(&mutex);
+    cancelled = true;
+    ++currentGeneration;
+    queue.clear();
+    deferred.clear();
+    workAvailable.wakeAll();
+}
+
+/***************************************************************************************************
+* @description : This function blocks until every walking thread has left, including the
+*                finished() emission of the last one.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::waitForFinished()
+{
+    {
+        QMutexLocker locker(&mutex);
+        while (activeWorkers > 0) {
+            walkFinished.wait(&mutex);
+        }
+    }
+    pool.waitForDone();
+}
+
+/***************************************************************************************************
+* @description : This function tells whether directories are still being listed.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool directoryWalker::isRunning() const
+{
+    QMutexLocker locker(&mutex);
+    return activeWorkers > 0;
+}
+
+/***************************************************************************************************
+* @description : This function returns the walk generation, incremented by every cancel().
+* @param : None
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int directoryWalker::generation() const
+{
+    QMutexLocker locker(&mutex);
+    return currentGeneration;
+}
+
+/***************************************************************************************************
+* @description : This function is the loop of every walking thread. It takes the most recently
+*                queued directory, lists it and reports found files once BatchSize are collected
+*                or BatchIntervalMs have passed. The walk ends when the queue is empty and no
+*                thread is listing a directory that could queue more; the last thread to leave
+*                emits finished(), or starts the roots added after a cancel instead.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::work()
+{
+    QStringList batch;
+    QElapsedTimer sinceFlush;
+    sinceFlush.start();
+
+    int walkGeneration;
+    {
+        QMutexLocker locker(&mutex);
+        walkGeneration = currentGeneration;
+    }
+
+    while (true) {
+        pendingDirectory directory;
+        {
+            QMutexLocker locker(&mutex);
+            while (queue.isEmpty() && busyWorkers > 0 && !cancelled) {
+                workAvailable.wait(&mutex);
+            }
+            if (cancelled || queue.isEmpty()) {
+                workAvailable.wakeAll();
+                break;
+            }
+            directory = queue.takeLast();
+            ++busyWorkers;
+        }
+
+        listDirectory(directory, batch);
+
+        {
+            QMutexLocker locker(&mutex);
+            --busyWorkers;
+            if (busyWorkers == 0 && queue.isEmpty()) workAvailable.wakeAll();
+        }
+
+        if (batch.size() >= BatchSize || (!batch.isEmpty() && sinceFlush.elapsed() >= BatchIntervalMs)) {
+            emit filesFound(batch, walkGeneration);
+            batch.clear();
+            sinceFlush.restart();
+        }
+    }
+
+    bool wasCancelled;
+    {
+        QMutexLocker locker(&mutex);
+        wasCancelled = cancelled;
+    }
+    if (!batch.isEmpty() && !wasCancelled) emit filesFound(batch, walkGeneration);
+
+    bool last;
+    {
+        QMutexLocker locker(&mutex);
+        last = --activeWorkers == 0;
+        if (last && !deferred.isEmpty()) {
+            QVector<pendingDirectory> roots;
+            roots.swap(deferred);
+            startLocked(roots);
+            last = false;
+        }
+        if (last) walkFinished.wakeAll();
+    }
+    if (last) emit finished();
+}
+
+/***************************************************************************************************
+* @description : This function lists one directory. Matching files go into batch, subdirectories
+*                that are not excluded and were not entered before are queued. Entries are
+*                sorted so a single threaded walk is reproducible.
+* @param : const pendingDirectory &directory, QStringList &batch
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::listDirectory(const pendingDirectory &directory, QStringList &batch)
+{
+    bool follow;
+    {
+        QMutexLocker locker(&mutex);
+        follow = followSymlinks;
+    }
+
+    QStringList files;
+    QVector<pendingDirectory> subdirectories;
+
+    QDirIterator it(directory.path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        const QString path = fi.filePath();
+        const QString name = fi.fileName();
+        const QString relativePath = path.mid(directory.rootLength);
+
+        if (filter.excludes(name, relativePath)) continue;
+
+        if (fi.isDir()) {
+            if (fi.isSymLink() && !follow) continue;
+            subdirectories.append(makeDirectory(path, directory.rootLength));
+        } else if (fi.isFile()) {
+            if (filter.includes(name, relativePath)) files.append(path);
+        }
+    }
+
+    files.sort();
+    batch.append(files);
+    if (subdirectories.isEmpty()) return;
+
+    // Reverse order so the depth first queue hands out the first name first
+    std::sort(subdirectories.begin(), subdirectories.end(),
+              [](const pendingDirectory &a, const pendingDirectory &b) { return a.path > b.path; });
+
+    QMutexLocker locker(&mutex);
+    if (cancelled) return;
+    for (const pendingDirectory &subdirectory : qAsConst(subdirectories)) {
+        if (markVisited(subdirectory)) queue.append(subdirectory);
+    }
+    workAvailable.wakeAll();
+}
+
+/***************************************************************************************************
+* @description : This function reads the device and inode of a directory, following symlinks,
+*                so every path leading to the same directory gets the same key. Called without
+*                the mutex, the stat is the expensive part.
+* @param : const QString &path, int rootLength
+* @return : pendingDirectory
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+directoryWalker::pendingDirectory directoryWalker::makeDirectory(const QString &path, int rootLength)
+{
+    pendingDirectory directory;
+    directory.path = path;
+    directory.rootLength = rootLength;
+
+    fileIdentity identity;
+    if (fileIdentity::read(path, &identity) && (identity.inode != 0 || identity.device != 0)) {
+        directory.key = qMakePair(identity.device, identity.inode);
+    } else {
+        directory.key = qMakePair(quint64(0), quint64(0));
+        directory.canonicalPath = QFileInfo(path).canonicalFilePath();
+    }
+    return directory;
+}
+
+/***************************************************************************************************
+* @description : This function records a directory as entered, so a directory reached again
+*                through a symlink or bind mount is skipped. Must be called with the mutex held.
+* @param : const pendingDirectory &directory
+* @return : bool - false if the directory was already entered
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool directoryWalker::markVisited(const pendingDirectory &directory)
+{
+    if (directory.key.first != 0 || directory.key.second != 0) {
+        if (visited.contains(directory.key)) return false;
+        visited.insert(directory.key);
+        return true;
+    }
+
+    if (directory.canonicalPath.isEmpty() || visitedPaths.contains(directory.canonicalPath)) return false;
+    visitedPaths.insert(directory.canonicalPath);
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function compiles a ';' or ',' separated glob list. Patterns containing
+*                '/' are anchored to the path below the walked directory, the others to the
+*                file name. Matching is case insensitive on Windows.
+* @param : const QString &globs, QVector<QRegularExpression> *names, QVector<QRegularExpression> *paths
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void directoryWalker::compilePatterns(const QString &globs, QVector<QRegularExpression> *names,
+                                      QVector<QRegularExpression> *paths)
+{
+#ifdef Q_OS_WIN
+    const QRegularExpression::PatternOptions options = QRegularExpression::CaseInsensitiveOption;
+#else
+    const QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
+#endif
+
+    const QStringList patterns = globs.split(QRegularExpression("[;,]"));
+    for (QString pattern : patterns) {
+        pattern = QDir::fromNativeSeparators(pattern.trimmed());
+        if (pattern.isEmpty()) continue;
+
+        QRegularExpression expression(QRegularExpression::wildcardToRegularExpression(pattern), options);
+        expression.optimize();
+        if (pattern.contains('/')) {
+            paths->append(expression);
+        } else {
+            names->append(expression);
+        }
+    }
+}
+
+/***************************************************************************************************
+* @description : This function tells whether any name pattern matches the name or any path
+*                pattern matches the relative path.
+* @param : const QVector<QRegularExpression> &names, const QVector<QRegularExpression> &paths,
+*          const QString &name, const QString &relativePath
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool directoryWalker::matches(const QVector<QRegularExpression> &names, const QVector<QRegularExpression> &paths,
+                              const QString &name, const QString &relativePath)
+{
+    for (const QRegularExpression &expression : names) {
+        if (expression.match(name).hasMatch()) return true;
+    }
+    for (const QRegularExpression &expression : paths) {
+        if (expression.match(relativePath).hasMatch()) return true;
+    }
+    return false;
+}
+
+/***************************************************************************************************
+* @description : Constructor for pathFilter class, compiles both glob lists.
+* @param : const QString &include, const QString &exclude
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+directoryWalker::pathFilter::pathFilter(const QString &include, const QString &exclude)
+{
+    compilePatterns(include, &includeNames, &includePaths);
+    compilePatterns(exclude, &excludeNames, &excludePaths);
+}
+
+/***************************************************************************************************
+* @description : This function tells whether an entry matches the exclude list.
+* @param : const QString &name, const QString &relativePath
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool directoryWalker::pathFilter::excludes(const QString &name, const QString &relativePath) const
+{
+    return matches(excludeNames, excludePaths, name, relativePath);
+}
+
+/***************************************************************************************************
+* @description : This function tells whether a file passes the include list, an empty list
+*                passes every file.
+* @param : const QString &name, const QString &relativePath
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool directoryWalker::pathFilter::includes(const QString &name, const QString &relativePath) const
+{
+    if (includeNames.isEmpty() && includePaths.isEmpty()) return true;
+    return matches(includeNames, includePaths, name, relativePath);
+}
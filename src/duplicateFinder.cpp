@@ -0,0 +1,412 @@
+#include "duplicateFinder.h"
+#include "checksumDatabase.h"
+#include "fileIdentity.h"
+#include "hashStatistics.h"
+
+#include <QHash>
+#include <QPair>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QSet>
+#include <QThread>
+
+#include <algorithm>
+
+// State of one run, shared by its threads so a new run never touches the old one's data
+struct duplicateFinder::findRun
+{
+    int generation = 0;
+    checksumEngine::ChecksumType type = checksumEngine::SHA256;
+    checksumEngine::IoBackend backend = checksumEngine::BufferedIo;
+    bool useDatabase = true;
+    qint64 minimumSize = 1;
+    QStringList filePaths;
+    QAtomicInt cancelled;
+};
+
+// Runs a piece of a run on the pool
+class duplicateFinder::findJob : public QRunnable
+{
+public:
+    explicit findJob(const std::function<void()> &work)
+        : work(work)
+    {
+    }
+
+    void run() override
+    {
+        work();
+    }
+
+private:
+    std::function<void()> work;
+};
+
+/***************************************************************************************************
+* @description : Constructor for duplicateFinder class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+duplicateFinder::duplicateFinder(QObject *parent)
+    : QObject(parent)
+    , currentGeneration(0)
+    , type(checksumEngine::SHA256)
+    , backend(checksumEngine::BufferedIo)
+    , useDatabase(true)
+    , minimumSize(1)
+{
+    qRegisterMetaType<duplicateFinder::group>();
+    qRegisterMetaType<duplicateFinder::summary>();
+    qRegisterMetaType<QVector<duplicateFinder::group>>("QVector<duplicateFinder::group>");
+
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+/***************************************************************************************************
+* @description : Destructor for duplicateFinder class.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+duplicateFinder::~duplicateFinder()
+{
+    cancel();
+    pool.waitForDone();
+}
+
+/***************************************************************************************************
+* @description : This function sets the checksum type that confirms a duplicate. CRCs and
+*                XXH3-64 are too short to tell millions of files apart.
+* @param : checksumEngine::ChecksumType type
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::setChecksumType(checksumEngine::ChecksumType type)
+{
+    this->type = checksumEngine::digestLength(type) >= 32 ? type : checksumEngine::SHA256;
+}
+
+/***************************************************************************************************
+* @description : This function sets how files are read.
+* @param : checksumEngine::IoBackend backend
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::setBackend(checksumEngine::IoBackend backend)
+{
+    this->backend = backend;
+}
+
+/***************************************************************************************************
+* @description : This function sets whether full checksums of unchanged files are taken from the
+*                persistent checksum database and new ones stored there.
+* @param : bool use
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::setUseDatabase(bool use)
+{
+    useDatabase = use;
+}
+
+/***************************************************************************************************
+* @description : This function sets the size below which files are ignored.
+* @param : qint64 size
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::setMinimumSize(qint64 size)
+{
+    minimumSize = qMax<qint64>(0, size);
+}
+
+/***************************************************************************************************
+* @description : This function sets the number of files read at the same time.
+* @param : int count
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::setThreadCount(int count)
+{
+    pool.setMaxThreadCount(qMax(1, count));
+}
+
+/***************************************************************************************************
+* @description : This function starts a run. Threads of a cancelled run keep their own state
+*                and finish in the background, so starting never blocks on a large file.
+* @param : const QStringList &filePaths
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::start(const QStringList &filePaths)
+{
+    cancel();
+
+    QSharedPointer<findRun> run(new findRun);
+    run->generation = currentGeneration.loadAcquire();
+    run->type = type;
+    run->backend = backend;
+    run->useDatabase = useDatabase;
+    run->minimumSize = minimumSize;
+    run->filePaths = filePaths;
+    currentRun = run;
+
+    pool.start(new findJob([this, run]() { find(run); }));
+}
+
+/***************************************************************************************************
+* @description : This function stops the current run.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::cancel()
+{
+    currentGeneration.fetchAndAddOrdered(1);
+    if (!currentRun.isNull()) currentRun->cancelled.storeRelease(1);
+}
+
+/***************************************************************************************************
+* @description : This function blocks until no thread of any run is left.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::waitForFinished()
+{
+    pool.waitForDone();
+}
+
+/***************************************************************************************************
+* @description : This function returns the generation of the current run.
+* @param : None
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int duplicateFinder::generation() const
+{
+    return currentGeneration.loadAcquire();
+}
+
+/***************************************************************************************************
+* @description : This function runs the three stages of a run:
+*                1. stat every file once and group the files by size, hard links by inode,
+*                2. hash the first and last SampleSize bytes of files that share a size,
+*                3. fully hash the files whose samples still collide, largest first.
+*                Files of at most two samples skip stage 2, their sample would be the whole file.
+*                Every stage only keeps groups of at least two distinct files.
+* @param : const QSharedPointer<findRun> &run
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::find(const QSharedPointer<findRun> &run)
+{
+    summary counters;
+
+    // Stage 1: sizes
+    QVector<fileIdentity> files;
+    QSet<QString> seen;
+    for (const QString &filePath : qAsConst(run->filePaths)) {
+        if (run->cancelled.loadAcquire()) return;
+        if (seen.contains(filePath)) continue;
+        seen.insert(filePath);
+
+        fileIdentity identity;
+        if (!fileIdentity::read(filePath, &identity)) {
+            ++counters.unreadable;
+            continue;
+        }
+        ++counters.files;
+        counters.totalBytes += identity.size;
+        if (identity.size >= run->minimumSize) files.append(identity);
+    }
+    if (run->cancelled.loadAcquire()) return;
+
+    // Hard links share one representative that is read for all of them
+    QHash<QPair<quint64, quint64>, int> firstLink;
+    QHash<int, QVector<int>> links;
+    QHash<qint64, QVector<int>> bySize;
+    for (int i = 0; i < files.size(); ++i) {
+        const fileIdentity &identity = files.at(i);
+        if (identity.inode != 0) {
+            const QPair<quint64, quint64> key(identity.device, identity.inode);
+            auto link = firstLink.constFind(key);
+            if (link != firstLink.constEnd()) {
+                links[link.value()].append(i);
+                continue;
+            }
+            firstLink.insert(key, i);
+        }
+        bySize[identity.size].append(i);
+    }
+
+    QVector<QVector<int>> candidates;
+    for (auto it = bySize.constBegin(); it != bySize.constEnd(); ++it) {
+        if (it.value().size() < 2) continue;
+        candidates.append(it.value());
+        counters.sizeCandidates += it.value().size();
+    }
+
+    // Stage 2: samples of both ends
+    QVector<int> sampled;
+    for (const QVector<int> &candidate : qAsConst(candidates)) {
+        if (files.at(candidate.first()).size > 2 * SampleSize) sampled += candidate;
+    }
+
+    QVector<QString> samples(files.size());
+    QString *sampleData = samples.data();
+    forEachParallel(sampled.size(), [&](int k) {
+        if (run->cancelled.loadAcquire()) return;
+        const int i = sampled.at(k);
+        sampleData[i] = checksumEngine::CalculateSampleChecksum(files.at(i).path, SampleSize);
+    });
+    if (run->cancelled.loadAcquire()) return;
+    counters.bytesHashed += sampled.size() * 2 * SampleSize;
+
+    QVector<QVector<int>> fullCandidates;
+    for (const QVector<int> &candidate : qAsConst(candidates)) {
+        if (files.at(candidate.first()).size <= 2 * SampleSize) {
+            fullCandidates.append(candidate);
+            continue;
+        }
+        QHash<QString, QVector<int>> bySample;
+        for (int i : candidate) {
+            if (samples.at(i) == "ERROR") {
+                ++counters.unreadable;
+                continue;
+            }
+            bySample[samples.at(i)].append(i);
+        }
+        for (auto it = bySample.constBegin(); it != bySample.constEnd(); ++it) {
+            if (it.value().size() >= 2) fullCandidates.append(it.value());
+        }
+    }
+
+    // Stage 3: full checksums of what is left, largest first so no big file runs alone at the end
+    QVector<int> hashed;
+    for (const QVector<int> &candidate : qAsConst(fullCandidates)) {
+        hashed += candidate;
+    }
+    std::stable_sort(hashed.begin(), hashed.end(), [&files](int a, int b) {
+        return files.at(a).size > files.at(b).size;
+    });
+    counters.fullCandidates = hashed.size();
+
+    QVector<QString> checksums(files.size());
+    QString *checksumData = checksums.data();
+    hashStatistics::instance().addQueued(hashed.size());
+    forEachParallel(hashed.size(), [&](int k) {
+        const int i = hashed.at(k);
+        if (!run->cancelled.loadAcquire()) {
+            const QVector<checksumEngine::ChecksumType> types = QVector<checksumEngine::ChecksumType>() << run->type;
+            const QHash<int, QString> result = run->useDatabase
+                ? checksumDatabase::instance().checksums(files.at(i), types, run->backend, false)
+                : checksumEngine::CalculateChecksums(files.at(i).path, types, run->backend);
+            checksumData[i] = result.value(run->type, "ERROR");
+        }
+        hashStatistics::instance().addCompleted(1);
+    });
+    if (run->cancelled.loadAcquire()) return;
+
+    // Groups of equal checksums, with the hard links of every member
+    QVector<QPair<qint64, group>> found;
+    for (const QVector<int> &candidate : qAsConst(fullCandidates)) {
+        QHash<QString, QVector<int>> byChecksum;
+        for (int i : candidate) {
+            counters.bytesHashed += files.at(i).size;
+            if (checksums.at(i) == "ERROR") {
+                ++counters.unreadable;
+                continue;
+            }
+            byChecksum[checksums.at(i)].append(i);
+        }
+
+        for (auto it = byChecksum.constBegin(); it != byChecksum.constEnd(); ++it) {
+            const QVector<int> &members = it.value();
+            if (members.size() < 2) continue;
+
+            group duplicates;
+            duplicates.size = files.at(members.first()).size;
+            duplicates.checksum = it.key();
+            for (int i : members) {
+                duplicates.filePaths << files.at(i).path;
+                for (int link : links.value(i)) {
+                    duplicates.filePaths << files.at(link).path;
+                }
+            }
+            duplicates.filePaths.sort();
+
+            const qint64 wasted = duplicates.size * (members.size() - 1);
+            ++counters.groups;
+            counters.redundantFiles += members.size() - 1;
+            counters.wastedBytes += wasted;
+            found.append(qMakePair(wasted, duplicates));
+        }
+    }
+
+    std::stable_sort(found.begin(), found.end(), [](const QPair<qint64, group> &a, const QPair<qint64, group> &b) {
+        if (a.first != b.first) return a.first > b.first;
+        return a.second.filePaths.first() < b.second.filePaths.first();
+    });
+    QVector<group> groups;
+    groups.reserve(found.size());
+    for (const QPair<qint64, group> &entry : qAsConst(found)) {
+        groups.append(entry.second);
+    }
+
+    if (run->generation != currentGeneration.loadAcquire()) return;
+    emit finished(groups, counters, run->generation);
+}
+
+/***************************************************************************************************
+* @description : This function spreads work over the pool. The calling thread, itself a pool
+*                thread, takes part, so at most maxThreadCount - 1 helpers are started. Helpers
+*                only start on threads that are free right now: one queued behind a run that
+*                blocks here would never run, e.g. while a cancelled run is still finishing.
+* @param : int count, const std::function<void(int)> &work
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void duplicateFinder::forEachParallel(int count, const std::function<void(int)> &work)
+{
+    QAtomicInt next(0);
+    auto loop = [&next, count, &work]() {
+        for (int i = next.fetchAndAddOrdered(1); i < count; i = next.fetchAndAddOrdered(1)) {
+            work(i);
+        }
+    };
+
+    const int wanted = qMax(0, qMin(pool.maxThreadCount(), count) - 1);
+    QSemaphore done;
+    int helpers = 0;
+    for (; helpers < wanted; ++helpers) {
+        findJob *helper = new findJob([&loop, &done]() {
+            loop();
+            done.release();
+        });
+        if (!pool.tryStart(helper)) {
+            delete helper;
+            break;
+        }
+    }
+    loop();
+    done.acquire(helpers);
+}
+
+/***************************************************************************************************
+* @description : This function formats the counters as one line.
+* @param : None
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString duplicateFinder::summary::text() const
+{
+    QString text = QString("%1 groups, %2 redundant copies, %3 wasted; read %4 of %5, %6 of %7 files fully hashed")
+                       .arg(groups).arg(redundantFiles)
+                       .arg(hashStatistics::formatBytes(wastedBytes))
+                       .arg(hashStatistics::formatBytes(bytesHashed)).arg(hashStatistics::formatBytes(totalBytes))
+                       .arg(fullCandidates).arg(files);
+    if (unreadable > 0) text += QString(", %1 unreadable").arg(unreadable);
+    return text;
+}
@@ -0,0 +1,65 @@
+#include "fileIdentity.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+/***************************************************************************************************
+* @description : This function stats a file. On Unix a single stat() gives size, nanosecond
+*                modification time, inode and device. On Windows the file index is read from an
+*                open handle.
+* @param : const QString &filePath, fileIdentity *identity
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool fileIdentity::read(const QString &filePath, fileIdentity *identity)
+{
+    identity->path = filePath;
+
+#if defined(Q_OS_UNIX)
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) != 0) return false;
+
+    identity->size = static_cast<qint64>(st.st_size);
+#if defined(Q_OS_DARWIN)
+    identity->modified = qint64(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif defined(Q_OS_LINUX)
+    identity->modified = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+    identity->modified = qint64(st.st_mtime) * 1000000000;
+#endif
+    identity->inode = static_cast<quint64>(st.st_ino);
+    identity->device = static_cast<quint64>(st.st_dev);
+    return true;
+#else
+    QFileInfo fi(filePath);
+    if (!fi.exists()) return false;
+
+    identity->size = fi.size();
+    identity->modified = fi.lastModified().toMSecsSinceEpoch() * 1000000;
+    identity->inode = 0;
+    identity->device = 0;
+
+#if defined(Q_OS_WIN)
+    HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(filePath).utf16()), 0,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle != INVALID_HANDLE_VALUE) {
+        BY_HANDLE_FILE_INFORMATION info;
+        if (GetFileInformationByHandle(handle, &info)) {
+            identity->inode = (quint64(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+            identity->device = info.dwVolumeSerialNumber;
+        }
+        CloseHandle(handle);
+    }
+#endif
+    return true;
+#endif
+}
@@ -0,0 +1,503 @@
+#include "folderWatcher.h"
+#include "fileIdentity.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <QFileSystemWatcher>
+#endif
+
+#ifdef Q_OS_LINUX
+// Events that can change what a directory listing shows. Writes are picked up when the file is
+// closed, a file that is created is reported by its close.
+static const uint32_t WatchEvents = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE
+                                    | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+// Lists directories on a pool thread and hands the listings back to the watcher's thread
+class folderWatcher::scanJob : public QRunnable
+{
+public:
+    scanJob(folderWatcher *watcher, const QVector<QPair<QString, watchRoot>> &directories, bool report,
+            int scanGeneration)
+        : watcher(watcher), directories(directories), report(report), scanGeneration(scanGeneration)
+    {
+    }
+
+    void run() override
+    {
+        QVector<listing> listings;
+        listings.reserve(directories.size());
+        for (const QPair<QString, watchRoot> &directory : qAsConst(directories)) {
+            listings.append(list(directory.first, directory.second));
+        }
+
+        folderWatcher *target = watcher;
+        const bool reportChanges = report;
+        const int generation = scanGeneration;
+        // Dropped if the watcher is destroyed first, the destructor waits for this thread
+        QMetaObject::invokeMethod(target, [target, listings, reportChanges, generation]() {
+            target->applyListings(listings, reportChanges, generation);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    folderWatcher *watcher;
+    QVector<QPair<QString, watchRoot>> directories;
+    bool report;
+    int scanGeneration;
+};
+
+/***************************************************************************************************
+* @description : Constructor for folderWatcher class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+folderWatcher::folderWatcher(QObject *parent)
+    : QObject(parent)
+    , currentGeneration(0)
+    , nextFollowSymlinks(false)
+{
+    pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+
+    settleTimer.setSingleShot(true);
+    connect(&settleTimer, &QTimer::timeout, this, &folderWatcher::onSettled);
+
+#ifdef Q_OS_LINUX
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    notifier = nullptr;
+    warnedLimit = false;
+    if (inotifyFd >= 0) {
+        notifier = new QSocketNotifier(inotifyFd, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &folderWatcher::onWatchEvents);
+    } else {
+        qWarning("folderWatcher: inotify is not available, folders are not watched");
+    }
+#else
+    systemWatcher = new QFileSystemWatcher(this);
+    connect(systemWatcher, &QFileSystemWatcher::directoryChanged, this, &folderWatcher::onDirectoryChanged);
+#endif
+}
+
+/***************************************************************************************************
+* @description : Destructor for folderWatcher class.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+folderWatcher::~folderWatcher()
+{
+    clear();
+    pool.waitForDone();
+#ifdef Q_OS_LINUX
+    delete notifier;
+    if (inotifyFd >= 0) close(inotifyFd);
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function sets the include and exclude glob lists of trees watched from now
+*                on.
+* @param : const QString &include, const QString &exclude
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::setFilters(const QString &include, const QString &exclude)
+{
+    nextFilter = directoryWalker::pathFilter(include, exclude);
+}
+
+/***************************************************************************************************
+* @description : This function sets whether symbolic links to directories are entered in trees
+*                watched from now on.
+* @param : bool follow
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::setFollowSymlinks(bool follow)
+{
+    nextFollowSymlinks = follow;
+}
+
+/***************************************************************************************************
+* @description : This function starts watching directory trees. The roots are watched right away,
+*                their subdirectories as the first listings arrive.
+* @param : const QStringList &directories
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::watch(const QStringList &directories)
+{
+    QStringList added;
+    for (const QString &directory : directories) {
+        if (!QFileInfo(directory).isDir()) continue;
+
+        const QString path = QDir::cleanPath(QDir::fromNativeSeparators(directory));
+        fileIdentity identity;
+        if (!fileIdentity::read(path, &identity)) continue;
+
+        watchRoot root;
+        root.rootLength = path.endsWith('/') ? path.size() : path.size() + 1;
+        root.filter = nextFilter;
+        root.followSymlinks = nextFollowSymlinks;
+        roots.append(root);
+
+        if (addDirectory(path, roots.size() - 1, qMakePair(identity.device, identity.inode))) {
+            added.append(path);
+        } else {
+            roots.removeLast();
+        }
+    }
+    scan(added, false);
+}
+
+/***************************************************************************************************
+* @description : This function removes every watch and forgets the snapshots. Listings still
+*                running are dropped when they arrive.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::clear()
+{
+    ++currentGeneration;
+    settleTimer.stop();
+    dirty.clear();
+
+#ifdef Q_OS_LINUX
+    for (auto it = descriptors.constBegin(); it != descriptors.constEnd(); ++it) {
+        inotify_rm_watch(inotifyFd, it.key());
+    }
+    descriptors.clear();
+#else
+    const QStringList watched = systemWatcher->directories();
+    if (!watched.isEmpty()) systemWatcher->removePaths(watched);
+#endif
+
+    directories.clear();
+    watchedKeys.clear();
+    roots.clear();
+}
+
+/***************************************************************************************************
+* @description : This function returns the number of watched directories.
+* @param : None
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int folderWatcher::directoryCount() const
+{
+    return directories.size();
+}
+
+/***************************************************************************************************
+* @description : This function handles a change reported by QFileSystemWatcher.
+* @param : const QString &path
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::onDirectoryChanged(const QString &path)
+{
+    markDirty(path);
+}
+
+/***************************************************************************************************
+* @description : This function drains the inotify queue and marks the directories that had
+*                events. An overflowed queue lost events, so every directory is marked.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::onWatchEvents()
+{
+#ifdef Q_OS_LINUX
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    while (true) {
+        const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length < 0 && errno == EINTR) continue;
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length; ) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                for (auto it = directories.constBegin(); it != directories.constEnd(); ++it) {
+                    markDirty(it.key());
+                }
+                continue;
+            }
+            // A new file is reported when it is closed, only new directories need a listing now
+            if ((event->mask & IN_CREATE) && !(event->mask & IN_ISDIR)) continue;
+
+            auto directory = descriptors.constFind(event->wd);
+            if (directory != descriptors.constEnd()) markDirty(directory.value());
+        }
+    }
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function lists the directories marked since the last listing. Directories
+*                whose previous listing has not arrived yet are listed again once it has.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::onSettled()
+{
+    QStringList paths;
+    for (const QString &path : qAsConst(dirty)) {
+        auto directory = directories.find(path);
+        if (directory == directories.end()) continue;
+
+        if (directory->scanning) {
+            directory->rescan = true;
+        } else {
+            paths.append(path);
+        }
+    }
+    dirty.clear();
+    scan(paths, true);
+}
+
+/***************************************************************************************************
+* @description : This function hands directories to the pool in batches of ScanBatchSize.
+* @param : const QStringList &paths, bool report
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::scan(const QStringList &paths, bool report)
+{
+    QVector<QPair<QString, watchRoot>> batch;
+    for (const QString &path : paths) {
+        auto directory = directories.find(path);
+        if (directory == directories.end()) continue;
+
+        directory->scanning = true;
+        batch.append(qMakePair(path, roots.at(directory->root)));
+        if (batch.size() == ScanBatchSize) {
+            pool.start(new scanJob(this, batch, report, currentGeneration));
+            batch.clear();
+        }
+    }
+    if (!batch.isEmpty()) pool.start(new scanJob(this, batch, report, currentGeneration));
+}
+
+/***************************************************************************************************
+* @description : This function reads the files of one directory with their size and modification
+*                time, and the subdirectories that are entered with the filters of its root.
+* @param : const QString &path, const watchRoot &root
+* @return : listing
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+folderWatcher::listing folderWatcher::list(const QString &path, const watchRoot &root)
+{
+    listing result;
+    result.path = path;
+    result.exists = QFileInfo(path).isDir();
+    if (!result.exists) return result;
+
+    QDirIterator it(path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        const QString entryPath = fi.filePath();
+        const QString name = fi.fileName();
+        const QString relativePath = entryPath.mid(root.rootLength);
+
+        if (root.filter.excludes(name, relativePath)) continue;
+
+        fileIdentity identity;
+        if (fi.isDir()) {
+            if (fi.isSymLink() && !root.followSymlinks) continue;
+            if (!fileIdentity::read(entryPath, &identity)) continue;
+            result.subdirectories.append(qMakePair(entryPath, qMakePair(identity.device, identity.inode)));
+        } else if (fi.isFile() && root.filter.includes(name, relativePath)) {
+            // A file removed since it was listed is simply not in the snapshot
+            if (!fileIdentity::read(entryPath, &identity)) continue;
+            result.files.insert(name, fileStamp{identity.size, identity.modified});
+        }
+    }
+    return result;
+}
+
+/***************************************************************************************************
+* @description : This function takes in listings on the watcher's thread. Files are compared with
+*                the snapshot by size and modification time, subdirectories that went away stop
+*                being watched and new ones are watched and listed. For the first listing of a
+*                tree nothing is reported, a directory that appears later reports all its files.
+* @param : const QVector<listing> &listings, bool report, int scanGeneration
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::applyListings(const QVector<listing> &listings, bool report, int scanGeneration)
+{
+    if (scanGeneration != currentGeneration) return;
+
+    QStringList changed;
+    QStringList removed;
+    QStringList newDirectories;
+    QStringList again;
+
+    for (const listing &current : listings) {
+        auto directory = directories.find(current.path);
+        if (directory == directories.end()) continue;
+
+        if (!current.exists) {
+            removeDirectory(current.path, &removed);
+            continue;
+        }
+
+        directory->scanning = false;
+        if (directory->rescan) {
+            directory->rescan = false;
+            again.append(current.path);
+        }
+
+        const QString prefix = current.path.endsWith('/') ? current.path : current.path + '/';
+        for (auto file = current.files.constBegin(); file != current.files.constEnd(); ++file) {
+            auto known = directory->files.constFind(file.key());
+            if (known == directory->files.constEnd() || known->size != file->size || known->modified != file->modified) {
+                if (report) changed.append(prefix + file.key());
+            }
+        }
+        if (report) {
+            for (auto file = directory->files.constBegin(); file != directory->files.constEnd(); ++file) {
+                if (!current.files.contains(file.key())) removed.append(prefix + file.key());
+            }
+        }
+        directory->files = current.files;
+
+        // Removed first, a renamed directory keeps its (device, inode)
+        QSet<QString> present;
+        for (const QPair<QString, QPair<quint64, quint64>> &subdirectory : current.subdirectories) {
+            present.insert(subdirectory.first);
+        }
+        const QSet<QString> previous = directory->subdirectories;
+        for (const QString &subdirectory : previous) {
+            if (!present.contains(subdirectory)) removeDirectory(subdirectory, &removed);
+        }
+
+        // Erasing from the table invalidated the iterator
+        directory = directories.find(current.path);
+        directory->subdirectories.intersect(present);
+        const int root = directory->root;
+        for (const QPair<QString, QPair<quint64, quint64>> &subdirectory : current.subdirectories) {
+            if (directories.contains(subdirectory.first)) continue;
+            if (addDirectory(subdirectory.first, root, subdirectory.second)) {
+                directories[current.path].subdirectories.insert(subdirectory.first);
+                newDirectories.append(subdirectory.first);
+            }
+        }
+    }
+
+    scan(newDirectories, report);
+    scan(again, true);
+
+    if (!changed.isEmpty() || !removed.isEmpty()) emit filesChanged(changed, removed);
+}
+
+/***************************************************************************************************
+* @description : This function adds the kernel watch of a directory and its empty snapshot.
+* @param : const QString &path, int root, const QPair<quint64, quint64> &key
+* @return : bool - false if the directory is watched already
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool folderWatcher::addDirectory(const QString &path, int root, const QPair<quint64, quint64> &key)
+{
+    if (directories.contains(path)) return false;
+    if ((key.first != 0 || key.second != 0) && watchedKeys.contains(key)) return false;
+
+    watchedDirectory directory;
+    directory.root = root;
+    directory.key = key;
+    directory.descriptor = -1;
+    directory.scanning = false;
+    directory.rescan = false;
+
+#ifdef Q_OS_LINUX
+    if (inotifyFd >= 0) {
+        directory.descriptor = inotify_add_watch(inotifyFd, QFile::encodeName(path).constData(), WatchEvents);
+        if (directory.descriptor >= 0) {
+            descriptors.insert(directory.descriptor, path);
+        } else if (errno == ENOSPC && !warnedLimit) {
+            warnedLimit = true;
+            qWarning("folderWatcher: out of inotify watches, raise fs.inotify.max_user_watches");
+        }
+    }
+#else
+    systemWatcher->addPath(path);
+#endif
+
+    directories.insert(path, directory);
+    watchedKeys.insert(key);
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function stops watching a directory and everything below it.
+* @param : const QString &path, QStringList *removed
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::removeDirectory(const QString &path, QStringList *removed)
+{
+    auto found = directories.find(path);
+    if (found == directories.end()) return;
+
+    const watchedDirectory directory = found.value();
+    directories.erase(found);
+    watchedKeys.remove(directory.key);
+    dirty.remove(path);
+
+#ifdef Q_OS_LINUX
+    if (directory.descriptor >= 0) {
+        // The kernel drops the watch itself when the directory is deleted
+        inotify_rm_watch(inotifyFd, directory.descriptor);
+        descriptors.remove(directory.descriptor);
+    }
+#else
+    systemWatcher->removePath(path);
+#endif
+
+    const QString prefix = path.endsWith('/') ? path : path + '/';
+    for (auto file = directory.files.constBegin(); file != directory.files.constEnd(); ++file) {
+        removed->append(prefix + file.key());
+    }
+    for (const QString &subdirectory : directory.subdirectories) {
+        removeDirectory(subdirectory, removed);
+    }
+}
+
+/***************************************************************************************************
+* @description : This function marks a directory for listing. Every change restarts the quiet
+*                period, but a burst that lasts longer than MaxDelayMs is listed anyway.
+* @param : const QString &path
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void folderWatcher::markDirty(const QString &path)
+{
+    if (!directories.contains(path)) return;
+
+    if (dirty.isEmpty()) burst.start();
+    dirty.insert(path);
+
+    if (!settleTimer.isActive() || burst.elapsed() + QuietMs <= MaxDelayMs) {
+        settleTimer.start(QuietMs);
+    }
+}
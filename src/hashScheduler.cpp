@@ -0,0 +1,307 @@
+#include "hashScheduler.h"
+#include "checksumDatabase.h"
+#include "fileIdentity.h"
+#include "hashStatistics.h"
+#include "systemTopology.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QDateTime>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+namespace {
+
+// Up to hashScheduler::BatchSize queued files
+class hashJob : public QRunnable
+{
+public:
+    hashJob(hashScheduler *scheduler, int generation, const QStringList &filePaths,
+            const QVector<checksumEngine::ChecksumType> &types, bool forceRehash, int node, QAtomicInt *pending)
+        : scheduler(scheduler), generation(generation), filePaths(filePaths), types(types), forceRehash(forceRehash)
+        , node(node), pending(pending), completed(0)
+    {
+    }
+
+    // Also runs for jobs dropped by cancelAll, which never started
+    ~hashJob()
+    {
+        if (completed < filePaths.size()) hashStatistics::instance().addCompleted(filePaths.size() - completed);
+        pending->fetchAndSubOrdered(filePaths.size());
+    }
+
+    void run() override
+    {
+        // The lane's threads stay on its node, so this only costs a call the first time
+        systemTopology::pinThread(node);
+
+        // Stat everything first so the reads can go in on-disk order. The identity is read
+        // before hashing, a change during hashing shows up as a stale cache entry.
+        QVector<fileIdentity> identities(filePaths.size());
+        for (int i = 0; i < filePaths.size(); ++i) {
+            if (!fileIdentity::read(filePaths.at(i), &identities[i])) identities[i].size = -1;
+        }
+        std::sort(identities.begin(), identities.end(), [](const fileIdentity &a, const fileIdentity &b) {
+            return a.device != b.device ? a.device < b.device : a.inode < b.inode;
+        });
+
+        QVector<hashResult> results;
+        results.reserve(identities.size());
+        QElapsedTimer sinceReport;
+        sinceReport.start();
+
+        for (const fileIdentity &identity : qAsConst(identities)) {
+            if (!scheduler->isCurrent(generation)) return;
+
+            hashResult result;
+            result.filePath = identity.path;
+            result.size = identity.size;
+            result.modified = QDateTime::fromMSecsSinceEpoch(identity.modified / 1000000);
+            result.checksums = checksumDatabase::instance().checksums(identity, types, checksumEngine::BufferedIo,
+                                                                      forceRehash);
+            results.append(result);
+
+            if (sinceReport.elapsed() >= hashScheduler::ReportIntervalMs) {
+                report(results);
+                results.clear();
+                sinceReport.restart();
+            }
+        }
+
+        if (!results.isEmpty()) report(results);
+    }
+
+private:
+    // Hands a batch to the scheduler and counts it as completed in one go
+    void report(const QVector<hashResult> &results)
+    {
+        hashStatistics::instance().addCompleted(results.size());
+        completed += results.size();
+        scheduler->reportResults(generation, results);
+    }
+
+    hashScheduler *scheduler;
+    int generation;
+    QStringList filePaths;
+    QVector<checksumEngine::ChecksumType> types;
+    bool forceRehash;
+    // Node of the device's lane and its count of unfinished files
+    int node;
+    QAtomicInt *pending;
+    // Files counted as completed in hashStatistics
+    int completed;
+};
+
+} // namespace
+
+/***************************************************************************************************
+* @description : Constructor for hashScheduler class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashScheduler::hashScheduler(QObject *parent)
+    : QObject(parent)
+    , generation(0)
+    , forceRehash(false)
+{
+    qRegisterMetaType<hashResult>();
+    qRegisterMetaType<QVector<hashResult>>();
+}
+
+/***************************************************************************************************
+* @description : Destructor for hashScheduler class. Queued jobs are dropped and running ones are
+*                waited for, so no job outlives the scheduler it reports to. Checksums still
+*                pending for the persistent database are written out.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashScheduler::~hashScheduler()
+{
+    cancelAll();
+    for (deviceLane *lane : qAsConst(lanes)) {
+        lane->pool.waitForDone();
+    }
+    qDeleteAll(lanes);
+    checksumDatabase::instance().flush();
+}
+
+/***************************************************************************************************
+* @description : This function queues a file for hashing on the worker pool. The file is read once
+*                no matter how many checksum types are requested.
+* @param : const QString &filePath, const QVector<checksumEngine::ChecksumType> &types
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashScheduler::enqueue(const QString &filePath, const QVector<checksumEngine::ChecksumType> &types)
+{
+    enqueue(QStringList() << filePath, types);
+}
+
+/***************************************************************************************************
+* @description : This function queues files in jobs of BatchSize. One job per file costs a
+*                runnable, a queued signal and a table update for every file, which dominates
+*                when the files are only a few kilobytes. Each job stats its files, reads them
+*                sorted by inode and reports the results together. Files are split by device
+*                first, every device's jobs go to its own lane.
+* @param : const QStringList &filePaths, const QVector<checksumEngine::ChecksumType> &types
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashScheduler::enqueue(const QStringList &filePaths, const QVector<checksumEngine::ChecksumType> &types)
+{
+    const int jobGeneration = generation.loadAcquire();
+    hashStatistics::instance().addQueued(filePaths.size());
+
+    QHash<deviceLane *, QStringList> laneFiles;
+    for (const QString &filePath : filePaths) {
+        laneFiles[laneFor(filePath)].append(filePath);
+    }
+    for (auto it = laneFiles.constBegin(); it != laneFiles.constEnd(); ++it) {
+        it.key()->pending.fetchAndAddOrdered(it.value().size());
+    }
+    balanceLanes();
+
+    for (auto it = laneFiles.constBegin(); it != laneFiles.constEnd(); ++it) {
+        deviceLane *lane = it.key();
+        const QStringList &files = it.value();
+        for (int first = 0; first < files.size(); first += BatchSize) {
+            lane->pool.start(new hashJob(this, jobGeneration, files.mid(first, BatchSize), types, forceRehash,
+                                         lane->node, &lane->pending));
+        }
+    }
+}
+
+/***************************************************************************************************
+* @description : This function drops all queued jobs. Jobs that already started still finish but
+*                their results are not reported.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashScheduler::cancelAll()
+{
+    generation.fetchAndAddOrdered(1);
+    for (deviceLane *lane : qAsConst(lanes)) {
+        lane->pool.clear();
+    }
+}
+
+/***************************************************************************************************
+* @description : This function makes jobs queued from now on skip the persistent checksum
+*                database lookup. Their results still update the database.
+* @param : bool force
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashScheduler::setForceRehash(bool force)
+{
+    forceRehash = force;
+}
+
+/***************************************************************************************************
+* @description : This function returns the number of worker threads over all devices, the
+*                machine's core count before anything was queued.
+* @param : None
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int hashScheduler::workerCount() const
+{
+    if (lanes.isEmpty()) return qMax(1, QThread::idealThreadCount());
+
+    int count = 0;
+    for (const deviceLane *lane : lanes) {
+        count += lane->pool.maxThreadCount();
+    }
+    return count;
+}
+
+/***************************************************************************************************
+* @description : This function tells whether a job was queued after the last cancelAll.
+* @param : int jobGeneration
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool hashScheduler::isCurrent(int jobGeneration) const
+{
+    return jobGeneration == generation.loadAcquire();
+}
+
+/***************************************************************************************************
+* @description : This function forwards finished files to listeners unless the job was cancelled.
+* @param : int jobGeneration, const QVector<hashResult> &results
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashScheduler::reportResults(int jobGeneration, const QVector<hashResult> &results)
+{
+    if (!isCurrent(jobGeneration)) return;
+
+    emit filesHashed(results);
+}
+
+/***************************************************************************************************
+* @description : This function returns the lane of the device a file lives on. The device is
+*                taken from the file's directory, which is stat'ed once. A new lane is pinned to
+*                the node of the device's controller, or to the node with the fewest lanes when
+*                that is not known, e.g. for network file systems.
+* @param : const QString &filePath
+* @return : deviceLane *
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashScheduler::deviceLane *hashScheduler::laneFor(const QString &filePath)
+{
+    const QString directory = filePath.left(qMax(0, filePath.lastIndexOf('/')));
+    auto known = directoryDevices.constFind(directory);
+    if (known == directoryDevices.constEnd()) {
+        fileIdentity identity;
+        if (!fileIdentity::read(directory.isEmpty() ? filePath : directory, &identity)) identity.device = 0;
+        known = directoryDevices.insert(directory, identity.device);
+    }
+    const quint64 device = known.value();
+
+    for (deviceLane *lane : qAsConst(lanes)) {
+        if (lane->device == device) return lane;
+    }
+
+    int node = systemTopology::deviceNode(device);
+    if (node < 0) {
+        QVector<int> lanesOnNode(systemTopology::nodeCount());
+        for (const deviceLane *lane : qAsConst(lanes)) {
+            ++lanesOnNode[lane->node];
+        }
+        for (int candidate = 0; candidate < lanesOnNode.size(); ++candidate) {
+            if (systemTopology::cpuCount(candidate) == 0) continue;
+            if (node < 0 || lanesOnNode.at(candidate) < lanesOnNode.at(node)) node = candidate;
+        }
+    }
+
+    deviceLane *lane = new deviceLane;
+    lane->device = device;
+    lane->node = qMax(0, node);
+    lanes.append(lane);
+    return lane;
+}
+
+/***************************************************************************************************
+* @description : This function sizes every lane's pool. The lanes that have files pending share
+*                their node's cores, idle lanes keep their threads for when work comes back.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashScheduler::balanceLanes()
+{
+    QVector<int> busyOnNode(systemTopology::nodeCount());
+    for (const deviceLane *lane : qAsConst(lanes)) {
+        if (lane->pending.loadAcquire() > 0) ++busyOnNode[lane->node];
+    }
+
+    for (deviceLane *lane : qAsConst(lanes)) {
+        if (lane->pending.loadAcquire() == 0) continue;
+        lane->pool.setMaxThreadCount(systemTopology::readerCount(lane->device, lane->node, busyOnNode.at(lane->node)));
+    }
+}
@@ -0,0 +1,505 @@
+#include "hashStatistics.h"
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Written by its thread only, read by current() without stopping it
+struct hashStatistics::threadCounters
+{
+    QAtomicInteger<qint64> bytesDone;
+    QAtomicInteger<qint64> bytesOfFinishedFiles;
+    QAtomicInteger<qint64> filesFinished;
+    QAtomicInteger<qint64> filesDone;
+    QAtomicInteger<qint64> cpuNs;
+    QAtomicInteger<qint64> ioWaitNs;
+};
+
+// Retires the counters of a thread when it exits
+struct hashStatistics::threadSlot
+{
+    threadCounters *counters = nullptr;
+
+    ~threadSlot()
+    {
+        if (counters) hashStatistics::instance().retire(counters);
+    }
+};
+
+/***************************************************************************************************
+* @description : This function returns the instance shared by the whole process.
+* @param : None
+* @return : hashStatistics &
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashStatistics &hashStatistics::instance()
+{
+    static hashStatistics statistics;
+    return statistics;
+}
+
+/***************************************************************************************************
+* @description : Constructor for hashStatistics class.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashStatistics::hashStatistics()
+    : jsonLog(false), logging(0)
+{
+    resetLocked();
+}
+
+/***************************************************************************************************
+* @description : This function counts queued files. A run starts over when the previous one is
+*                completely done, so the rate and ETA always describe the current batch.
+* @param : int files
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::addQueued(int files)
+{
+    QMutexLocker locker(&mutex);
+    if (sumLocked().filesDone >= filesQueued && activeFiles.isEmpty()) resetLocked();
+    filesQueued += files;
+}
+
+/***************************************************************************************************
+* @description : This function counts files a scheduler is done with.
+* @param : int files
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::addCompleted(int files)
+{
+    local().filesDone.fetchAndAddRelaxed(files);
+}
+
+/***************************************************************************************************
+* @description : This function registers a file checksumEngine starts reading. A file that is
+*                already being read gains another user, its size counts once per user so the
+*                progress stays the share of all their bytes.
+* @param : const QString &filePath, qint64 size
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::fileStarted(const QString &filePath, qint64 size)
+{
+    const qint64 now = wallNs();
+
+    QMutexLocker locker(&mutex);
+    fileState &state = activeFiles[filePath];
+    if (state.users++ == 0) state.startedNs = now;
+    state.size += size;
+}
+
+/***************************************************************************************************
+* @description : This function retires one user of a file. The entry is logged and removed with
+*                its last user.
+* @param : const QString &filePath, bool ok
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::fileFinished(const QString &filePath, bool ok)
+{
+    const qint64 now = wallNs();
+    threadCounters &counters = local();
+
+    QMutexLocker locker(&mutex);
+    auto it = activeFiles.find(filePath);
+    if (it == activeFiles.end()) return;
+
+    if (ok) {
+        counters.bytesOfFinishedFiles.fetchAndAddRelaxed(it->size / it->users);
+        counters.filesFinished.fetchAndAddRelaxed(1);
+    }
+    if (--it->users > 0) return;
+
+    if (log.isOpen()) {
+        writeRecord(filePath, it->size, now - it->startedNs, it->cpuNs, it->ioWaitNs, ok);
+    }
+    activeFiles.erase(it);
+}
+
+/***************************************************************************************************
+* @description : This function adds one hashed block. wallNs covers reading and hashing it,
+*                cpuNs the part the thread was running.
+* @param : const QString &filePath, qint64 bytes, qint64 wallNs, qint64 cpuNs
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::addBlock(const QString &filePath, qint64 bytes, qint64 wallNs, qint64 cpuNs)
+{
+    // Thread CPU clocks can be coarser than the wall clock
+    if (cpuNs > wallNs) cpuNs = wallNs;
+    const qint64 waitNs = wallNs - cpuNs;
+
+    threadCounters &counters = local();
+    counters.bytesDone.fetchAndAddRelaxed(bytes);
+    counters.cpuNs.fetchAndAddRelaxed(cpuNs);
+    counters.ioWaitNs.fetchAndAddRelaxed(waitNs);
+
+    QMutexLocker locker(&mutex);
+    auto it = activeFiles.find(filePath);
+    if (it == activeFiles.end()) return;
+    it->bytesDone += bytes;
+    it->cpuNs += cpuNs;
+    it->ioWaitNs += waitNs;
+}
+
+/***************************************************************************************************
+* @description : This function adds a small file that was hashed without registering it. Its
+*                time is not measured, the thread CPU clock costs more than hashing it.
+* @param : qint64 bytes
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::addSmallFile(qint64 bytes)
+{
+    threadCounters &counters = local();
+    counters.bytesDone.fetchAndAddRelaxed(bytes);
+    counters.bytesOfFinishedFiles.fetchAndAddRelaxed(bytes);
+    counters.filesFinished.fetchAndAddRelaxed(1);
+}
+
+/***************************************************************************************************
+* @description : This function tells whether the per file log is open.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool hashStatistics::logsFiles() const
+{
+    return logging.loadAcquire() != 0;
+}
+
+/***************************************************************************************************
+* @description : This function returns the counters of the calling thread, registering them the
+*                first time the thread reports anything.
+* @param : None
+* @return : threadCounters &
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashStatistics::threadCounters &hashStatistics::local()
+{
+    static thread_local threadSlot slot;
+    if (!slot.counters) {
+        slot.counters = new threadCounters;
+        QMutexLocker locker(&mutex);
+        threads.append(slot.counters);
+    }
+    return *slot.counters;
+}
+
+/***************************************************************************************************
+* @description : This function folds the counters of an exiting thread into the retired ones.
+* @param : threadCounters *counters
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::retire(threadCounters *counters)
+{
+    QMutexLocker locker(&mutex);
+    retired.bytesDone += counters->bytesDone.loadAcquire();
+    retired.bytesOfFinishedFiles += counters->bytesOfFinishedFiles.loadAcquire();
+    retired.filesFinished += counters->filesFinished.loadAcquire();
+    retired.filesDone += counters->filesDone.loadAcquire();
+    retired.cpuNs += counters->cpuNs.loadAcquire();
+    retired.ioWaitNs += counters->ioWaitNs.loadAcquire();
+    threads.removeOne(counters);
+    delete counters;
+}
+
+/***************************************************************************************************
+* @description : This function sums the counters of all threads and subtracts the sum at the
+*                start of the run. The mutex must be held.
+* @param : None
+* @return : totals
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashStatistics::totals hashStatistics::sumLocked() const
+{
+    totals sum = retired;
+    for (const threadCounters *counters : threads) {
+        sum.bytesDone += counters->bytesDone.loadAcquire();
+        sum.bytesOfFinishedFiles += counters->bytesOfFinishedFiles.loadAcquire();
+        sum.filesFinished += counters->filesFinished.loadAcquire();
+        sum.filesDone += counters->filesDone.loadAcquire();
+        sum.cpuNs += counters->cpuNs.loadAcquire();
+        sum.ioWaitNs += counters->ioWaitNs.loadAcquire();
+    }
+    sum.bytesDone -= base.bytesDone;
+    sum.bytesOfFinishedFiles -= base.bytesOfFinishedFiles;
+    sum.filesFinished -= base.filesFinished;
+    sum.filesDone -= base.filesDone;
+    sum.cpuNs -= base.cpuNs;
+    sum.ioWaitNs -= base.ioWaitNs;
+    return sum;
+}
+
+/***************************************************************************************************
+* @description : This function returns the current state. The throughput is averaged over the
+*                samples of the last ThroughputWindowMs, each call adds one sample. Bytes still
+*                to come are the rest of the active files plus the waiting files at the average
+*                size of the files finished so far.
+* @param : None
+* @return : snapshot
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+hashStatistics::snapshot hashStatistics::current()
+{
+    const qint64 now = wallNs();
+
+    QMutexLocker locker(&mutex);
+    const totals sum = sumLocked();
+    const qint64 bytesDone = sum.bytesDone;
+    snapshot result;
+    result.bytesDone = bytesDone;
+    result.filesQueued = filesQueued;
+    result.filesDone = sum.filesDone;
+    result.queueDepth = qMax<qint64>(filesQueued - sum.filesDone, activeFiles.size());
+    result.elapsedMs = (now - runStartedNs) / 1000000;
+    result.cpuNs = sum.cpuNs;
+    result.ioWaitNs = sum.ioWaitNs;
+
+    samples.append(qMakePair(now, bytesDone));
+    const qint64 windowStart = now - qint64(ThroughputWindowMs) * 1000000;
+    int first = 0;
+    while (first < samples.size() - 1 && samples.at(first + 1).first <= windowStart) ++first;
+    samples.remove(0, first);
+
+    qint64 spanNs = now - samples.first().first;
+    qint64 spanBytes = bytesDone - samples.first().second;
+    if (samples.size() < 2 || spanNs <= 0) {
+        spanNs = now - runStartedNs;
+        spanBytes = bytesDone;
+    }
+    if (spanNs > 0) result.mbPerSecond = spanBytes / 1048576.0 / (spanNs / 1e9);
+
+    qint64 remaining = 0;
+    for (auto it = activeFiles.constBegin(); it != activeFiles.constEnd(); ++it) {
+        const double seconds = (now - it->startedNs) / 1e9;
+        result.activeFiles.append(fileProgress{ it.key(), it->size, it->bytesDone,
+                                                seconds > 0 ? it->bytesDone / 1048576.0 / seconds : 0 });
+        remaining += qMax<qint64>(0, it->size - it->bytesDone);
+    }
+
+    const qint64 waiting = result.queueDepth - activeFiles.size();
+    if (waiting <= 0) {
+        result.bytesRemaining = remaining;
+    } else if (sum.filesFinished > 0) {
+        result.bytesRemaining = remaining + waiting * (sum.bytesOfFinishedFiles / sum.filesFinished);
+    }
+    if (result.bytesRemaining >= 0 && result.mbPerSecond > 0) {
+        result.etaSeconds = result.bytesRemaining / 1048576.0 / result.mbPerSecond;
+    }
+    return result;
+}
+
+/***************************************************************************************************
+* @description : This function clears every counter.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::reset()
+{
+    QMutexLocker locker(&mutex);
+    resetLocked();
+}
+
+/***************************************************************************************************
+* @description : This function clears every counter with the mutex held. The thread counters
+*                keep running, the run starts from their sum instead. Active files stay
+*                registered so their blocks keep being counted.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::resetLocked()
+{
+    // sumLocked() subtracts the old base
+    base = totals();
+    base = sumLocked();
+    runStartedNs = wallNs();
+    filesQueued = 0;
+    samples.clear();
+}
+
+/***************************************************************************************************
+* @description : This function opens the per file log, replacing an existing file.
+* @param : const QString &logPath, QString *error
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool hashStatistics::openLog(const QString &logPath, QString *error)
+{
+    QMutexLocker locker(&mutex);
+    logging.storeRelease(0);
+    if (log.isOpen()) log.close();
+
+    log.setFileName(logPath);
+    if (!log.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        *error = QString("%1: %2").arg(logPath, log.errorString());
+        return false;
+    }
+
+    jsonLog = logPath.endsWith(".json", Qt::CaseInsensitive);
+    if (!jsonLog) log.write("file,size,seconds,cpu_seconds,io_wait_seconds,mb_per_second,ok\n");
+    logging.storeRelease(1);
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function writes the summary of the run and closes the log.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::closeLog()
+{
+    const qint64 now = wallNs();
+
+    QMutexLocker locker(&mutex);
+    if (!log.isOpen()) return;
+
+    logging.storeRelease(0);
+    const totals sum = sumLocked();
+    const QString total = jsonLog ? QString() : QString("TOTAL");
+    writeRecord(total, sum.bytesDone, now - runStartedNs, sum.cpuNs, sum.ioWaitNs, true);
+    log.close();
+}
+
+/***************************************************************************************************
+* @description : This function appends one record to the log. An empty path marks the summary,
+*                whose times are summed over all threads.
+* @param : const QString &filePath, qint64 size, qint64 wallNs, qint64 cpuNs, qint64 ioWaitNs, bool ok
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void hashStatistics::writeRecord(const QString &filePath, qint64 size, qint64 wallNs, qint64 cpuNs,
+                                 qint64 ioWaitNs, bool ok)
+{
+    const double seconds = wallNs / 1e9;
+    const double mbPerSecond = seconds > 0 ? size / 1048576.0 / seconds : 0;
+
+    if (jsonLog) {
+        QJsonObject record;
+        if (filePath.isEmpty()) {
+            record.insert("summary", true);
+            record.insert("files", sumLocked().filesDone);
+        } else {
+            record.insert("file", filePath);
+        }
+        record.insert("size", size);
+        record.insert("seconds", seconds);
+        record.insert("cpuSeconds", cpuNs / 1e9);
+        record.insert("ioWaitSeconds", ioWaitNs / 1e9);
+        record.insert("mbPerSecond", mbPerSecond);
+        record.insert("ok", ok);
+        log.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+        return;
+    }
+
+    QString name = filePath;
+    if (name.contains(',') || name.contains('"')) {
+        name = '"' + name.replace("\"", "\"\"") + '"';
+    }
+    log.write(QString("%1,%2,%3,%4,%5,%6,%7\n")
+                  .arg(name).arg(size)
+                  .arg(seconds, 0, 'f', 6).arg(cpuNs / 1e9, 0, 'f', 6).arg(ioWaitNs / 1e9, 0, 'f', 6)
+                  .arg(mbPerSecond, 0, 'f', 1).arg(ok ? 1 : 0).toUtf8());
+}
+
+/***************************************************************************************************
+* @description : This function returns a monotonic wall clock in nanoseconds.
+* @param : None
+* @return : qint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+qint64 hashStatistics::wallNs()
+{
+    static QElapsedTimer clock = [](){
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+/***************************************************************************************************
+* @description : This function returns the CPU time used by the calling thread in nanoseconds.
+*                Windows reports it in scheduler ticks, so single blocks may read as zero there.
+* @param : None
+* @return : qint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+qint64 hashStatistics::threadCpuNs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0;
+    const quint64 kernelTicks = (quint64(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const quint64 userTicks = (quint64(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return qint64((kernelTicks + userTicks) * 100);
+#else
+    timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return 0;
+    return qint64(now.tv_sec) * 1000000000 + now.tv_nsec;
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function formats a byte count in GB, MB or KB for status lines.
+* @param : qint64 bytes
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString hashStatistics::formatBytes(qint64 bytes)
+{
+    if (bytes >= 1024LL * 1024 * 1024) return QString("%1 GB").arg(bytes / 1073741824.0, 0, 'f', 2);
+    if (bytes >= 1024 * 1024) return QString("%1 MB").arg(bytes / 1048576.0, 0, 'f', 1);
+    return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+/***************************************************************************************************
+* @description : This function returns the share of thread time spent waiting for data.
+* @param : None
+* @return : double
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+double hashStatistics::snapshot::ioWaitShare() const
+{
+    const qint64 total = cpuNs + ioWaitNs;
+    return total > 0 ? double(ioWaitNs) / total : 0;
+}
+
+/***************************************************************************************************
+* @description : This function formats the snapshot as one status line.
+* @param : None
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString hashStatistics::snapshot::statusText() const
+{
+    QString text = QString("%1 of %2 files, %3 at %4 MB/s, I/O wait %5%")
+                       .arg(filesDone).arg(filesQueued)
+                       .arg(formatBytes(bytesDone))
+                       .arg(mbPerSecond, 0, 'f', 1)
+                       .arg(qRound(ioWaitShare() * 100));
+    if (queueDepth > 0) {
+        text += QString(", %1 queued").arg(queueDepth);
+        if (etaSeconds >= 0) {
+            const qint64 eta = qint64(etaSeconds + 0.5);
+            text += QString(", ETA %1:%2").arg(eta / 60).arg(eta % 60, 2, 10, QChar('0'));
+        }
+    }
+    return text;
+}
@@ -1,13 +1,25 @@
 #include "crcCalculate.h"
+#include "commandLine.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    // Options of the headless batch mode select it, no display is needed there
+    if (commandLine::isRequested(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        QCoreApplication::setApplicationName("CrcChecksumCalculator");
+        return commandLine::run(QCoreApplication::arguments());
+    }
+
     QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
     QApplication a(argc, argv);
     crcCalculate w;
     w.show();
     w.setMinimumSize(QSize(800, 600));
+
+    // Plain paths, e.g. from "Open with" or files dropped on the executable, are imported
+    const QStringList paths = commandLine::pathArguments(QApplication::arguments());
+    if (!paths.isEmpty()) w.importPaths(paths);
     return a.exec();
 }
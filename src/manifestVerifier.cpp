@@ -0,0 +1,483 @@
+#include "manifestVerifier.h"
+#include "checksumDatabase.h"
+#include "fileIdentity.h"
+#include "hashStatistics.h"
+#include "systemTopology.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+
+// Entries of one device and the threads checking them
+struct deviceLane
+{
+    quint64 device = 0;
+    int node = 0;
+    bool rotational = false;
+    // Threads the device should have, and those working on it now
+    int readers = 1;
+    int workers = 0;
+    // Entries still to check, largest file first
+    QVector<int> order;
+    int next = 0;
+
+    int remaining() const { return order.size() - next; }
+};
+
+// Device a thread whose own device has no entries left moves to: one short of its readers,
+// else an SSD, the one with the most entries left. -1 if none.
+int pickLane(const QVector<deviceLane> &lanes)
+{
+    int best = -1;
+    for (int pass = 0; pass < 2 && best < 0; ++pass) {
+        for (int i = 0; i < lanes.size(); ++i) {
+            const deviceLane &lane = lanes.at(i);
+            if (lane.remaining() == 0) continue;
+            if (pass == 0 ? lane.workers >= lane.readers : lane.rotational) continue;
+            if (best < 0 || lane.remaining() > lanes.at(best).remaining()) best = i;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+// State of one run, shared by its threads so a new run never touches the old one's data
+struct manifestVerifier::verifyRun
+{
+    int generation = 0;
+    bool stopOnFailure = false;
+    QVector<checksumEngine::ChecksumType> extraTypes;
+    checksumEngine::IoBackend backend = checksumEngine::BufferedIo;
+    bool updateDatabase = true;
+
+    QVector<checksumManifest::entry> entries;
+    QVector<fileIdentity> identities;
+
+    QMutex mutex;
+    // Entries still to check, by device
+    QVector<deviceLane> lanes;
+    // Threads that have not left work() yet
+    int activeWorkers = 0;
+    bool stopped = false;
+    bool cancelled = false;
+    int passed = 0;
+    int failed = 0;
+    int missing = 0;
+};
+
+// Runs one thread of a verification run, the first one plans the run before it starts checking
+class manifestVerifier::verifyJob : public QRunnable
+{
+public:
+    verifyJob(manifestVerifier *verifier, const QSharedPointer<verifyRun> &run, int lane)
+        : verifier(verifier), state(run), lane(lane)
+    {
+    }
+
+    void run() override
+    {
+        if (lane < 0) {
+            verifier->plan(state);
+        } else {
+            verifier->work(state, lane);
+        }
+    }
+
+private:
+    manifestVerifier *verifier;
+    QSharedPointer<verifyRun> state;
+    // Device the thread starts on, -1 for the thread that plans the run
+    int lane;
+};
+
+/***************************************************************************************************
+* @description : Constructor for manifestVerifier class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+manifestVerifier::manifestVerifier(QObject *parent)
+    : QObject(parent)
+    , currentGeneration(0)
+    , stopOnFailure(false)
+    , backend(checksumEngine::BufferedIo)
+    , updateDatabase(true)
+{
+    qRegisterMetaType<manifestVerifier::result>();
+    qRegisterMetaType<QVector<manifestVerifier::result>>("QVector<manifestVerifier::result>");
+
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+/***************************************************************************************************
+* @description : Destructor for manifestVerifier class.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+manifestVerifier::~manifestVerifier()
+{
+    cancel();
+    pool.waitForDone();
+}
+
+/***************************************************************************************************
+* @description : This function sets whether runs started from now on stop at the first entry
+*                that does not pass.
+* @param : bool stop
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::setStopOnFailure(bool stop)
+{
+    stopOnFailure = stop;
+}
+
+/***************************************************************************************************
+* @description : This function sets checksum types computed in the same read as the listed one.
+* @param : const QVector<ChecksumType> &types
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::setExtraTypes(const QVector<checksumEngine::ChecksumType> &types)
+{
+    extraTypes = types;
+}
+
+/***************************************************************************************************
+* @description : This function sets how files are read.
+* @param : checksumEngine::IoBackend backend
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::setBackend(checksumEngine::IoBackend backend)
+{
+    this->backend = backend;
+}
+
+/***************************************************************************************************
+* @description : This function sets whether checked files update the persistent checksum
+*                database. Files are read either way.
+* @param : bool update
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::setUpdateDatabase(bool update)
+{
+    updateDatabase = update;
+}
+
+/***************************************************************************************************
+* @description : This function sets the number of files checked at the same time.
+* @param : int count
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::setThreadCount(int count)
+{
+    pool.setMaxThreadCount(qMax(1, count));
+}
+
+/***************************************************************************************************
+* @description : This function starts a run. Threads of a cancelled run keep their own state
+*                and finish in the background, so starting never blocks on a large file.
+* @param : const QVector<checksumManifest::entry> &entries
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::start(const QVector<checksumManifest::entry> &entries)
+{
+    cancel();
+
+    QSharedPointer<verifyRun> run(new verifyRun);
+    run->generation = currentGeneration.loadAcquire();
+    run->stopOnFailure = stopOnFailure;
+    run->extraTypes = extraTypes;
+    run->backend = backend;
+    run->updateDatabase = updateDatabase;
+    run->entries = entries;
+    run->activeWorkers = 1;
+    currentRun = run;
+
+    hashStatistics::instance().addQueued(entries.size());
+    pool.start(new verifyJob(this, run, -1));
+}
+
+/***************************************************************************************************
+* @description : This function stops the current run.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::cancel()
+{
+    currentGeneration.fetchAndAddOrdered(1);
+    if (currentRun.isNull()) return;
+
+    QMutexLocker locker(&currentRun->mutex);
+    currentRun->stopped = true;
+    currentRun->cancelled = true;
+}
+
+/***************************************************************************************************
+* @description : This function blocks until no thread of any run is left.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::waitForFinished()
+{
+    pool.waitForDone();
+}
+
+/***************************************************************************************************
+* @description : This function returns the generation of the current run.
+* @param : None
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int manifestVerifier::generation() const
+{
+    return currentGeneration.loadAcquire();
+}
+
+/***************************************************************************************************
+* @description : This function returns the text shown for a status.
+* @param : Status status
+* @return : QString
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QString manifestVerifier::statusText(Status status)
+{
+    switch (status) {
+        case Pending:    return QString();
+        case Passed:     return "OK";
+        case Failed:     return "Mismatch";
+        case Missing:    return "Missing";
+        case Unreadable: return "Unreadable";
+    }
+    return QString();
+}
+
+/***************************************************************************************************
+* @description : This function stats every entry once. Missing files are reported straight
+*                away, the others are split by device and ordered by size, largest first. Every
+*                device gets a node, that of its controller or the one with the fewest devices,
+*                and the threads are dealt out to the devices up to their reader counts. The
+*                planning thread then checks entries itself.
+* @param : const QSharedPointer<verifyRun> &run
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::plan(const QSharedPointer<verifyRun> &run)
+{
+    const int count = run->entries.size();
+    run->identities.resize(count);
+
+    QVector<result> missing;
+    QVector<deviceLane> lanes;
+    QHash<quint64, int> laneOfDevice;
+    for (int i = 0; i < count; ++i) {
+        fileIdentity &identity = run->identities[i];
+        if (fileIdentity::read(run->entries.at(i).filePath, &identity)) {
+            auto found = laneOfDevice.constFind(identity.device);
+            if (found == laneOfDevice.constEnd()) {
+                found = laneOfDevice.insert(identity.device, lanes.size());
+                lanes.append(deviceLane());
+                lanes.last().device = identity.device;
+            }
+            lanes[found.value()].order.append(i);
+            continue;
+        }
+        result missingEntry;
+        missingEntry.index = i;
+        missingEntry.status = Missing;
+        missingEntry.hashed.filePath = run->entries.at(i).filePath;
+        missing.append(missingEntry);
+    }
+
+    QVector<int> lanesOnNode(systemTopology::nodeCount());
+    for (deviceLane &lane : lanes) {
+        std::stable_sort(lane.order.begin(), lane.order.end(), [&run](int a, int b) {
+            return run->identities.at(a).size > run->identities.at(b).size;
+        });
+        lane.rotational = systemTopology::isRotational(lane.device);
+        lane.node = systemTopology::deviceNode(lane.device);
+        if (lane.node < 0) {
+            for (int candidate = 0; candidate < lanesOnNode.size(); ++candidate) {
+                if (systemTopology::cpuCount(candidate) == 0) continue;
+                if (lane.node < 0 || lanesOnNode.at(candidate) < lanesOnNode.at(lane.node)) lane.node = candidate;
+            }
+            lane.node = qMax(0, lane.node);
+        }
+        ++lanesOnNode[lane.node];
+    }
+
+    // One thread per device in turn until every device has its readers. Threads the pool has
+    // beyond that, e.g. from setThreadCount, go to the SSDs.
+    QVector<int> assigned;
+    for (deviceLane &lane : lanes) {
+        lane.readers = systemTopology::readerCount(lane.device, lane.node, lanesOnNode.at(lane.node));
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        for (bool dealt = true; dealt && assigned.size() < pool.maxThreadCount(); ) {
+            dealt = false;
+            for (int i = 0; i < lanes.size() && assigned.size() < pool.maxThreadCount(); ++i) {
+                deviceLane &lane = lanes[i];
+                if (lane.workers >= lane.order.size()) continue;
+                if (pass == 0 ? lane.workers >= lane.readers : lane.rotational) continue;
+                ++lane.workers;
+                assigned.append(i);
+                dealt = true;
+            }
+        }
+    }
+
+    int extraWorkers = assigned.size() - 1;
+    {
+        QMutexLocker locker(&run->mutex);
+        run->lanes = lanes;
+        run->missing += missing.size();
+        if (!missing.isEmpty() && run->stopOnFailure) run->stopped = true;
+        if (run->stopped) extraWorkers = 0;
+        run->activeWorkers += qMax(0, extraWorkers);
+    }
+
+    if (!missing.isEmpty()) {
+        hashStatistics::instance().addCompleted(missing.size());
+        report(run, missing);
+    }
+    for (int i = 1; i <= extraWorkers; ++i) {
+        pool.start(new verifyJob(this, run, assigned.at(i)));
+    }
+    work(run, assigned.isEmpty() ? 0 : assigned.first());
+}
+
+/***************************************************************************************************
+* @description : This function checks entries of its device until none is left or the run
+*                stops, pinned to the device's node. A thread whose device is done moves on to
+*                another device. Files are always read, the checksum database is bypassed but
+*                updated with the result unless that is switched off.
+*                The last thread to leave emits finished.
+* @param : const QSharedPointer<verifyRun> &run, int lane
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::work(const QSharedPointer<verifyRun> &run, int lane)
+{
+    QVector<result> results;
+    QElapsedTimer sinceReport;
+    sinceReport.start();
+    int pinnedLane = -1;
+
+    forever {
+        int index;
+        int node;
+        {
+            QMutexLocker locker(&run->mutex);
+            if (run->stopped) break;
+            if (lane >= run->lanes.size() || run->lanes.at(lane).remaining() == 0) {
+                const int target = pickLane(run->lanes);
+                if (target < 0) break;
+                if (lane < run->lanes.size()) --run->lanes[lane].workers;
+                ++run->lanes[target].workers;
+                lane = target;
+            }
+            deviceLane &current = run->lanes[lane];
+            index = current.order.at(current.next++);
+            node = current.node;
+        }
+        if (lane != pinnedLane) {
+            systemTopology::pinThread(node);
+            pinnedLane = lane;
+        }
+
+        const checksumManifest::entry &item = run->entries.at(index);
+        const fileIdentity &identity = run->identities.at(index);
+
+        QVector<checksumEngine::ChecksumType> types;
+        types << item.type;
+        for (checksumEngine::ChecksumType type : qAsConst(run->extraTypes)) {
+            if (!types.contains(type)) types << type;
+        }
+
+        result checked;
+        checked.index = index;
+        checked.hashed.filePath = item.filePath;
+        checked.hashed.size = identity.size;
+        checked.hashed.modified = QDateTime::fromMSecsSinceEpoch(identity.modified / 1000000);
+        if (run->updateDatabase) {
+            checked.hashed.checksums = checksumDatabase::instance().checksums(identity, types, run->backend, true);
+        } else {
+            checked.hashed.checksums = checksumEngine::CalculateChecksums(item.filePath, types, run->backend);
+        }
+
+        const QString actual = checked.hashed.checksums.value(item.type);
+        if (actual == "ERROR") {
+            checked.status = Unreadable;
+        } else {
+            checked.status = actual.compare(item.expected, Qt::CaseInsensitive) == 0 ? Passed : Failed;
+        }
+
+        {
+            QMutexLocker locker(&run->mutex);
+            switch (checked.status) {
+                case Passed:     ++run->passed;  break;
+                case Failed:     ++run->failed;  break;
+                default:         ++run->missing; break;
+            }
+            if (checked.status != Passed && run->stopOnFailure) run->stopped = true;
+        }
+
+        results.append(checked);
+        if (sinceReport.elapsed() >= ReportIntervalMs) {
+            hashStatistics::instance().addCompleted(results.size());
+            report(run, results);
+            results.clear();
+            sinceReport.restart();
+        }
+    }
+
+    if (!results.isEmpty()) {
+        hashStatistics::instance().addCompleted(results.size());
+        report(run, results);
+    }
+
+    QMutexLocker locker(&run->mutex);
+    if (--run->activeWorkers > 0) return;
+
+    // Entries left over by a stop or cancel
+    for (deviceLane &leftOver : run->lanes) {
+        if (leftOver.remaining() == 0) continue;
+        hashStatistics::instance().addCompleted(leftOver.remaining());
+        leftOver.next = leftOver.order.size();
+    }
+    if (run->cancelled) return;
+
+    const int passed = run->passed;
+    const int failed = run->failed;
+    const int missing = run->missing;
+    locker.unlock();
+    emit finished(passed, failed, missing, run->generation);
+}
+
+/***************************************************************************************************
+* @description : This function forwards results unless their run was cancelled.
+* @param : const QSharedPointer<verifyRun> &run, const QVector<result> &results
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void manifestVerifier::report(const QSharedPointer<verifyRun> &run, const QVector<result> &results)
+{
+    if (run->generation != currentGeneration.loadAcquire()) return;
+
+    emit entriesVerified(results, run->generation);
+}
@@ -0,0 +1,68 @@
+#include "openFolderDelegate.h"
+
+#include <QApplication>
+#include <QPainter>
+#include <QStyle>
+
+// Button and icon size, hover colours follow the flat buttons in styleSheet.qss
+static const int ButtonSize = 36;
+static const int IconSize = 20;
+
+/***************************************************************************************************
+* @description : Constructor for openFolderDelegate class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+openFolderDelegate::openFolderDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+/***************************************************************************************************
+* @description : This function paints a flat folder button centered in the cell, highlighted
+*                while the mouse is over it.
+* @param : QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void openFolderDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    // Row background and selection
+    QStyleOptionViewItem background(option);
+    initStyleOption(&background, index);
+    background.text.clear();
+    background.icon = QIcon();
+    QStyle *style = option.widget ? option.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &background, painter, option.widget);
+
+    QRect button(0, 0, ButtonSize, ButtonSize);
+    button.moveCenter(option.rect.center());
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    if (option.state & QStyle::State_MouseOver) {
+        painter->setPen(QColor("#d0d0d0"));
+        painter->setBrush(QColor("#e0e0e0"));
+        painter->drawRoundedRect(QRectF(button).adjusted(0.5, 0.5, -0.5, -0.5), 4, 4);
+    }
+
+    static const QIcon folderIcon = QApplication::style()->standardIcon(QStyle::SP_DirIcon);
+    QRect iconRect(0, 0, IconSize, IconSize);
+    iconRect.moveCenter(button.center());
+    folderIcon.paint(painter, iconRect);
+    painter->restore();
+}
+
+/***************************************************************************************************
+* @description : This function returns the size of the button cell.
+* @param : const QStyleOptionViewItem &option, const QModelIndex &index
+* @return : QSize
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+QSize openFolderDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+    return QSize(ButtonSize + 8, ButtonSize + 8);
+}
@@ -0,0 +1,72 @@
+#include "progressDelegate.h"
+#include "checksumTableModel.h"
+
+#include <QApplication>
+#include <QPainter>
+#include <QStyle>
+
+// Bar height and horizontal margin, colours follow the checksum text in checksumTableModel
+static const int BarHeight = 18;
+static const int BarMargin = 16;
+
+/***************************************************************************************************
+* @description : Constructor for progressDelegate class.
+* @param : QObject *parent
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+progressDelegate::progressDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+/***************************************************************************************************
+* @description : This function paints a rounded bar filled to the file's progress with the
+*                percentage and read rate on top. Cells without progress are painted as usual.
+* @param : QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void progressDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const int permille = index.data(checksumTableModel::ProgressRole).toInt();
+    if (permille < 0) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    // Row background and selection
+    QStyleOptionViewItem background(option);
+    initStyleOption(&background, index);
+    background.text.clear();
+    QStyle *style = option.widget ? option.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &background, painter, option.widget);
+
+    QRect bar(option.rect.left() + BarMargin, 0, option.rect.width() - 2 * BarMargin, BarHeight);
+    bar.moveTop(option.rect.center().y() - BarHeight / 2);
+
+    QRect filled(bar);
+    filled.setWidth(bar.width() * qBound(0, permille, 1000) / 1000);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor("#e0e0e0"));
+    painter->drawRoundedRect(bar, 4, 4);
+    if (filled.width() > 0) {
+        painter->setBrush(QColor("#0067c0"));
+        painter->drawRoundedRect(filled, 4, 4);
+    }
+
+    const double mbPerSecond = index.data(checksumTableModel::ThroughputRole).toDouble();
+    QString text = QString("%1%").arg(permille / 10);
+    if (mbPerSecond > 0) text += QString("  %1 MB/s").arg(mbPerSecond, 0, 'f', 0);
+
+    QFont font = option.font;
+    font.setPointSize(9);
+    font.setBold(true);
+    painter->setFont(font);
+    painter->setPen(permille >= 500 ? QColor("#ffffff") : QColor("#333333"));
+    painter->drawText(bar, Qt::AlignCenter, text);
+    painter->restore();
+}
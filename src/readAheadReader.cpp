@@ -0,0 +1,770 @@
+#include "readAheadReader.h"
+#include "systemTopology.h"
+
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <functional>
+
+#if defined(Q_OS_LINUX) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+#    include <cerrno>
+#    include <cstring>
+#    if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#      define READAHEAD_HAVE_URING
+#    endif
+#  endif
+#endif
+
+namespace {
+
+#ifdef READAHEAD_HAVE_URING
+
+// Set once io_uring_setup failed, e.g. an old kernel or a seccomp filter, so other threads
+// do not try again
+QAtomicInt uringUnavailable(0);
+
+// Minimal io_uring queue for reads. It talks to the kernel through the raw system calls, so
+// liburing is not needed. Only the owning thread uses it.
+class uringQueue
+{
+public:
+    // Returns nullptr if the kernel does not allow io_uring
+    static uringQueue *create(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const int ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd < 0) return nullptr;
+
+        uringQueue *queue = new uringQueue(ringFd, params);
+        if (!queue->sqes) {
+            delete queue;
+            return nullptr;
+        }
+        return queue;
+    }
+
+    ~uringQueue()
+    {
+        if (sqes) munmap(sqes, sqesSize);
+        if (cqRing) munmap(cqRing, cqRingSize);
+        if (sqRing) munmap(sqRing, sqRingSize);
+        close(ringFd);
+    }
+
+    // Queues a read into iovec slot, submitted by the next submit() or wait()
+    bool queueRead(int fileHandle, void *data, qint64 length, qint64 offset, int slot)
+    {
+        const unsigned tail = *sqTail;
+        if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) return false;
+
+        // READV rather than READ works on every io_uring kernel (5.1+)
+        vectors[slot].iov_base = data;
+        vectors[slot].iov_len = static_cast<size_t>(length);
+
+        const unsigned index = tail & sqMask;
+        io_uring_sqe *sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = fileHandle;
+        sqe->off = static_cast<quint64>(offset);
+        sqe->addr = reinterpret_cast<quintptr>(&vectors[slot]);
+        sqe->len = 1;
+        sqe->user_data = static_cast<quint64>(slot);
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++queued;
+        return true;
+    }
+
+    // Hands the queued reads to the kernel without waiting
+    bool submit()
+    {
+        return enter(0);
+    }
+
+    // Returns the next completion, waiting for one if none is ready
+    bool wait(int *slot, int *result)
+    {
+        for (;;) {
+            if (queued == 0 && pop(slot, result)) return true;
+            if (!enter(1)) return false;
+        }
+    }
+
+private:
+    uringQueue(int ringFd, const io_uring_params &params)
+        : ringFd(ringFd)
+        , sqRing(nullptr)
+        , cqRing(nullptr)
+        , sqes(nullptr)
+        , queued(0)
+    {
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        sqRing = mapRing(sqRingSize, IORING_OFF_SQ_RING);
+        cqRing = mapRing(cqRingSize, IORING_OFF_CQ_RING);
+        void *sqeArea = mapRing(sqesSize, IORING_OFF_SQES);
+        if (!sqRing || !cqRing || !sqeArea) {
+            if (sqeArea) munmap(sqeArea, sqesSize);
+            return;
+        }
+        sqes = static_cast<io_uring_sqe *>(sqeArea);
+
+        char *sq = static_cast<char *>(sqRing);
+        sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqEntries = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_entries);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+        char *cq = static_cast<char *>(cqRing);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    }
+
+    void *mapRing(size_t size, off_t offset)
+    {
+        void *area = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+        return area == MAP_FAILED ? nullptr : area;
+    }
+
+    // Submits what is queued and waits for minComplete completions
+    bool enter(unsigned minComplete)
+    {
+        while (queued > 0 || minComplete > 0) {
+            const long submitted = syscall(__NR_io_uring_enter, ringFd, queued, minComplete,
+                                           minComplete > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            queued -= static_cast<unsigned>(submitted);
+            if (minComplete > 0 || queued == 0) return true;
+        }
+        return true;
+    }
+
+    bool pop(int *slot, int *result)
+    {
+        const unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) return false;
+        const io_uring_cqe &cqe = cqes[head & cqMask];
+        *slot = static_cast<int>(cqe.user_data);
+        *result = cqe.res;
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    int ringFd;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned sqMask;
+    unsigned sqEntries;
+    unsigned *sqArray;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned cqMask;
+    io_uring_cqe *cqes;
+
+    // Reads queued but not yet taken by the kernel
+    unsigned queued;
+    iovec vectors[readAheadReader::Depth];
+};
+
+#endif // READAHEAD_HAVE_URING
+
+// Threads of ThreadRead readers. A reader whose job cannot start right away reads
+// synchronously instead of waiting for a free thread.
+class readerPoolHolder
+{
+public:
+    readerPoolHolder()
+    {
+        // Enough for the file pools and the range pool reading at the same time
+        pool.setMaxThreadCount(QThread::idealThreadCount() * 2);
+    }
+    QThreadPool pool;
+};
+Q_GLOBAL_STATIC(readerPoolHolder, readerPool)
+
+// Runs the read loop of one ThreadRead reader
+class readerJob : public QRunnable
+{
+public:
+    explicit readerJob(const std::function<void()> &work)
+        : work(work)
+    {
+    }
+
+    void run() override
+    {
+        work();
+    }
+
+private:
+    std::function<void()> work;
+};
+
+} // namespace
+
+// Ring of BlockSize buffers owned by one thread, placed on the node it runs on
+struct readAheadReader::context
+{
+    context()
+        : node(-1)
+        , busy(false)
+#ifdef READAHEAD_HAVE_URING
+        , uring(nullptr)
+        , uringTried(false)
+#endif
+    {
+        for (char *&block : blocks) block = nullptr;
+    }
+
+    ~context()
+    {
+#ifdef READAHEAD_HAVE_URING
+        delete uring;
+#endif
+        releaseBlocks();
+    }
+
+    char *buffer(int index)
+    {
+        if (!blocks[index]) {
+            blocks[index] = static_cast<char *>(systemTopology::allocate(BlockSize));
+            Q_CHECK_PTR(blocks[index]);
+        }
+        return blocks[index];
+    }
+
+    // Drops buffers that were placed on another node than the one the thread is pinned to now
+    void followNode()
+    {
+        const int threadNode = systemTopology::threadNode();
+        if (threadNode == node) return;
+        releaseBlocks();
+        node = threadNode;
+    }
+
+    void releaseBlocks()
+    {
+        for (char *&block : blocks) {
+            systemTopology::release(block, BlockSize);
+            block = nullptr;
+        }
+    }
+
+    char *blocks[Depth];
+    // Node the buffers were allocated for, -1 for wherever the thread ran
+    int node;
+    // A reader of this thread is using the buffers
+    bool busy;
+#ifdef READAHEAD_HAVE_URING
+    uringQueue *uring;
+    bool uringTried;
+
+    // The thread's queue, created on first use
+    uringQueue *queue()
+    {
+        if (!uringTried && !uringUnavailable.loadAcquire()) {
+            uringTried = true;
+            uring = uringQueue::create(2 * Depth);
+            if (!uring) uringUnavailable.storeRelease(1);
+        }
+        return uring;
+    }
+#endif
+};
+
+// Blocks passed from the pool thread of a ThreadRead to the consumer. lengths[i] is the byte
+// count of buffers[i], 0 at the end of the range and -1 after an error.
+struct readAheadReader::threadPipeline
+{
+    QFile *file;
+    qint64 offset;
+    qint64 end;
+    char *buffers[Depth];
+    qint64 lengths[Depth];
+    QSemaphore freeSlots;
+    QSemaphore filledSlots;
+    QSemaphore done;
+    QAtomicInt stop;
+};
+
+
+/***************************************************************************************************
+* @description : Constructor. Picks io_uring for regular files when it is available, a reader
+*                thread otherwise, and plain reads for ranges of a single block. A second reader
+*                on the same thread gets buffers of its own.
+* @param : QFile &file, qint64 offset, qint64 end
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+readAheadReader::readAheadReader(QFile &file, qint64 offset, qint64 end)
+    : file(file)
+    , offset(offset)
+    , end(end)
+    , usedMethod(SyncRead)
+    , finished(false)
+    , error(false)
+    , buffers(threadContext())
+    , ownsBuffers(false)
+    , head(0)
+    , recycleHead(false)
+    , pipeline(nullptr)
+    , readIndex(0)
+    , holdingSlot(false)
+{
+    if (buffers->busy) {
+        buffers = new context;
+        ownsBuffers = true;
+    }
+    buffers->followNode();
+    buffers->busy = true;
+
+    for (uringSlot &slot : slots) {
+        slot = uringSlot{ 0, 0, 0, false, 0 };
+    }
+
+    // Nothing to overlap with a single block
+    if (end >= 0 && end - offset <= BlockSize) return;
+
+    if (!file.isSequential() && startUring()) return;
+    startThread();
+}
+
+/***************************************************************************************************
+* @description : Destructor. Stops the reader thread or waits for the io_uring reads still in
+*                flight, they write into buffers the next reader reuses.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+readAheadReader::~readAheadReader()
+{
+    if (usedMethod == ThreadRead) {
+        pipeline->stop.storeRelease(1);
+        pipeline->freeSlots.release(Depth);
+        pipeline->done.acquire();
+        delete pipeline;
+    } else if (usedMethod == UringRead) {
+        drainUring();
+    }
+
+    buffers->busy = false;
+    if (ownsBuffers) delete buffers;
+}
+
+/***************************************************************************************************
+* @description : This function returns the next block of the range in file order.
+* @param : const unsigned char **data, qint64 *length
+* @return : bool - false at the end of the range or after an error
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::next(const unsigned char **data, qint64 *length)
+{
+    if (finished) return false;
+
+    switch (usedMethod) {
+        case UringRead:  return nextUring(data, length);
+        case ThreadRead: return nextThread(data, length);
+        case SyncRead:   return nextSync(data, length);
+    }
+    return false;
+}
+
+/***************************************************************************************************
+* @description : This function tells whether a read failed or a bounded range ended early.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::failed() const
+{
+    return error;
+}
+
+/***************************************************************************************************
+* @description : This function returns how this reader gets its blocks.
+* @param : None
+* @return : Method
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+readAheadReader::Method readAheadReader::method() const
+{
+    return usedMethod;
+}
+
+/***************************************************************************************************
+* @description : This function returns the method used for regular files, probing io_uring on
+*                the calling thread.
+* @param : None
+* @return : Method
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+readAheadReader::Method readAheadReader::preferredMethod()
+{
+#ifdef READAHEAD_HAVE_URING
+    if (threadContext()->queue()) return UringRead;
+#endif
+    return ThreadRead;
+}
+
+/***************************************************************************************************
+* @description : This function returns a human readable method name.
+* @param : Method method
+* @return : const char *
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+const char *readAheadReader::methodName(Method method)
+{
+    switch (method) {
+        case SyncRead:   return "sync";
+        case ThreadRead: return "thread";
+        case UringRead:  return "io_uring";
+    }
+    return "unknown";
+}
+
+/***************************************************************************************************
+* @description : This function returns the buffers of the calling thread, created on first use
+*                and deleted when the thread ends.
+* @param : None
+* @return : context *
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+readAheadReader::context *readAheadReader::threadContext()
+{
+    thread_local context buffers;
+    return &buffers;
+}
+
+/***************************************************************************************************
+* @description : This function is the loop of a ThreadRead's pool thread. It fills the free
+*                buffers in ring order until the range ends, a read fails or the reader stops it.
+* @param : threadPipeline *pipeline
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void readAheadReader::readAhead(threadPipeline *pipeline)
+{
+    int index = 0;
+    for (;;) {
+        pipeline->freeSlots.acquire();
+        if (pipeline->stop.loadAcquire()) break;
+
+        qint64 wanted = BlockSize;
+        if (pipeline->end >= 0 && pipeline->end - pipeline->offset < wanted) {
+            wanted = pipeline->end - pipeline->offset;
+        }
+
+        qint64 length = 0;
+        if (wanted > 0) {
+            length = pipeline->file->read(pipeline->buffers[index], wanted);
+            // A bounded range must not end early
+            if (length == 0 && pipeline->end >= 0) length = -1;
+        }
+        pipeline->lengths[index] = length;
+        pipeline->filledSlots.release();
+        if (length <= 0) break;
+
+        pipeline->offset += length;
+        index = (index + 1) % Depth;
+    }
+    pipeline->done.release();
+}
+
+/***************************************************************************************************
+* @description : This function requests the first Depth blocks through the thread's io_uring
+*                queue.
+* @param : None
+* @return : bool - false if io_uring cannot be used
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::startUring()
+{
+#ifdef READAHEAD_HAVE_URING
+    if (!buffers->queue()) return false;
+
+    usedMethod = UringRead;
+    for (int slot = 0; slot < Depth; ++slot) {
+        queueSlot(slot);
+    }
+    if (!buffers->uring->submit()) error = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function starts a pool thread that reads ahead into the ring of buffers.
+* @param : None
+* @return : bool - false if no pool thread is free, the reader then stays synchronous
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::startThread()
+{
+    pipeline = new threadPipeline;
+    pipeline->file = &file;
+    pipeline->offset = offset;
+    pipeline->end = end;
+    for (int i = 0; i < Depth; ++i) {
+        pipeline->buffers[i] = buffers->buffer(i);
+        pipeline->lengths[i] = 0;
+    }
+    pipeline->freeSlots.release(Depth);
+
+    // The reader runs where its consumer is pinned, so the blocks it reads stay on that node
+    threadPipeline *shared = pipeline;
+    const int node = systemTopology::threadNode();
+    if (!readerPool()->pool.tryStart(new readerJob([shared, node]() {
+            systemTopology::pinThread(node);
+            readAhead(shared);
+        }))) {
+        delete pipeline;
+        pipeline = nullptr;
+        return false;
+    }
+    usedMethod = ThreadRead;
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function hands out the head block of the io_uring ring. Once a block has
+*                been consumed its slot is requeued for the block Depth places further on. A
+*                short read hands out what arrived and requests the rest of the block into the
+*                same buffer behind it.
+* @param : const unsigned char **data, qint64 *length
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::nextUring(const unsigned char **data, qint64 *length)
+{
+#ifdef READAHEAD_HAVE_URING
+    if (recycleHead) {
+        recycleHead = false;
+        queueSlot(head);
+        if (!error && !buffers->uring->submit()) error = true;
+        head = (head + 1) % Depth;
+    }
+
+    uringSlot &slot = slots[head];
+    while (!error && slot.length > 0) {
+        if (!waitForSlot(head)) {
+            error = true;
+        } else if (slot.result == -EINTR || slot.result == -EAGAIN) {
+            queueRemainder(head);
+            if (!error && !buffers->uring->submit()) error = true;
+        } else {
+            break;
+        }
+    }
+
+    if (error || slot.length == 0 || slot.result <= 0) {
+        // End of file: an error for a bounded range, the end for an open one
+        if (slot.length > 0 && (slot.result < 0 || end >= 0)) error = true;
+        finished = true;
+        return false;
+    }
+
+    *data = reinterpret_cast<const unsigned char *>(buffers->buffer(head)) + slot.received;
+    *length = slot.result;
+    slot.received += slot.result;
+
+    if (slot.received < slot.length) {
+        queueRemainder(head);
+        if (!error && !buffers->uring->submit()) error = true;
+    } else {
+        recycleHead = true;
+    }
+    return true;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(length);
+    return false;
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function hands out the next block filled by the reader thread and
+*                returns the previous one to it.
+* @param : const unsigned char **data, qint64 *length
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::nextThread(const unsigned char **data, qint64 *length)
+{
+    if (holdingSlot) {
+        pipeline->freeSlots.release();
+        holdingSlot = false;
+    }
+
+    pipeline->filledSlots.acquire();
+    const qint64 filled = pipeline->lengths[readIndex];
+    if (filled <= 0) {
+        error = filled < 0;
+        finished = true;
+        return false;
+    }
+
+    *data = reinterpret_cast<const unsigned char *>(pipeline->buffers[readIndex]);
+    *length = filled;
+    readIndex = (readIndex + 1) % Depth;
+    holdingSlot = true;
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function reads the next block on the calling thread.
+* @param : const unsigned char **data, qint64 *length
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::nextSync(const unsigned char **data, qint64 *length)
+{
+    const qint64 wanted = nextBlockLength();
+    if (wanted == 0) {
+        finished = true;
+        return false;
+    }
+
+    char *buffer = buffers->buffer(0);
+    const qint64 bytesRead = file.read(buffer, wanted);
+    if (bytesRead <= 0) {
+        error = bytesRead < 0 || end >= 0;
+        finished = true;
+        return false;
+    }
+
+    *data = reinterpret_cast<const unsigned char *>(buffer);
+    *length = bytesRead;
+    offset += bytesRead;
+    return true;
+}
+
+/***************************************************************************************************
+* @description : This function returns the size of the next block to request.
+* @param : None
+* @return : qint64 - 0 once the range is exhausted
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+qint64 readAheadReader::nextBlockLength() const
+{
+    if (end < 0) return BlockSize;
+    return qMin<qint64>(BlockSize, end - offset);
+}
+
+/***************************************************************************************************
+* @description : This function queues a read of the next block into slot, or marks the slot
+*                unused when the range is exhausted. Sets error if the queue is full.
+* @param : int slot
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void readAheadReader::queueSlot(int slot)
+{
+    const qint64 length = nextBlockLength();
+    slots[slot] = uringSlot{ offset, length, 0, false, 0 };
+    if (length <= 0) {
+        slots[slot].length = 0;
+        return;
+    }
+    offset += length;
+    queueRemainder(slot);
+}
+
+/***************************************************************************************************
+* @description : This function queues a read of the part of a block that has not arrived yet.
+*                It lands behind the part already handed out, which the consumer may still use.
+*                The read is sent to the kernel by the next submit. Sets error if the queue is full.
+* @param : int slot
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void readAheadReader::queueRemainder(int slot)
+{
+#ifdef READAHEAD_HAVE_URING
+    uringSlot &block = slots[slot];
+    if (!buffers->uring->queueRead(file.handle(), buffers->buffer(slot) + block.received,
+                                   block.length - block.received, block.offset + block.received, slot)) {
+        error = true;
+        return;
+    }
+    block.inFlight = true;
+#else
+    Q_UNUSED(slot);
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function collects io_uring completions until slot's read is complete.
+*                Completions of other slots are stored with their slot.
+* @param : int slot
+* @return : bool - false if the queue failed
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool readAheadReader::waitForSlot(int slot)
+{
+#ifdef READAHEAD_HAVE_URING
+    while (slots[slot].inFlight) {
+        int completed = 0;
+        int result = 0;
+        if (!buffers->uring->wait(&completed, &result)) return false;
+        slots[completed].inFlight = false;
+        slots[completed].result = result;
+    }
+    return true;
+#else
+    Q_UNUSED(slot);
+    return false;
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function waits for every read still in flight. If the queue itself fails
+*                the kernel may still write into the buffers, so they are given up and the
+*                thread gets a new queue.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void readAheadReader::drainUring()
+{
+#ifdef READAHEAD_HAVE_URING
+    for (int slot = 0; slot < Depth; ++slot) {
+        if (waitForSlot(slot)) continue;
+
+        for (char *&block : buffers->blocks) {
+            // Deliberately leaked, the kernel may still write into it
+            block = nullptr;
+        }
+        delete buffers->uring;
+        buffers->uring = nullptr;
+        buffers->uringTried = false;
+        return;
+    }
+#endif
+}
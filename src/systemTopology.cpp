@@ -0,0 +1,443 @@
+#include "systemTopology.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#if defined(Q_OS_LINUX)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_DARWIN)
+#include <sys/sysctl.h>
+#endif
+
+namespace {
+
+// Node the calling thread is pinned to
+thread_local int pinnedNode = -1;
+
+// What is known about one block device
+struct deviceInfo
+{
+    int node;
+    bool rotational;
+};
+
+#ifdef Q_OS_LINUX
+
+// Policy of mbind that prefers a node but falls back to others, MPOL_PREFERRED in numaif.h
+const int PreferredPolicy = 1;
+// Nodes a placement mask can name
+const int MaxMaskNodes = 1024;
+
+// First line of a sysfs attribute, empty if it cannot be read
+QByteArray readAttribute(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+    return file.readLine().trimmed();
+}
+
+// Numbers of a sysfs list such as "0-3,8-11"
+QVector<int> parseList(const QByteArray &text)
+{
+    QVector<int> numbers;
+    for (const QByteArray &part : text.split(',')) {
+        if (part.isEmpty()) continue;
+        const int dash = part.indexOf('-');
+        bool firstOk = false;
+        bool lastOk = false;
+        const int first = part.left(dash < 0 ? part.size() : dash).toInt(&firstOk);
+        const int last = dash < 0 ? first : part.mid(dash + 1).toInt(&lastOk);
+        if (!firstOk || (dash >= 0 && !lastOk)) continue;
+        for (int number = first; number <= last; ++number) numbers.append(number);
+    }
+    return numbers;
+}
+
+// Size attribute of a cache such as "1024K" or "2M" in bytes
+qint64 parseSize(const QByteArray &text)
+{
+    if (text.isEmpty()) return 0;
+    qint64 factor = 1;
+    QByteArray digits = text;
+    switch (text.at(text.size() - 1)) {
+        case 'K': factor = 1024;        digits.chop(1); break;
+        case 'M': factor = 1024 * 1024; digits.chop(1); break;
+        default: break;
+    }
+    return digits.toLongLong() * factor;
+}
+
+// Looks for an attribute in a sysfs device directory and the directories above it
+QByteArray findAttribute(QString directory, const QString &name)
+{
+    while (directory.startsWith("/sys/devices/")) {
+        const QString path = directory + '/' + name;
+        if (QFileInfo::exists(path)) return readAttribute(path);
+        directory = directory.left(directory.lastIndexOf('/'));
+    }
+    return QByteArray();
+}
+
+#endif // Q_OS_LINUX
+
+} // namespace
+
+// Everything read once per process
+struct systemTopology::topology
+{
+    // CPUs of every node this process may use, indexed by node number
+    QVector<QVector<int>> nodeCpus;
+    // Node of every CPU, indexed by CPU number, -1 for CPUs of no node
+    QVector<int> cpuNodes;
+    qint64 l2Size;
+#if defined(Q_OS_LINUX)
+    // CPUs the process was started with, pinning never leaves them
+    cpu_set_t processCpus;
+#elif defined(Q_OS_WIN)
+    DWORD_PTR processCpus;
+#endif
+
+    QMutex mutex;
+    QHash<quint64, deviceInfo> devices;
+
+    topology();
+    deviceInfo device(quint64 device);
+};
+
+/***************************************************************************************************
+* @description : Constructor. Reads the nodes, their CPUs and the L2 cache size. CPUs outside
+*                the affinity the process was started with are left out, so pinning respects
+*                taskset and cgroup limits.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+systemTopology::topology::topology()
+    : l2Size(0)
+{
+#if defined(Q_OS_LINUX)
+    CPU_ZERO(&processCpus);
+    if (sched_getaffinity(getpid(), sizeof(processCpus), &processCpus) != 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) CPU_SET(cpu, &processCpus);
+    }
+
+    for (int node : parseList(readAttribute("/sys/devices/system/node/online"))) {
+        const QByteArray cpuList = readAttribute(QString("/sys/devices/system/node/node%1/cpulist").arg(node));
+        if (node >= nodeCpus.size()) nodeCpus.resize(node + 1);
+        for (int cpu : parseList(cpuList)) {
+            if (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &processCpus)) continue;
+            nodeCpus[node].append(cpu);
+            while (cpuNodes.size() <= cpu) cpuNodes.append(-1);
+            cpuNodes[cpu] = node;
+        }
+    }
+
+    for (int index = 0; index < 8 && l2Size == 0; ++index) {
+        const QString cache = QString("/sys/devices/system/cpu/cpu0/cache/index%1/").arg(index);
+        if (readAttribute(cache + "level") != "2" || readAttribute(cache + "type") == "Instruction") continue;
+        l2Size = parseSize(readAttribute(cache + "size"));
+    }
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    if (l2Size <= 0) l2Size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+#elif defined(Q_OS_WIN)
+    DWORD_PTR systemCpus = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processCpus, &systemCpus)) processCpus = ~DWORD_PTR(0);
+
+    ULONG highestNode = 0;
+    if (GetNumaHighestNodeNumber(&highestNode)) {
+        for (ULONG node = 0; node <= highestNode && node < 64; ++node) {
+            ULONGLONG mask = 0;
+            if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask)) continue;
+            mask &= processCpus;
+            if (int(node) >= nodeCpus.size()) nodeCpus.resize(node + 1);
+            for (int cpu = 0; cpu < int(sizeof(DWORD_PTR) * 8); ++cpu) {
+                if (!(mask & (ULONGLONG(1) << cpu))) continue;
+                nodeCpus[node].append(cpu);
+                while (cpuNodes.size() <= cpu) cpuNodes.append(-1);
+                cpuNodes[cpu] = int(node);
+            }
+        }
+    }
+
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    QVector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> entries(int(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION)));
+    if (!entries.isEmpty() && GetLogicalProcessorInformation(entries.data(), &length)) {
+        for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION &entry : qAsConst(entries)) {
+            if (entry.Relationship != RelationCache || entry.Cache.Level != 2) continue;
+            if (entry.Cache.Type == CacheInstruction) continue;
+            l2Size = entry.Cache.Size;
+            break;
+        }
+    }
+#elif defined(Q_OS_DARWIN)
+    quint64 size = 0;
+    size_t sizeLength = sizeof(size);
+    if (sysctlbyname("hw.l2cachesize", &size, &sizeLength, nullptr, 0) == 0) l2Size = qint64(size);
+#endif
+
+    // Nodes without a usable CPU do not count, a machine without node information is one node
+    while (!nodeCpus.isEmpty() && nodeCpus.last().isEmpty()) nodeCpus.removeLast();
+    if (nodeCpus.isEmpty()) {
+        nodeCpus.resize(1);
+        cpuNodes.clear();
+    }
+    if (l2Size <= 0) l2Size = 256 * 1024;
+}
+
+/***************************************************************************************************
+* @description : This function returns the node and kind of a block device. On Linux the device
+*                is looked up under /sys/dev/block, the node is that of the nearest controller
+*                above it and the rotational flag that of the disk holding a partition. Results
+*                are kept for the life of the process.
+* @param : quint64 device
+* @return : deviceInfo
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+deviceInfo systemTopology::topology::device(quint64 device)
+{
+    QMutexLocker locker(&mutex);
+    const auto found = devices.constFind(device);
+    if (found != devices.constEnd()) return found.value();
+    locker.unlock();
+
+    deviceInfo info = { -1, false };
+#ifdef Q_OS_LINUX
+    const dev_t number = static_cast<dev_t>(device);
+    const QString link = QString("/sys/dev/block/%1:%2").arg(major(number)).arg(minor(number));
+    const QString directory = QFileInfo(link).canonicalFilePath();
+    if (!directory.isEmpty()) {
+        bool ok = false;
+        const int node = findAttribute(directory, "numa_node").toInt(&ok);
+        if (ok && node >= 0 && node < nodeCpus.size() && !nodeCpus.at(node).isEmpty()) info.node = node;
+        info.rotational = findAttribute(directory, "queue/rotational") == "1";
+    }
+#endif
+
+    locker.relock();
+    devices.insert(device, info);
+    return info;
+}
+
+/***************************************************************************************************
+* @description : This function returns the topology of the machine, read on first use.
+* @param : None
+* @return : topology &
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+systemTopology::topology &systemTopology::instance()
+{
+    static topology machine;
+    return machine;
+}
+
+/***************************************************************************************************
+* @description : This function returns the number of NUMA nodes.
+* @param : None
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int systemTopology::nodeCount()
+{
+    return instance().nodeCpus.size();
+}
+
+/***************************************************************************************************
+* @description : This function returns how many CPUs of a node this process may run on. Without
+*                node information every CPU belongs to node 0.
+* @param : int node
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int systemTopology::cpuCount(int node)
+{
+    const topology &machine = instance();
+    if (node < 0 || node >= machine.nodeCpus.size()) return 0;
+    if (machine.cpuNodes.isEmpty()) return qMax(1, QThread::idealThreadCount());
+    return machine.nodeCpus.at(node).size();
+}
+
+/***************************************************************************************************
+* @description : This function returns the node of the CPU the calling thread runs on. An
+*                unpinned thread may be moved right after the call.
+* @param : None
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int systemTopology::currentNode()
+{
+    if (pinnedNode >= 0) return pinnedNode;
+
+    const topology &machine = instance();
+    int cpu = -1;
+#if defined(Q_OS_LINUX)
+    cpu = sched_getcpu();
+#elif defined(Q_OS_WIN)
+    cpu = int(GetCurrentProcessorNumber());
+#endif
+    if (cpu < 0 || cpu >= machine.cpuNodes.size()) return 0;
+    return qMax(0, machine.cpuNodes.at(cpu));
+}
+
+/***************************************************************************************************
+* @description : This function returns the node of the controller a block device hangs off.
+* @param : quint64 device
+* @return : int - -1 if unknown, e.g. for network and memory file systems
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int systemTopology::deviceNode(quint64 device)
+{
+    return instance().device(device).node;
+}
+
+/***************************************************************************************************
+* @description : This function tells whether a block device is a spinning disk.
+* @param : quint64 device
+* @return : bool - false if unknown
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool systemTopology::isRotational(quint64 device)
+{
+    return instance().device(device).rotational;
+}
+
+/***************************************************************************************************
+* @description : This function returns how many threads should read a device at once. A
+*                spinning disk gets RotationalReaders, an SSD the CPUs of the node shared with
+*                the other devices on that node, at least two so reads and hashing overlap.
+* @param : quint64 device, int node, int devicesOnNode
+* @return : int
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int systemTopology::readerCount(quint64 device, int node, int devicesOnNode)
+{
+    if (isRotational(device)) return RotationalReaders;
+
+    const int cpus = node >= 0 ? cpuCount(node) : qMax(1, QThread::idealThreadCount());
+    return qMax(2, cpus / qMax(1, devicesOnNode));
+}
+
+/***************************************************************************************************
+* @description : This function returns the size of the L2 cache of one core.
+* @param : None
+* @return : qint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+qint64 systemTopology::l2CacheSize()
+{
+    return instance().l2Size;
+}
+
+/***************************************************************************************************
+* @description : This function pins the calling thread to the CPUs of a node. Pinning to the
+*                node the thread is pinned to already costs nothing.
+* @param : int node - -1 to let the thread run on every CPU of the process again
+* @return : bool - whether the thread is pinned now
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool systemTopology::pinThread(int node)
+{
+    const topology &machine = instance();
+    if (node >= machine.nodeCpus.size() || (node >= 0 && machine.nodeCpus.at(node).isEmpty())) node = -1;
+    if (node == pinnedNode) return node >= 0;
+    if (machine.nodeCpus.size() <= 1) return false;
+
+#if defined(Q_OS_LINUX)
+    cpu_set_t cpus;
+    if (node < 0) {
+        cpus = machine.processCpus;
+    } else {
+        CPU_ZERO(&cpus);
+        for (int cpu : machine.nodeCpus.at(node)) CPU_SET(cpu, &cpus);
+    }
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) return false;
+#elif defined(Q_OS_WIN)
+    DWORD_PTR cpus = machine.processCpus;
+    if (node >= 0) {
+        cpus = 0;
+        for (int cpu : machine.nodeCpus.at(node)) cpus |= DWORD_PTR(1) << cpu;
+    }
+    if (!SetThreadAffinityMask(GetCurrentThread(), cpus)) return false;
+#else
+    return false;
+#endif
+
+    pinnedNode = node;
+    return node >= 0;
+}
+
+/***************************************************************************************************
+* @description : This function returns the node the calling thread is pinned to.
+* @param : None
+* @return : int - -1 if the thread is not pinned
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+int systemTopology::threadNode()
+{
+    return pinnedNode;
+}
+
+/***************************************************************************************************
+* @description : This function allocates page aligned memory on the calling thread's node. A
+*                pinned thread asks for its node explicitly, otherwise the pages land wherever
+*                the thread first writes them, which is its own node as well.
+* @param : qint64 size
+* @return : void *
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void *systemTopology::allocate(qint64 size)
+{
+#if defined(Q_OS_LINUX)
+    void *data = mmap(nullptr, size_t(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) return nullptr;
+#ifdef __NR_mbind
+    if (pinnedNode >= 0 && pinnedNode < MaxMaskNodes && nodeCount() > 1) {
+        unsigned long mask[MaxMaskNodes / (8 * sizeof(unsigned long))] = {};
+        mask[pinnedNode / (8 * sizeof(unsigned long))] |= 1UL << (pinnedNode % (8 * sizeof(unsigned long)));
+        // A failure only loses the explicit placement, first touch still applies
+        syscall(__NR_mbind, data, size_t(size), PreferredPolicy, mask, MaxMaskNodes + 1, 0);
+    }
+#endif
+    return data;
+#elif defined(Q_OS_WIN)
+    if (pinnedNode >= 0 && nodeCount() > 1) {
+        return VirtualAllocExNuma(GetCurrentProcess(), nullptr, SIZE_T(size), MEM_RESERVE | MEM_COMMIT,
+                                  PAGE_READWRITE, DWORD(pinnedNode));
+    }
+    return VirtualAlloc(nullptr, SIZE_T(size), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    return qMallocAligned(size_t(size), 4096);
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function frees memory from allocate().
+* @param : void *data, qint64 size
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void systemTopology::release(void *data, qint64 size)
+{
+    if (!data) return;
+#if defined(Q_OS_LINUX)
+    munmap(data, size_t(size));
+#elif defined(Q_OS_WIN)
+    Q_UNUSED(size);
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    Q_UNUSED(size);
+    qFreeAligned(data);
+#endif
+}
@@ -0,0 +1,603 @@
+#include "xxh3Engine.h"
+
+#include <QtEndian>
+#include <QByteArray>
+
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86_64) || (defined(Q_PROCESSOR_X86) && defined(__SSE2__))
+#  define XXH3_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if defined(Q_CC_MSVC) && defined(Q_PROCESSOR_X86_64)
+#  include <intrin.h>
+#endif
+
+namespace {
+
+const quint32 Prime32_1 = 0x9E3779B1U;
+const quint32 Prime32_2 = 0x85EBCA77U;
+const quint32 Prime32_3 = 0xC2B2AE3DU;
+const quint64 Prime64_1 = Q_UINT64_C(0x9E3779B185EBCA87);
+const quint64 Prime64_2 = Q_UINT64_C(0xC2B2AE3D27D4EB4F);
+const quint64 Prime64_3 = Q_UINT64_C(0x165667B19E3779F9);
+const quint64 Prime64_4 = Q_UINT64_C(0x85EBCA77C2B2AE63);
+const quint64 Prime64_5 = Q_UINT64_C(0x27D4EB2F165667C5);
+const quint64 PrimeMx1 = Q_UINT64_C(0x165667919E3779F9);
+const quint64 PrimeMx2 = Q_UINT64_C(0x9FB21C651E98DF25);
+
+const int StripeLength = 64;
+const int SecretConsumeRate = 8;
+const int SecretSize = 192;
+const int SecretMergeAccsStart = 11;
+const int SecretLastAccStart = 7;
+const int MidSizeMax = 240;
+const int MidSizeStartOffset = 3;
+const int MidSizeLastOffset = 17;
+const int SecretSizeMin = 136;
+const int StripesPerBlock = (SecretSize - StripeLength) / SecretConsumeRate;
+
+alignas(64) const unsigned char Secret[SecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+const quint64 InitialAcc[8] = {
+    Prime32_3, Prime64_1, Prime64_2, Prime64_3, Prime64_4, Prime32_2, Prime64_5, Prime32_1
+};
+
+inline quint32 read32(const unsigned char *p) { return qFromLittleEndian<quint32>(p); }
+inline quint64 read64(const unsigned char *p) { return qFromLittleEndian<quint64>(p); }
+
+inline quint32 swap32(quint32 x)
+{
+    return (x >> 24) | ((x >> 8) & 0xFF00) | ((x << 8) & 0xFF0000) | (x << 24);
+}
+
+inline quint64 swap64(quint64 x)
+{
+    return (quint64(swap32(static_cast<quint32>(x))) << 32) | swap32(static_cast<quint32>(x >> 32));
+}
+
+inline quint64 rotl64(quint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+inline quint32 rotl32(quint32 x, int r) { return (x << r) | (x >> (32 - r)); }
+
+inline quint64 mult32to64(quint64 a, quint64 b)
+{
+    return (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+}
+
+// Full 64 x 64 -> 128 bit product
+inline xxh3Engine::value128 mult64to128(quint64 a, quint64 b)
+{
+    xxh3Engine::value128 r;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    r.low = static_cast<quint64>(product);
+    r.high = static_cast<quint64>(product >> 64);
+#elif defined(Q_CC_MSVC) && defined(Q_PROCESSOR_X86_64)
+    r.low = _umul128(a, b, &r.high);
+#else
+    quint64 loLo = mult32to64(a, b);
+    quint64 hiLo = mult32to64(a >> 32, b);
+    quint64 loHi = mult32to64(a, b >> 32);
+    quint64 hiHi = mult32to64(a >> 32, b >> 32);
+    quint64 cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+    r.high = (hiLo >> 32) + (cross >> 32) + hiHi;
+    r.low = (cross << 32) | (loLo & 0xFFFFFFFF);
+#endif
+    return r;
+}
+
+inline quint64 mul128fold64(quint64 a, quint64 b)
+{
+    xxh3Engine::value128 product = mult64to128(a, b);
+    return product.low ^ product.high;
+}
+
+inline quint64 xxh64Avalanche(quint64 h)
+{
+    h ^= h >> 33;
+    h *= Prime64_2;
+    h ^= h >> 29;
+    h *= Prime64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline quint64 avalanche(quint64 h)
+{
+    h ^= h >> 37;
+    h *= PrimeMx1;
+    h ^= h >> 32;
+    return h;
+}
+
+inline quint64 rrmxmx(quint64 h, quint64 len)
+{
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= PrimeMx2;
+    h ^= (h >> 35) + len;
+    h *= PrimeMx2;
+    h ^= h >> 28;
+    return h;
+}
+
+inline quint64 mix16(const unsigned char *input, const unsigned char *secret)
+{
+    return mul128fold64(read64(input) ^ read64(secret), read64(input + 8) ^ read64(secret + 8));
+}
+
+// Mixes two 16 byte lanes into the two halves of a 128 bit accumulator
+inline void mix32(quint64 *low, quint64 *high, const unsigned char *input1, const unsigned char *input2,
+                  const unsigned char *secret)
+{
+    *low += mix16(input1, secret);
+    *low ^= read64(input2) + read64(input2 + 8);
+    *high += mix16(input2, secret + 16);
+    *high ^= read64(input1) + read64(input1 + 8);
+}
+
+/***************************************************************************************************
+* Short inputs, up to MidSizeMax bytes, hashed in one go without the accumulators.
+***************************************************************************************************/
+
+quint64 hash64Short(const unsigned char *input, qint64 len)
+{
+    const quint64 length = static_cast<quint64>(len);
+
+    if (len == 0) {
+        return xxh64Avalanche(read64(Secret + 56) ^ read64(Secret + 64));
+    }
+    if (len < 4) {
+        quint32 combined = (quint32(input[0]) << 16) | (quint32(input[len >> 1]) << 24)
+                         | quint32(input[len - 1]) | (quint32(len) << 8);
+        return xxh64Avalanche(combined ^ quint64(read32(Secret) ^ read32(Secret + 4)));
+    }
+    if (len <= 8) {
+        quint64 keyed = (quint64(read32(input + len - 4)) + (quint64(read32(input)) << 32))
+                      ^ (read64(Secret + 8) ^ read64(Secret + 16));
+        return rrmxmx(keyed, length);
+    }
+    if (len <= 16) {
+        quint64 low = read64(input) ^ (read64(Secret + 24) ^ read64(Secret + 32));
+        quint64 high = read64(input + len - 8) ^ (read64(Secret + 40) ^ read64(Secret + 48));
+        return avalanche(length + swap64(low) + high + mul128fold64(low, high));
+    }
+
+    quint64 acc = length * Prime64_1;
+    if (len <= 128) {
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc += mix16(input + 48, Secret + 96);
+                    acc += mix16(input + len - 64, Secret + 112);
+                }
+                acc += mix16(input + 32, Secret + 64);
+                acc += mix16(input + len - 48, Secret + 80);
+            }
+            acc += mix16(input + 16, Secret + 32);
+            acc += mix16(input + len - 32, Secret + 48);
+        }
+        acc += mix16(input, Secret);
+        acc += mix16(input + len - 16, Secret + 16);
+        return avalanche(acc);
+    }
+
+    const int rounds = static_cast<int>(len / 16);
+    for (int i = 0; i < 8; ++i) {
+        acc += mix16(input + 16 * i, Secret + 16 * i);
+    }
+    acc = avalanche(acc);
+    for (int i = 8; i < rounds; ++i) {
+        acc += mix16(input + 16 * i, Secret + 16 * (i - 8) + MidSizeStartOffset);
+    }
+    acc += mix16(input + len - 16, Secret + SecretSizeMin - MidSizeLastOffset);
+    return avalanche(acc);
+}
+
+xxh3Engine::value128 hash128Short(const unsigned char *input, qint64 len)
+{
+    const quint64 length = static_cast<quint64>(len);
+    xxh3Engine::value128 h;
+
+    if (len == 0) {
+        h.low = xxh64Avalanche(read64(Secret + 64) ^ read64(Secret + 72));
+        h.high = xxh64Avalanche(read64(Secret + 80) ^ read64(Secret + 88));
+        return h;
+    }
+    if (len < 4) {
+        quint32 combinedLow = (quint32(input[0]) << 16) | (quint32(input[len >> 1]) << 24)
+                            | quint32(input[len - 1]) | (quint32(len) << 8);
+        quint32 combinedHigh = rotl32(swap32(combinedLow), 13);
+        h.low = xxh64Avalanche(combinedLow ^ quint64(read32(Secret) ^ read32(Secret + 4)));
+        h.high = xxh64Avalanche(combinedHigh ^ quint64(read32(Secret + 8) ^ read32(Secret + 12)));
+        return h;
+    }
+    if (len <= 8) {
+        quint64 keyed = (quint64(read32(input)) + (quint64(read32(input + len - 4)) << 32))
+                      ^ (read64(Secret + 16) ^ read64(Secret + 24));
+        xxh3Engine::value128 m = mult64to128(keyed, Prime64_1 + (length << 2));
+        m.high += m.low << 1;
+        m.low ^= m.high >> 3;
+        m.low ^= m.low >> 35;
+        m.low *= PrimeMx2;
+        m.low ^= m.low >> 28;
+        m.high = avalanche(m.high);
+        return m;
+    }
+    if (len <= 16) {
+        quint64 low = read64(input);
+        quint64 high = read64(input + len - 8);
+        xxh3Engine::value128 m = mult64to128(low ^ high ^ (read64(Secret + 32) ^ read64(Secret + 40)), Prime64_1);
+        m.low += (length - 1) << 54;
+        high ^= read64(Secret + 48) ^ read64(Secret + 56);
+        m.high += high + mult32to64(high, Prime32_2 - 1);
+        m.low ^= swap64(m.high);
+        h = mult64to128(m.low, Prime64_2);
+        h.high += m.high * Prime64_2;
+        h.low = avalanche(h.low);
+        h.high = avalanche(h.high);
+        return h;
+    }
+
+    quint64 low = length * Prime64_1;
+    quint64 high = 0;
+    if (len <= 128) {
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    mix32(&low, &high, input + 48, input + len - 64, Secret + 96);
+                }
+                mix32(&low, &high, input + 32, input + len - 48, Secret + 64);
+            }
+            mix32(&low, &high, input + 16, input + len - 32, Secret + 32);
+        }
+        mix32(&low, &high, input, input + len - 16, Secret);
+    } else {
+        const int rounds = static_cast<int>(len / 32);
+        for (int i = 0; i < 4; ++i) {
+            mix32(&low, &high, input + 32 * i, input + 32 * i + 16, Secret + 32 * i);
+        }
+        low = avalanche(low);
+        high = avalanche(high);
+        for (int i = 4; i < rounds; ++i) {
+            mix32(&low, &high, input + 32 * i, input + 32 * i + 16, Secret + MidSizeStartOffset + 32 * (i - 4));
+        }
+        mix32(&low, &high, input + len - 16, input + len - 32, Secret + SecretSizeMin - MidSizeLastOffset - 16);
+    }
+
+    h.low = avalanche(low + high);
+    h.high = 0 - avalanche(low * Prime64_1 + high * Prime64_4 + length * Prime64_2);
+    return h;
+}
+
+/***************************************************************************************************
+* Long inputs: eight 64 bit accumulators fed one 64 byte stripe at a time, scrambled after every
+* StripesPerBlock stripes.
+***************************************************************************************************/
+
+#ifdef XXH3_HAVE_SSE2
+inline void accumulate512(quint64 *acc, const unsigned char *input, const unsigned char *secret)
+{
+    __m128i *xacc = reinterpret_cast<__m128i *>(acc);
+    for (int i = 0; i < 4; ++i) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input) + i);
+        __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i);
+        __m128i dataKey = _mm_xor_si128(data, key);
+        __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i product = _mm_mul_epu32(dataKey, dataKeyHigh);
+        __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], swapped));
+    }
+}
+
+inline void scramble(quint64 *acc, const unsigned char *secret)
+{
+    __m128i *xacc = reinterpret_cast<__m128i *>(acc);
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(Prime32_1));
+    for (int i = 0; i < 4; ++i) {
+        __m128i value = _mm_xor_si128(xacc[i], _mm_srli_epi64(xacc[i], 47));
+        __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i);
+        __m128i dataKey = _mm_xor_si128(value, key);
+        __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i productLow = _mm_mul_epu32(dataKey, prime);
+        __m128i productHigh = _mm_mul_epu32(dataKeyHigh, prime);
+        xacc[i] = _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32));
+    }
+}
+#else
+inline void accumulate512(quint64 *acc, const unsigned char *input, const unsigned char *secret)
+{
+    for (int i = 0; i < 8; ++i) {
+        quint64 data = read64(input + 8 * i);
+        quint64 dataKey = data ^ read64(secret + 8 * i);
+        acc[i ^ 1] += data;
+        acc[i] += mult32to64(dataKey, dataKey >> 32);
+    }
+}
+
+inline void scramble(quint64 *acc, const unsigned char *secret)
+{
+    for (int i = 0; i < 8; ++i) {
+        quint64 value = acc[i] ^ (acc[i] >> 47);
+        value ^= read64(secret + 8 * i);
+        acc[i] = value * Prime32_1;
+    }
+}
+#endif
+
+// Accumulates count stripes, scrambling whenever a block of StripesPerBlock is complete.
+// Returns the number of stripes accumulated since the last scramble.
+int consumeStripes(quint64 *acc, int stripesSoFar, qint64 count, const unsigned char *input)
+{
+    while (count > 0) {
+        int take = StripesPerBlock - stripesSoFar;
+        if (take > count) take = static_cast<int>(count);
+        for (int i = 0; i < take; ++i) {
+            accumulate512(acc, input + i * StripeLength, Secret + (stripesSoFar + i) * SecretConsumeRate);
+        }
+        input += take * StripeLength;
+        count -= take;
+        stripesSoFar += take;
+        if (stripesSoFar == StripesPerBlock) {
+            scramble(acc, Secret + SecretSize - StripeLength);
+            stripesSoFar = 0;
+        }
+    }
+    return stripesSoFar;
+}
+
+inline quint64 mergeAccs(const quint64 *acc, const unsigned char *secret, quint64 start)
+{
+    quint64 result = start;
+    for (int i = 0; i < 4; ++i) {
+        result += mul128fold64(acc[2 * i] ^ read64(secret + 16 * i), acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+    }
+    return avalanche(result);
+}
+
+} // namespace
+
+/***************************************************************************************************
+* @description : Constructor for an empty input.
+* @param : None
+* @return : None
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+xxh3Engine::hashState::hashState()
+{
+    reset();
+}
+
+/***************************************************************************************************
+* @description : This function starts over with an empty input.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void xxh3Engine::hashState::reset()
+{
+    std::memcpy(acc, InitialAcc, sizeof(acc));
+    bufferedSize = 0;
+    stripesSoFar = 0;
+    totalLength = 0;
+}
+
+/***************************************************************************************************
+* @description : This function feeds the next block of the input. Up to BufferSize bytes are kept
+*                back so the last stripe is known when the digest is taken; everything before it
+*                is accumulated straight from the caller's memory.
+* @param : const unsigned char *data, qint64 len
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void xxh3Engine::hashState::update(const unsigned char *data, qint64 len)
+{
+    if (len <= 0) return;
+    totalLength += static_cast<quint64>(len);
+
+    if (bufferedSize + len <= BufferSize) {
+        std::memcpy(buffer + bufferedSize, data, static_cast<size_t>(len));
+        bufferedSize += static_cast<int>(len);
+        return;
+    }
+
+    const int stripesPerBuffer = BufferSize / StripeLength;
+
+    if (bufferedSize > 0) {
+        const int fill = BufferSize - bufferedSize;
+        std::memcpy(buffer + bufferedSize, data, static_cast<size_t>(fill));
+        data += fill;
+        len -= fill;
+        stripesSoFar = consumeStripes(acc, stripesSoFar, stripesPerBuffer, buffer);
+        bufferedSize = 0;
+    }
+
+    if (len > BufferSize) {
+        // Whole buffers straight from the input, keeping 1 to BufferSize bytes back
+        const qint64 stripes = (len - 1) / StripeLength;
+        const qint64 whole = (stripes / stripesPerBuffer) * stripesPerBuffer;
+        stripesSoFar = consumeStripes(acc, stripesSoFar, whole, data);
+        data += whole * StripeLength;
+        len -= whole * StripeLength;
+        // The digest of a short tail needs the stripe before it
+        std::memcpy(buffer + BufferSize - StripeLength, data - StripeLength, StripeLength);
+    }
+
+    std::memcpy(buffer, data, static_cast<size_t>(len));
+    bufferedSize = static_cast<int>(len);
+}
+
+/***************************************************************************************************
+* @description : This function accumulates the buffered tail on a copy of the accumulators. The
+*                last stripe always ends with the input; if fewer than StripeLength bytes are
+*                buffered it is completed with the end of the previous buffer.
+* @param : quint64 *finalAcc
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void xxh3Engine::hashState::finishLong(quint64 *finalAcc) const
+{
+    std::memcpy(finalAcc, acc, sizeof(acc));
+
+    if (bufferedSize >= StripeLength) {
+        const int stripes = (bufferedSize - 1) / StripeLength;
+        consumeStripes(finalAcc, stripesSoFar, stripes, buffer);
+        accumulate512(finalAcc, buffer + bufferedSize - StripeLength,
+                      Secret + SecretSize - StripeLength - SecretLastAccStart);
+    } else {
+        unsigned char lastStripe[StripeLength];
+        const int catchUp = StripeLength - bufferedSize;
+        std::memcpy(lastStripe, buffer + BufferSize - catchUp, static_cast<size_t>(catchUp));
+        std::memcpy(lastStripe + catchUp, buffer, static_cast<size_t>(bufferedSize));
+        accumulate512(finalAcc, lastStripe, Secret + SecretSize - StripeLength - SecretLastAccStart);
+    }
+}
+
+/***************************************************************************************************
+* @description : This function returns XXH3-64 of everything fed so far.
+* @param : None
+* @return : quint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint64 xxh3Engine::hashState::digest64() const
+{
+    if (totalLength <= MidSizeMax) return hash64Short(buffer, bufferedSize);
+
+    alignas(16) quint64 finalAcc[8];
+    finishLong(finalAcc);
+    return mergeAccs(finalAcc, Secret + SecretMergeAccsStart, totalLength * Prime64_1);
+}
+
+/***************************************************************************************************
+* @description : This function returns XXH3-128 of everything fed so far.
+* @param : None
+* @return : value128
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+xxh3Engine::value128 xxh3Engine::hashState::digest128() const
+{
+    if (totalLength <= MidSizeMax) return hash128Short(buffer, bufferedSize);
+
+    alignas(16) quint64 finalAcc[8];
+    finishLong(finalAcc);
+    value128 h;
+    h.low = mergeAccs(finalAcc, Secret + SecretMergeAccsStart, totalLength * Prime64_1);
+    h.high = mergeAccs(finalAcc, Secret + SecretSize - sizeof(finalAcc) - SecretMergeAccsStart,
+                       ~(totalLength * Prime64_2));
+    return h;
+}
+
+/***************************************************************************************************
+* @description : This function hashes one buffer with XXH3-64.
+* @param : const unsigned char *data, qint64 len
+* @return : quint64
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+quint64 xxh3Engine::hash64(const unsigned char *data, qint64 len)
+{
+    hashState state;
+    state.update(data, len);
+    return state.digest64();
+}
+
+/***************************************************************************************************
+* @description : This function hashes one buffer with XXH3-128.
+* @param : const unsigned char *data, qint64 len
+* @return : value128
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+xxh3Engine::value128 xxh3Engine::hash128(const unsigned char *data, qint64 len)
+{
+    hashState state;
+    state.update(data, len);
+    return state.digest128();
+}
+
+/***************************************************************************************************
+* @description : This function tells whether the accumulator loop was compiled for SSE2.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool xxh3Engine::usesSse2()
+{
+#ifdef XXH3_HAVE_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+/***************************************************************************************************
+* @description : This function checks both widths against values from the reference
+*                implementation, once in one block and once split into odd sized blocks that
+*                cross the internal buffer in every possible way.
+* @param : None
+* @return : bool
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+bool xxh3Engine::selfTest()
+{
+    struct vector
+    {
+        qint64 length;
+        quint64 hash64;
+        quint64 low;
+        quint64 high;
+    };
+    static const vector Vectors[] = {
+        {     0, Q_UINT64_C(0x2D06800538D394C2), Q_UINT64_C(0x6001C324468D497F), Q_UINT64_C(0x99AA06D3014798D8) },
+        {     1, Q_UINT64_C(0x4A4139CAF4136257), Q_UINT64_C(0x4A4139CAF4136257), Q_UINT64_C(0x885F487031A56968) },
+        {     3, Q_UINT64_C(0x681EDB50810DD20A), Q_UINT64_C(0x681EDB50810DD20A), Q_UINT64_C(0x35FAE7F25188EAE5) },
+        {     4, Q_UINT64_C(0x55AA74B3D8B19EC9), Q_UINT64_C(0xB8BA9F06A96F264E), Q_UINT64_C(0xDEE519DA602C0A81) },
+        {     8, Q_UINT64_C(0xFE184B52355C3924), Q_UINT64_C(0xFE9E7B70FF002C16), Q_UINT64_C(0xBED386AFCFCCF4D5) },
+        {     9, Q_UINT64_C(0xE9A9AFAB043E737E), Q_UINT64_C(0x98A832D08BF226BA), Q_UINT64_C(0xE772C3C0C93FB18F) },
+        {    16, Q_UINT64_C(0x49E7332447592DF8), Q_UINT64_C(0x5D5EC11A74962298), Q_UINT64_C(0x94C8684F6728A988) },
+        {    17, Q_UINT64_C(0x9B7A5F6110288400), Q_UINT64_C(0xAADADC2816C4B054), Q_UINT64_C(0xC14DDFD839E59BCC) },
+        {   128, Q_UINT64_C(0x0F8CF90FDF9A0928), Q_UINT64_C(0x161FDF3F962DEC0C), Q_UINT64_C(0x9538E372F428282D) },
+        {   129, Q_UINT64_C(0xF1C3F85EC4684B07), Q_UINT64_C(0xB3610A5BFD6349AF), Q_UINT64_C(0x9C5D63B6649BEDD9) },
+        {   240, Q_UINT64_C(0xFAB12CD0D52699DC), Q_UINT64_C(0xBFCD96490DAF006C), Q_UINT64_C(0xD686228A4A600967) },
+        {   241, Q_UINT64_C(0x090CEF510357131A), Q_UINT64_C(0x090CEF510357131A), Q_UINT64_C(0xE5F0CD10B3E7AD58) },
+        {  1024, Q_UINT64_C(0xF994AE3067EC693A), Q_UINT64_C(0xF994AE3067EC693A), Q_UINT64_C(0x0A1711E17C35B81E) },
+        {  1025, Q_UINT64_C(0x2E99BDDA3E5FCE7A), Q_UINT64_C(0x2E99BDDA3E5FCE7A), Q_UINT64_C(0xE1BBABBF8FC9F5BA) },
+        {  4173, Q_UINT64_C(0xF31F9A27B883402B), Q_UINT64_C(0xF31F9A27B883402B), Q_UINT64_C(0xCDD089F323A6F271) },
+        { 12345, Q_UINT64_C(0x0FC1FCB7A62E746E), Q_UINT64_C(0x0FC1FCB7A62E746E), Q_UINT64_C(0xCAC67F5AA77A79E1) }
+    };
+    static const qint64 BlockSizes[] = { 1, 63, 64, 65, 255, 256, 257, 1000 };
+
+    QByteArray buffer(12345, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < buffer.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = static_cast<char>(seed >> 24);
+    }
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(buffer.constData());
+
+    for (const vector &v : Vectors) {
+        value128 wide = hash128(data, v.length);
+        if (hash64(data, v.length) != v.hash64 || wide.low != v.low || wide.high != v.high) return false;
+
+        for (qint64 blockSize : BlockSizes) {
+            hashState state;
+            for (qint64 done = 0; done < v.length; done += blockSize) {
+                state.update(data + done, qMin(blockSize, v.length - done));
+            }
+            wide = state.digest128();
+            if (state.digest64() != v.hash64 || wide.low != v.low || wide.high != v.high) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,480 @@
+#include "checksumHasher.h"
+#include "blake3Engine.h"
+#include "crc16Engine.h"
+#include "crc32Engine.h"
+#include "crc32cEngine.h"
+#include "crc64Engine.h"
+#include "xxh3Engine.h"
+
+#include <QtTest>
+
+#include <cstring>
+
+namespace {
+
+// Expected digest of a message, upper case hex
+struct knownAnswer
+{
+    checksumEngine::ChecksumType type;
+    // Length of the pattern message, -1 for the "123456789" check string
+    qint64 length;
+    const char *digest;
+};
+
+// Computed with zlib, hashlib, the xxhash and blake3 Python packages and reference bitwise CRCs.
+// Lengths sit on both sides of the block sizes of the kernels: XXH3 switches at 16, 128 and
+// 240 bytes, BLAKE3 hashes 64 byte blocks in 1024 byte chunks, the CRC kernels fold 8 to 64
+// bytes at a time, and 1048577 bytes cross checksumEngine::ChunkSize.
+const knownAnswer KnownAnswers[] = {
+    { checksumEngine::CRC16, 0, "0000" },
+    { checksumEngine::CRC16, 1, "0000" },
+    { checksumEngine::CRC16, 3, "060C" },
+    { checksumEngine::CRC16, 16, "7F43" },
+    { checksumEngine::CRC16, 17, "4262" },
+    { checksumEngine::CRC16, 64, "41DD" },
+    { checksumEngine::CRC16, 128, "AC18" },
+    { checksumEngine::CRC16, 129, "98EB" },
+    { checksumEngine::CRC16, 240, "0446" },
+    { checksumEngine::CRC16, 241, "C43B" },
+    { checksumEngine::CRC16, 1023, "833F" },
+    { checksumEngine::CRC16, 1024, "3C60" },
+    { checksumEngine::CRC16, 1025, "60F0" },
+    { checksumEngine::CRC16, 2049, "B5BA" },
+    { checksumEngine::CRC16, 65543, "2D0B" },
+    { checksumEngine::CRC16, 1048577, "D12B" },
+    { checksumEngine::CRC16, -1, "FEE8" },
+    { checksumEngine::CRC32, 0, "00000000" },
+    { checksumEngine::CRC32, 1, "D202EF8D" },
+    { checksumEngine::CRC32, 3, "0854897F" },
+    { checksumEngine::CRC32, 16, "CECEE288" },
+    { checksumEngine::CRC32, 17, "2C183A19" },
+    { checksumEngine::CRC32, 64, "100ECE8C" },
+    { checksumEngine::CRC32, 128, "24650D57" },
+    { checksumEngine::CRC32, 129, "CA91CDF7" },
+    { checksumEngine::CRC32, 240, "A60B0B66" },
+    { checksumEngine::CRC32, 241, "CBC8D2F7" },
+    { checksumEngine::CRC32, 1023, "5A9E0EFF" },
+    { checksumEngine::CRC32, 1024, "7BE4DFD0" },
+    { checksumEngine::CRC32, 1025, "4E700DFB" },
+    { checksumEngine::CRC32, 2049, "DDDF2214" },
+    { checksumEngine::CRC32, 65543, "12414DF1" },
+    { checksumEngine::CRC32, 1048577, "3E8E13CB" },
+    { checksumEngine::CRC32, -1, "CBF43926" },
+    { checksumEngine::CRC32C, 0, "00000000" },
+    { checksumEngine::CRC32C, 1, "527D5351" },
+    { checksumEngine::CRC32C, 3, "92FD4BFA" },
+    { checksumEngine::CRC32C, 16, "D9C908EB" },
+    { checksumEngine::CRC32C, 17, "38435E17" },
+    { checksumEngine::CRC32C, 64, "FB6D36EB" },
+    { checksumEngine::CRC32C, 128, "30D9C515" },
+    { checksumEngine::CRC32C, 129, "F514629F" },
+    { checksumEngine::CRC32C, 240, "9F4F71D6" },
+    { checksumEngine::CRC32C, 241, "54FE7516" },
+    { checksumEngine::CRC32C, 1023, "39A4911A" },
+    { checksumEngine::CRC32C, 1024, "2AF62C0C" },
+    { checksumEngine::CRC32C, 1025, "C8D03ADD" },
+    { checksumEngine::CRC32C, 2049, "0BE89406" },
+    { checksumEngine::CRC32C, 65543, "D7A426F4" },
+    { checksumEngine::CRC32C, 1048577, "760B5254" },
+    { checksumEngine::CRC32C, -1, "E3069283" },
+    { checksumEngine::CRC64, 0, "0000000000000000" },
+    { checksumEngine::CRC64, 1, "1FADA17364673F59" },
+    { checksumEngine::CRC64, 3, "4A94100384498A10" },
+    { checksumEngine::CRC64, 16, "7A64E421B6985356" },
+    { checksumEngine::CRC64, 17, "F4351B8EF9DDDEC3" },
+    { checksumEngine::CRC64, 64, "D098E69B0B93F24B" },
+    { checksumEngine::CRC64, 128, "04CAB3FBFB0D759C" },
+    { checksumEngine::CRC64, 129, "EE438E75CE3EB630" },
+    { checksumEngine::CRC64, 240, "8C887E47209C279F" },
+    { checksumEngine::CRC64, 241, "4B7B7ED3C194F52C" },
+    { checksumEngine::CRC64, 1023, "84B74967E2D3C30C" },
+    { checksumEngine::CRC64, 1024, "A9698966F9C097B2" },
+    { checksumEngine::CRC64, 1025, "A20B28CC20B0C276" },
+    { checksumEngine::CRC64, 2049, "AC79A8A813E40347" },
+    { checksumEngine::CRC64, 65543, "AE07B26C12314325" },
+    { checksumEngine::CRC64, 1048577, "A0CB47EC92409880" },
+    { checksumEngine::CRC64, -1, "995DC9BBDF1939FA" },
+    { checksumEngine::MD5, 0, "D41D8CD98F00B204E9800998ECF8427E" },
+    { checksumEngine::MD5, 1, "93B885ADFE0DA089CDF634904FD59F71" },
+    { checksumEngine::MD5, 3, "B95F67F61EBB03619622D798F45FC2D3" },
+    { checksumEngine::MD5, 16, "1AC1EF01E96CAF1BE0D329331A4FC2A8" },
+    { checksumEngine::MD5, 17, "1BDD36B0A024C90DB383512607293692" },
+    { checksumEngine::MD5, 64, "B2D3F56BC197FD985D5965079B5E7148" },
+    { checksumEngine::MD5, 128, "37EFF01866BA3F538421B30B7CBEFCAC" },
+    { checksumEngine::MD5, 129, "46F986692847558FC38B0CECE591C20F" },
+    { checksumEngine::MD5, 240, "DDABC96224D832FDE27D53C83270C3F1" },
+    { checksumEngine::MD5, 241, "267A256D457A3856BBFCE6554C1566DF" },
+    { checksumEngine::MD5, 1023, "7437D7A881387DB7C41CF6930AB5E35D" },
+    { checksumEngine::MD5, 1024, "9EE0A0E0C0BC0F1FF29D663D1FDF0743" },
+    { checksumEngine::MD5, 1025, "3F3789452B88CB32B8CBFBAFE715E29A" },
+    { checksumEngine::MD5, 2049, "CB7FABAC9AC9FD2CB4E79A6D12C8308E" },
+    { checksumEngine::MD5, 65543, "64AFCF0F198D89A1F079CB57F937C84F" },
+    { checksumEngine::MD5, 1048577, "79B67C7FBF43B76E5B7F182328BDC4B6" },
+    { checksumEngine::MD5, -1, "25F9E794323B453885F5181F1B624D0B" },
+    { checksumEngine::SHA1, 0, "DA39A3EE5E6B4B0D3255BFEF95601890AFD80709" },
+    { checksumEngine::SHA1, 1, "5BA93C9DB0CFF93F52B521D7420E43F6EDA2784F" },
+    { checksumEngine::SHA1, 3, "0C7A623FD2BBC05B06423BE359E4021D36E721AD" },
+    { checksumEngine::SHA1, 16, "56178B86A57FAC22899A9964185C2CC96E7DA589" },
+    { checksumEngine::SHA1, 17, "0A0315EC7B1E22A79FC862EDF79BDA2FC01669E3" },
+    { checksumEngine::SHA1, 64, "C6138D514FFA2135BFCE0ED0B8FAC65669917EC7" },
+    { checksumEngine::SHA1, 128, "E6434BC401F98603D7EDA504790C98C67385D535" },
+    { checksumEngine::SHA1, 129, "3352E41CC30B40AE80108970492B21014049E625" },
+    { checksumEngine::SHA1, 240, "F7B8E5E76E6B4CB3DFA7AF7070D5560400822B65" },
+    { checksumEngine::SHA1, 241, "54717F94E8F3DED40B4CC1A470EACB25CB10136F" },
+    { checksumEngine::SHA1, 1023, "1D58257E7E9CECEE00473911023732E408E9BEE3" },
+    { checksumEngine::SHA1, 1024, "0AC28084FF74933D05123496DAFD3791684D9B53" },
+    { checksumEngine::SHA1, 1025, "CA9FDC040579AFC74C0E6314FEE7AF12BD5C4284" },
+    { checksumEngine::SHA1, 2049, "08F4013D7A63D68A95DB3D9AC6D6E29E932F2808" },
+    { checksumEngine::SHA1, 65543, "9F2ABE9D3BECEB03B2431F80608789BBB6B55EEB" },
+    { checksumEngine::SHA1, 1048577, "FFBC30B06F6BD51DA52F9640804C9D0C4F6E2AF2" },
+    { checksumEngine::SHA1, -1, "F7C3BC1D808E04732ADF679965CCC34CA7AE3441" },
+    { checksumEngine::SHA256, 0, "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855" },
+    { checksumEngine::SHA256, 1, "6E340B9CFFB37A989CA544E6BB780A2C78901D3FB33738768511A30617AFA01D" },
+    { checksumEngine::SHA256, 3, "AE4B3280E56E2FAF83F414A6E3DABE9D5FBE18976544C05FED121ACCB85B53FC" },
+    { checksumEngine::SHA256, 16, "BE45CB2605BF36BEBDE684841A28F0FD43C69850A3DCE5FEDBA69928EE3A8991" },
+    { checksumEngine::SHA256, 17, "3E5718FEA51A8F3F5BACA61C77AFAB473C1810F8B9DB330273B4011CE92C787E" },
+    { checksumEngine::SHA256, 64, "FDEAB9ACF3710362BD2658CDC9A29E8F9C757FCF9811603A8C447CD1D9151108" },
+    { checksumEngine::SHA256, 128, "471FB943AA23C511F6F72F8D1652D9C880CFA392AD80503120547703E56A2BE5" },
+    { checksumEngine::SHA256, 129, "5099C6A56203F9687F7D33F4BFDF576D31DC91F6B695ECEA38B2770C87631135" },
+    { checksumEngine::SHA256, 240, "ABF4BAFCDDB38BBF3855E47B5E61B75DEDBCF42AA44FFD4BB85D0B08D97E2682" },
+    { checksumEngine::SHA256, 241, "211882AEAC8A599B0A55EC280E1A978923EDEF69CD86541BCBD58DB864C45EAC" },
+    { checksumEngine::SHA256, 1023, "1C5E88A585B61754DF6137D66632A7348557A88358AFC401B0A0A4FC427104A9" },
+    { checksumEngine::SHA256, 1024, "2BCE1BA628720664BE4B9FDD77AAE0678E5F0F3F02FC6FF641EC879094F6A404" },
+    { checksumEngine::SHA256, 1025, "BC0B6B10B89B9487A12FDA2A8CC13194E7091C217AABF8B92846274026F4BCD0" },
+    { checksumEngine::SHA256, 2049, "26E1E2808E3A6CF967CA03F6749A063C5ED55F92F5874653A1FAABED78346F00" },
+    { checksumEngine::SHA256, 65543, "48E84525BCB5C9DCD67FA7A692ED20F31909BA8F0DD24C3ADA9BD54B057468B0" },
+    { checksumEngine::SHA256, 1048577, "5769F52BC3EEF28AFA39C6FC68CADB7D0BD69812AE3A3D71452F519EC3C7AA56" },
+    { checksumEngine::SHA256, -1, "15E2B0D3C33891EBB0F1EF609EC419420C20E320CE94C65FBC8C3312448EB225" },
+    { checksumEngine::XXH3_64, 0, "2D06800538D394C2" },
+    { checksumEngine::XXH3_64, 1, "C44BDFF4074EECDB" },
+    { checksumEngine::XXH3_64, 3, "5F4299FC161C9CBB" },
+    { checksumEngine::XXH3_64, 16, "8355E3A6F61770DB" },
+    { checksumEngine::XXH3_64, 17, "9EF341A99DE37328" },
+    { checksumEngine::XXH3_64, 64, "6187EB9089B0ED55" },
+    { checksumEngine::XXH3_64, 128, "85C6174C7FF4C46B" },
+    { checksumEngine::XXH3_64, 129, "EC7642B431BA3E5A" },
+    { checksumEngine::XXH3_64, 240, "375A384D957FE865" },
+    { checksumEngine::XXH3_64, 241, "02E8CD95421C6D02" },
+    { checksumEngine::XXH3_64, 1023, "D3D91D80AC495685" },
+    { checksumEngine::XXH3_64, 1024, "E5D78BAFA45B2AA5" },
+    { checksumEngine::XXH3_64, 1025, "E95C42288F28186E" },
+    { checksumEngine::XXH3_64, 2049, "6C9600C0E506E2AE" },
+    { checksumEngine::XXH3_64, 65543, "13C7031387CD92E2" },
+    { checksumEngine::XXH3_64, 1048577, "47A84C196FD973DF" },
+    { checksumEngine::XXH3_64, -1, "72DCB18B67A17DFF" },
+    { checksumEngine::XXH3_128, 0, "99AA06D3014798D86001C324468D497F" },
+    { checksumEngine::XXH3_128, 1, "A6CD5E9392000F6AC44BDFF4074EECDB" },
+    { checksumEngine::XXH3_128, 3, "E3B55F57945A17CF5F4299FC161C9CBB" },
+    { checksumEngine::XXH3_128, 16, "72950631827607E2842812CC870DCAE2" },
+    { checksumEngine::XXH3_128, 17, "685BC458B37D057FC06E233DF7729217" },
+    { checksumEngine::XXH3_128, 64, "9C6E140A465545E590C1971DDB04CE74" },
+    { checksumEngine::XXH3_128, 128, "14792FC3AF88DC6C05321A0B64D67B41" },
+    { checksumEngine::XXH3_128, 129, "DD5E74AC6B45F54EBC30B63382B09A3B" },
+    { checksumEngine::XXH3_128, 240, "65B5BE86DA5540E7C92B68E16F83BBB6" },
+    { checksumEngine::XXH3_128, 241, "1DA1CB61BCB8A2A102E8CD95421C6D02" },
+    { checksumEngine::XXH3_128, 1023, "4325711B0ED4D742D3D91D80AC495685" },
+    { checksumEngine::XXH3_128, 1024, "D0AC1F7B93BF57B9E5D78BAFA45B2AA5" },
+    { checksumEngine::XXH3_128, 1025, "2882EBCA04EC915CE95C42288F28186E" },
+    { checksumEngine::XXH3_128, 2049, "39A54BC93F74921B6C9600C0E506E2AE" },
+    { checksumEngine::XXH3_128, 65543, "F2ED7AED3DD9420913C7031387CD92E2" },
+    { checksumEngine::XXH3_128, 1048577, "3DB0E7620B0D635947A84C196FD973DF" },
+    { checksumEngine::XXH3_128, -1, "33119477EDE5DCD5E9716427681D5860" },
+    { checksumEngine::BLAKE3, 0, "AF1349B9F5F9A1A6A0404DEA36DCC9499BCB25C9ADC112B7CC9A93CAE41F3262" },
+    { checksumEngine::BLAKE3, 1, "2D3ADEDFF11B61F14C886E35AFA036736DCD87A74D27B5C1510225D0F592E213" },
+    { checksumEngine::BLAKE3, 3, "E1BE4D7A8AB5560AA4199EEA339849BA8E293D55CA0A81006726D184519E647F" },
+    { checksumEngine::BLAKE3, 16, "A6A492965517A830CB75FDB713465AA465F2F098233896FEA44C1D98268BF9E3" },
+    { checksumEngine::BLAKE3, 17, "8462AA7BE93B09FDA7B93CF9F9CDDB703F6DD2CC0C8EDD5F9EEE092EDF8ABF0C" },
+    { checksumEngine::BLAKE3, 64, "4EED7141EA4A5CD4B788606BD23F46E212AF9CACEBACDC7D1F4C6DC7F2511B98" },
+    { checksumEngine::BLAKE3, 128, "F17E570564B26578C33BB7F44643F539624B05DF1A76C81F30ACD548C44B45EF" },
+    { checksumEngine::BLAKE3, 129, "683AAAE9F3C5BA37EAAF072AED0F9E30BAC0865137BAE68B1FDE4CA2AEBDCB12" },
+    { checksumEngine::BLAKE3, 240, "45E1A0DC23DBE51733D7269A3C0F519C2A63B0718835B2B537677EBA734DB0D8" },
+    { checksumEngine::BLAKE3, 241, "749B36AE651C22E8567DB692A6876E0CA4FD3DAEB7AA8FA3AB2F642CCC69A8F6" },
+    { checksumEngine::BLAKE3, 1023, "10108970EEDA3EB932BAAC1428C7A2163B0E924C9A9E25B35BBA72B28F70BD11" },
+    { checksumEngine::BLAKE3, 1024, "42214739F095A406F3FC83DEB889744AC00DF831C10DAA55189B5D121C855AF7" },
+    { checksumEngine::BLAKE3, 1025, "D00278AE47EB27B34FAECF67B4FE263F82D5412916C1FFD97C8CB7FB814B8444" },
+    { checksumEngine::BLAKE3, 2049, "5F4D72F40D7A5F82B15CA2B2E44B1DE3C2EF86C426C95C1AF0B6879522563030" },
+    { checksumEngine::BLAKE3, 65543, "34E9A3DAA12BC6C9E31A96E162FFEA0C436609F80CAD7169020B48854659B7A0" },
+    { checksumEngine::BLAKE3, 1048577, "2F053CD7472CF0CD2F9ADAF45C1180255B91B9A865404A63671A0EE5F792ED33" },
+    { checksumEngine::BLAKE3, -1, "B7D65B48420D1033CB2595293263B6F72EABEE20D55E699D0DF1973B3C9DEED1" },
+};
+
+// Byte i of a pattern message, the pattern of the official BLAKE3 test vectors
+QByteArray patternMessage(qint64 length)
+{
+    QByteArray message(static_cast<int>(length), Qt::Uninitialized);
+    for (int i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<char>(i % 251);
+    }
+    return message;
+}
+
+QByteArray messageOf(const knownAnswer &answer)
+{
+    return answer.length < 0 ? QByteArray("123456789") : patternMessage(answer.length);
+}
+
+} // namespace
+
+// Known answer tests of checksumHasher and the kernels behind it
+class checksumHasherTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void kernelSelfTests();
+    void knownAnswers_data();
+    void knownAnswers();
+    void alignment_data();
+    void alignment();
+    void chunkBoundaries_data();
+    void chunkBoundaries();
+    void digestSize_data();
+    void digestSize();
+    void initStartsOver();
+    void finalKeepsState();
+    void spanViews();
+};
+
+/***************************************************************************************************
+* @description : This function runs the built in checks of every kernel against its bytewise
+*                reference, which covers the kernels the CPU does not pick by default.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::kernelSelfTests()
+{
+    QVERIFY(crc16Engine::selfTest());
+    QVERIFY(crc32Engine::selfTest());
+    QVERIFY(crc32cEngine::selfTest());
+    QVERIFY(crc64Engine::selfTest());
+    QVERIFY(xxh3Engine::selfTest());
+    QVERIFY(blake3Engine::selfTest());
+}
+
+/***************************************************************************************************
+* @description : This function lists every known answer, one row per algorithm and message.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::knownAnswers_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<QString>("digest");
+
+    for (const knownAnswer &answer : KnownAnswers) {
+        const QString name = checksumEngine::typeName(answer.type) + ' '
+                           + (answer.length < 0 ? QString("check") : QString::number(answer.length));
+        QTest::newRow(qPrintable(name)) << int(answer.type) << messageOf(answer) << QString(answer.digest);
+    }
+}
+
+/***************************************************************************************************
+* @description : This function hashes every known answer message with a single update().
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::knownAnswers()
+{
+    QFETCH(int, type);
+    QFETCH(QByteArray, message);
+    QFETCH(QString, digest);
+
+    checksumHasher hasher(static_cast<checksumEngine::ChecksumType>(type));
+    hasher.update(message);
+    QCOMPARE(hasher.finalHex(), digest);
+    QCOMPARE(checksumHasher::hash(hasher.type(), message), QByteArray::fromHex(digest.toLatin1()));
+}
+
+/***************************************************************************************************
+* @description : This function uses the known answer rows.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::alignment_data()
+{
+    knownAnswers_data();
+}
+
+/***************************************************************************************************
+* @description : This function hashes every known answer message from each of the 16 alignments
+*                of a buffer, the vector kernels load unaligned heads and tails separately.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::alignment()
+{
+    QFETCH(int, type);
+    QFETCH(QByteArray, message);
+    QFETCH(QString, digest);
+
+    QByteArray buffer(message.size() + 16 + 64, Qt::Uninitialized);
+    // Start from a 64 byte aligned address so every offset below is the alignment it names
+    const quintptr base = reinterpret_cast<quintptr>(buffer.data());
+    char *aligned = buffer.data() + ((64 - base % 64) % 64);
+
+    for (int offset = 0; offset < 16; ++offset) {
+        memcpy(aligned + offset, message.constData(), static_cast<size_t>(message.size()));
+
+        checksumHasher hasher(static_cast<checksumEngine::ChecksumType>(type));
+        hasher.update(byteSpan(aligned + offset, message.size()));
+        QVERIFY2(hasher.finalHex() == digest, qPrintable(QString("offset %1").arg(offset)));
+    }
+}
+
+/***************************************************************************************************
+* @description : This function lists every algorithm with every piece size.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::chunkBoundaries_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("piece");
+
+    // Around the block sizes of the kernels, plus a sequence that never lines up with them
+    const QList<int> pieces = QList<int>() << 1 << 3 << 15 << 16 << 17 << 63 << 64 << 65 << 239 << 240
+                                           << 1023 << 1024 << 1025 << 4096 << 65537 << -1;
+    for (checksumEngine::ChecksumType type : checksumEngine::allChecksumTypes()) {
+        for (int piece : pieces) {
+            const QString name = checksumEngine::typeName(type) + ' '
+                               + (piece < 0 ? QString("mixed") : QString::number(piece));
+            QTest::newRow(qPrintable(name)) << int(type) << piece;
+        }
+    }
+}
+
+/***************************************************************************************************
+* @description : This function feeds a 65543 byte known answer message in pieces of one size, or
+*                of changing sizes, and expects the digest of the whole message.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::chunkBoundaries()
+{
+    QFETCH(int, type);
+    QFETCH(int, piece);
+
+    const qint64 Length = 65543;
+    QString digest;
+    for (const knownAnswer &answer : KnownAnswers) {
+        if (answer.type == type && answer.length == Length) digest = answer.digest;
+    }
+    QVERIFY(!digest.isEmpty());
+
+    const QByteArray message = patternMessage(Length);
+    const byteSpan whole(message);
+    checksumHasher hasher(static_cast<checksumEngine::ChecksumType>(type));
+
+    static const int MixedPieces[] = { 1, 7, 64, 1000, 3, 1024, 129, 0, 4097, 31 };
+    int next = 0;
+    for (qint64 offset = 0; offset < whole.size(); ) {
+        const int size = piece > 0 ? piece : MixedPieces[next++ % (sizeof(MixedPieces) / sizeof(int))];
+        const byteSpan part = whole.mid(offset, size);
+        hasher.update(part);
+        offset += part.size();
+    }
+    QCOMPARE(hasher.finalHex(), digest);
+}
+
+/***************************************************************************************************
+* @description : This function lists every algorithm.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::digestSize_data()
+{
+    QTest::addColumn<int>("type");
+    for (checksumEngine::ChecksumType type : checksumEngine::allChecksumTypes()) {
+        QTest::newRow(qPrintable(checksumEngine::typeName(type))) << int(type);
+    }
+}
+
+/***************************************************************************************************
+* @description : This function checks that final() returns digestSize() bytes, the hex form twice
+*                as many digits.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::digestSize()
+{
+    QFETCH(int, type);
+
+    checksumHasher hasher(static_cast<checksumEngine::ChecksumType>(type));
+    hasher.update(QByteArray("abc"));
+    QCOMPARE(hasher.final().size(), checksumHasher::digestSize(hasher.type()));
+    QCOMPARE(hasher.finalHex().size(), checksumEngine::digestLength(hasher.type()));
+}
+
+/***************************************************************************************************
+* @description : This function checks that init() discards everything fed before.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::initStartsOver()
+{
+    const QByteArray check("123456789");
+    for (checksumEngine::ChecksumType type : checksumEngine::allChecksumTypes()) {
+        checksumHasher hasher(type);
+        hasher.update(patternMessage(5000));
+        hasher.init();
+        hasher.update(check);
+        QCOMPARE(hasher.final(), checksumHasher::hash(type, check));
+    }
+}
+
+/***************************************************************************************************
+* @description : This function checks that final() leaves the message open, so a running digest
+*                can be taken and the message continued.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::finalKeepsState()
+{
+    const QByteArray message = patternMessage(3000);
+    for (checksumEngine::ChecksumType type : checksumEngine::allChecksumTypes()) {
+        checksumHasher hasher(type);
+        hasher.update(byteSpan(message).mid(0, 1000));
+        QCOMPARE(hasher.final(), checksumHasher::hash(type, byteSpan(message).mid(0, 1000)));
+        QCOMPARE(hasher.final(), hasher.final());
+        hasher.update(byteSpan(message).mid(1000));
+        QCOMPARE(hasher.final(), checksumHasher::hash(type, message));
+    }
+}
+
+/***************************************************************************************************
+* @description : This function checks that spans view the caller's bytes without copying and
+*                that mid() clamps to the span.
+* @param : None
+* @return : void
+* @Author : Ritesh Pandit
+***************************************************************************************************/
+void checksumHasherTest::spanViews()
+{
+    const QByteArray bytes("0123456789");
+    const byteSpan span(bytes);
+    QCOMPARE(static_cast<const void *>(span.data()), static_cast<const void *>(bytes.constData()));
+    QCOMPARE(span.size(), qint64(10));
+
+    QCOMPARE(span.mid(3, 4).size(), qint64(4));
+    QCOMPARE(span.mid(3, 4).data(), span.data() + 3);
+    QCOMPARE(span.mid(8).size(), qint64(2));
+    QCOMPARE(span.mid(8, 100).size(), qint64(2));
+    QVERIFY(span.mid(20).isEmpty());
+    QVERIFY(byteSpan().isEmpty());
+}
+
+QTEST_APPLESS_MAIN(checksumHasherTest)
+
+#include "checksumHasherTest.moc"
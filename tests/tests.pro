@@ -0,0 +1,18 @@
+# Known answer and streaming tests of the checksum kernels, linked against the ChecksumCore
+# library. Built by the root project, "make check" there runs them.
+
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++14 console testcase
+CONFIG -= app_bundle
+
+TARGET = ChecksumTests
+DESTDIR = $$PWD/../bin/
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    checksumHasherTest.cpp
+
+include(../library/linkChecksumCore.pri)